@@ -92,6 +92,18 @@ namespace Hazel
             return new Entity(entityID);
         }
 
+        // Resolve the tag once and keep the handle around to skip string marshalling on every lookup
+        public static TagHandle GetTagHandle(string tag)
+        {
+            return new TagHandle(GetTagHandle_Native(tag));
+        }
+
+        public Entity FindEntityByTag(TagHandle tag)
+        {
+            ulong entityID = FindEntityByTagHandle_Native(tag.Hash);
+            return new Entity(entityID);
+        }
+
         public Entity FindEntityByID(ulong entityID)
         {
             // TODO: Verify the entity id
@@ -168,5 +180,9 @@ namespace Hazel
         private static extern bool HasComponent_Native(ulong entityID, Type type);
         [MethodImpl(MethodImplOptions.InternalCall)]
         private static extern ulong FindEntityByTag_Native(string tag);
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        private static extern ulong GetTagHandle_Native(string tag);
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        private static extern ulong FindEntityByTagHandle_Native(ulong tagHandle);
     }
 }
@@ -22,7 +22,7 @@ namespace Hazel
             }
             set
             {
-                SetTag_Native(value);
+                SetTag_Native(Entity.ID, value);
             }
         }
 
@@ -30,7 +30,7 @@ namespace Hazel
         public static extern string GetTag_Native(ulong entityID);
 
         [MethodImpl(MethodImplOptions.InternalCall)]
-        public static extern void SetTag_Native(string tag);
+        public static extern void SetTag_Native(ulong entityID, string tag);
 
     }
 
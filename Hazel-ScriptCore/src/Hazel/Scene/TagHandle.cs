@@ -0,0 +1,18 @@
+namespace Hazel
+{
+    // Pre-hashed entity tag, obtained from Entity.GetTagHandle
+    public struct TagHandle
+    {
+        internal ulong Hash;
+
+        internal TagHandle(ulong hash)
+        {
+            Hash = hash;
+        }
+
+        public bool IsValid
+        {
+            get { return Hash != 0; }
+        }
+    }
+}
@@ -23,6 +23,13 @@ namespace Hazel {
 
 	using AssetHandle = UUID;
 
+	// Bytes an asset's data occupies, used by the AssetManager's memory budget
+	struct AssetMemoryUsage
+	{
+		uint64_t CPUBytes = 0;
+		uint64_t GPUBytes = 0;
+	};
+
 	class Asset : public RefCounted
 	{
 	public:
@@ -44,6 +51,10 @@ namespace Hazel {
 		{
 			return !(*this == other);
 		}
+
+		// Zero for assets that don't own any significant data
+		virtual AssetMemoryUsage GetMemoryUsage() const { return {}; }
+
 		virtual ~Asset() {}
 	};
 
@@ -66,6 +77,7 @@ namespace Hazel {
 	{
 	public:
 		std::vector<AssetHandle> ChildDirectories;
+		std::vector<AssetHandle> ChildAssets; // Every child that isn't a directory
 
 		Directory() = default;
 	};
@@ -1,23 +1,131 @@
 #include "hzpch.h"
 #include "AssetManager.h"
 
+#include "Hazel/Asset/DerivedDataCache.h"
 #include "Hazel/Renderer/Mesh.h"
 #include "Hazel/Renderer/SceneRenderer.h"
+#include "Hazel/Renderer/Renderer.h"
+#include "Hazel/Renderer/RendererAPI.h"
+#include "Hazel/Core/JobSystem.h"
+#include "Hazel/Core/Timer.h"
+#include "Hazel/Utilities/VirtualFileSystem.h"
 
 #include "yaml-cpp/yaml.h"
 
+#include <chrono>
+#include <cstring>
 #include <filesystem>
+#include <limits>
+#include <mutex>
 
 namespace Hazel {
 
+	static const char* s_AssetRegistryPath = "assets/cache/AssetRegistry.hzr";
+	static const char* s_LegacyAssetRegistryPath = "assets/cache/AssetRegistryCache.hzr";
+	static const char* s_AssetRegistryExportPath = "assets/cache/AssetRegistry.yaml";
+
+	// The binary registry is a header followed by a journal of records that are replayed in order on load.
+	// Changes are appended to it, it is only rewritten as a snapshot once stale records make up most of the file.
+	// Record layout: uint8 record type, int8 asset type, uint64 handle, uint16 path length, path (not null terminated)
+	static constexpr char s_RegistryMagic[4] = { 'H', 'Z', 'A', 'R' };
+	static constexpr uint32_t s_RegistryVersion = 1;
+	static constexpr size_t s_RegistryHeaderSize = sizeof(s_RegistryMagic) + sizeof(uint32_t);
+	static constexpr size_t s_RegistryRecordHeaderSize = 12;
+
+	enum class RegistryRecordType : uint8_t
+	{
+		Set = 0, Remove
+	};
+
+	struct RegistryJournal
+	{
+		std::vector<uint8_t> PendingRecords;
+		uint64_t RecordCount = 0; // In the file, including pending ones
+		bool NeedsSnapshot = false;
+		bool ChangedSinceExport = false;
+		bool ReadOnly = false; // Loaded from a pak archive, changes are kept in memory only
+	};
+	static RegistryJournal s_RegistryJournal;
+
+	static void WriteRegistryRecord(std::vector<uint8_t>& buffer, RegistryRecordType recordType, const AssetManager::AssetMetadata& metadata)
+	{
+		HZ_CORE_ASSERT(metadata.FilePath.size() <= std::numeric_limits<uint16_t>::max());
+
+		uint64_t handle = metadata.Handle;
+		uint16_t pathLength = (uint16_t)metadata.FilePath.size();
+
+		size_t offset = buffer.size();
+		buffer.resize(offset + s_RegistryRecordHeaderSize + pathLength);
+		uint8_t* record = buffer.data() + offset;
+		record[0] = (uint8_t)recordType;
+		record[1] = (uint8_t)metadata.Type;
+		memcpy(record + 2, &handle, sizeof(handle));
+		memcpy(record + 10, &pathLength, sizeof(pathLength));
+		memcpy(record + s_RegistryRecordHeaderSize, metadata.FilePath.data(), pathLength);
+	}
+
+	static std::string NormalizePath(const std::string& filepath)
+	{
+		std::string result = filepath;
+		std::replace(result.begin(), result.end(), '\\', '/');
+		while (result.size() > 1 && result.back() == '/')
+			result.pop_back();
+		return result;
+	}
+
+	static std::string GetParentPath(const std::string& normalizedPath)
+	{
+		size_t lastSlash = normalizedPath.find_last_of('/');
+		return lastSlash == std::string::npos ? std::string() : normalizedPath.substr(0, lastSlash);
+	}
+
+	// Saving a file usually produces a burst of change events, a file is only reimported once it has been quiet for this long
+	static constexpr std::chrono::milliseconds s_ReloadCoalesceWindow(250);
+
+	// Filled from the file watcher thread, drained by Update
+	struct PendingReloads
+	{
+		std::mutex Mutex;
+		std::vector<FileSystemChangedEvent> Events; // Applied in order on the main thread, see ProcessFileSystemEvents
+		std::unordered_map<std::string, std::chrono::steady_clock::time_point> LastModified; // By normalized path
+	};
+	static PendingReloads s_PendingReloads;
+
+	// Assets used this recently are never evicted, the frames in flight on the render thread may still be drawing them
+	static constexpr uint64_t s_EvictionGraceFrames = 60;
+
+	// Same asset without its data, GetAsset (or the importer, for reloads) replaces it with a loaded instance
+	static Ref<Asset> CreateUnloadedCopy(const Ref<Asset>& asset)
+	{
+		Ref<Asset> copy = Ref<Asset>::Create();
+		copy->Handle = asset->Handle;
+		copy->Type = asset->Type;
+		copy->FilePath = asset->FilePath;
+		copy->FileName = asset->FileName;
+		copy->Extension = asset->Extension;
+		copy->ParentDirectory = asset->ParentDirectory;
+		return copy;
+	}
+
 	void AssetManager::Init()
 	{
+		Timer timer;
 		AssetImporter::Init();
 
 		LoadAssetRegistry();
 		FileSystem::SetChangeCallback(AssetManager::OnFileSystemChanged);
 		ReloadAssets();
+		// Only what startup changed is appended, unless the registry has to be rewritten anyway
 		UpdateRegistryCache();
+		if (!s_RegistryJournal.ReadOnly && !FileSystem::Exists(s_AssetRegistryExportPath))
+			s_RegistryJournal.ChangedSinceExport = true;
+
+		s_MaxConcurrentLoads = std::max(JobSystem::GetWorkerCount() / 2, 1u);
+
+		SetPlaceholderAsset(AssetType::Texture, Renderer::GetWhiteTexture());
+		SetPlaceholderAsset(AssetType::EnvMap, Ref<Environment>::Create(Renderer::GetBlackCubeTexture(), Renderer::GetBlackCubeTexture()));
+
+		HZ_CORE_INFO("AssetManager initialized with {0} assets in {1}ms", s_LoadedAssets.size(), timer.ElapsedMillis());
 	}
 
 	void AssetManager::SetAssetChangeCallback(const AssetsChangeEventFn& callback)
@@ -27,95 +135,734 @@ namespace Hazel {
 
 	void AssetManager::Shutdown()
 	{
+		// Let in-flight loads finish so their GPU uploads are submitted and cleaned up with everything else
+		for (auto& request : s_InFlightLoads)
+			JobSystem::WaitUntil([&request]() { return request->State.load(std::memory_order_acquire) == AssetLoadState::Decoded; });
+
+		while (!s_InFlightLoads.empty())
+			CompleteAsyncLoad(s_InFlightLoads.back());
+
+		for (auto& [handle, request] : s_ReloadRequests)
+		{
+			Ref<AssetLoadRequest> reload = request;
+			JobSystem::WaitUntil([&reload]() { return reload->State.load(std::memory_order_acquire) == AssetLoadState::Decoded; });
+			Renderer::SubmitCommandQueue(reload->Commands);
+		}
+		s_ReloadRequests.clear();
+		s_AssetReloadCallbacks.clear();
+
+		s_AssetResidency.clear();
+		s_MemoryStats.clear();
+		s_EvictedAssets.clear();
+		s_ResidentMemory = {};
+
+		{
+			std::lock_guard<std::mutex> lock(s_PendingReloads.Mutex);
+			s_PendingReloads.Events.clear();
+			s_PendingReloads.LastModified.clear();
+		}
+
+		for (auto& queue : s_LoadQueues)
+			queue.clear();
+		s_LoadRequests.clear();
+		s_PlaceholderAssets.clear();
+
+		UpdateRegistryCache();
+		if (s_RegistryJournal.ChangedSinceExport && !s_RegistryJournal.ReadOnly)
+			ExportRegistry(s_AssetRegistryExportPath);
+
+		s_RegistryJournal = RegistryJournal();
 		s_AssetRegistry.clear();
+		s_AssetPathIndex.clear();
+		s_AssetDependents.clear();
+		s_AssetDependencies.clear();
 		s_LoadedAssets.clear();
 	}
 
-	std::vector<Ref<Asset>> AssetManager::GetAssetsInDirectory(AssetHandle directoryHandle)
+	void AssetManager::AddAssetReloadCallback(const AssetReloadedFn& callback)
 	{
-		std::vector<Ref<Asset>> results;
+		s_AssetReloadCallbacks.push_back(callback);
+	}
+
+	void AssetManager::Update()
+	{
+		s_FrameIndex++;
+
+		ProcessFileSystemEvents();
+		ProcessPendingReloads();
+		ProcessLoadQueues();
+		EvictUnusedAssets();
+	}
 
-		for (auto& asset : s_LoadedAssets)
+	void AssetManager::ProcessLoadQueues()
+	{
+		for (size_t i = 0; i < s_InFlightLoads.size(); )
 		{
-			if (asset.second && asset.second->ParentDirectory == directoryHandle && asset.second->Handle != directoryHandle)
-				results.push_back(asset.second);
+			if (s_InFlightLoads[i]->State.load(std::memory_order_acquire) == AssetLoadState::Decoded)
+				CompleteAsyncLoad(s_InFlightLoads[i]);
+			else
+				i++;
 		}
 
-		return results;
+		// Highest priority first; entries whose request was re-prioritized or already started are stale
+		for (auto& queue : s_LoadQueues)
+		{
+			while (!queue.empty() && s_InFlightLoads.size() < s_MaxConcurrentLoads)
+			{
+				Ref<AssetLoadRequest> request = queue.front();
+				queue.pop_front();
+
+				if (request->State.load(std::memory_order_relaxed) != AssetLoadState::Queued || &queue != &s_LoadQueues[(size_t)request->Priority])
+					continue;
+
+				// Removed while it was waiting
+				if (!IsAssetHandleValid(request->Handle))
+				{
+					request->State = AssetLoadState::Failed;
+					s_LoadRequests.erase(request->Handle);
+					continue;
+				}
+
+				StartAsyncLoad(request);
+			}
+		}
 	}
 
-	// Utility function to find the parent of an unprocessed directory
-	AssetHandle AssetManager::FindParentHandleInChildren(Ref<Directory>& dir, const std::string& dirName)
+	bool AssetManager::PreloadAssets(const std::vector<AssetHandle>& assetHandles, const PreloadProgressFn& progressCallback)
 	{
-		if (dir->FileName == dirName)
-			return dir->Handle;
+		std::vector<Ref<AssetLoadRequest>> requests;
+		requests.reserve(assetHandles.size());
 
-		for (AssetHandle childHandle : dir->ChildDirectories)
+		std::unordered_set<AssetHandle> requested;
+		for (AssetHandle handle : assetHandles)
 		{
-			Ref<Directory> child = GetAsset<Directory>(childHandle);
-			AssetHandle dirHandle = FindParentHandleInChildren(child, dirName);
+			if (!IsAssetHandleValid(handle) || !requested.insert(handle).second)
+				continue;
 
-			if (IsAssetHandleValid(dirHandle))
-				return dirHandle;
+			requests.push_back(RequestAsyncLoad(handle, AssetLoadPriority::Visible));
 		}
 
-		return 0;
+		// Nothing else runs while the caller is blocked on this, so the concurrency limit for background loads doesn't apply
+		uint32_t maxConcurrentLoads = s_MaxConcurrentLoads;
+		s_MaxConcurrentLoads = std::max(JobSystem::GetWorkerCount(), 1u);
+
+		uint32_t total = (uint32_t)requests.size();
+		uint32_t reported = UINT32_MAX;
+		while (true)
+		{
+			ProcessLoadQueues();
+
+			uint32_t loaded = (uint32_t)std::count_if(requests.begin(), requests.end(), [](const Ref<AssetLoadRequest>& request) { return request->IsDone(); });
+			if (progressCallback && loaded != reported)
+				progressCallback(loaded, total);
+			reported = loaded;
+
+			if (loaded == total)
+				break;
+
+			// Decodes are Low priority jobs, so this only helps with other work until one of the loads can be published
+			JobSystem::WaitUntil([]()
+			{
+				if (s_InFlightLoads.empty())
+					return true;
+
+				for (auto& request : s_InFlightLoads)
+				{
+					if (request->State.load(std::memory_order_acquire) == AssetLoadState::Decoded)
+						return true;
+				}
+				return false;
+			});
+		}
+
+		s_MaxConcurrentLoads = maxConcurrentLoads;
+
+		return std::none_of(requests.begin(), requests.end(), [](const Ref<AssetLoadRequest>& request)
+		{
+			return request->State.load(std::memory_order_acquire) == AssetLoadState::Failed;
+		});
 	}
 
-	AssetHandle AssetManager::FindParentHandle(const std::string& filepath)
+	static bool MustDecodeOnMainThread(AssetType type)
 	{
-		std::vector<std::string> parts = Utils::SplitString(filepath, "/\\");
-		std::string parentFolder = parts[parts.size() - 2];
-		Ref<Directory>& assetsDirectory = GetAsset<Directory>(GetAssetHandleFromFilePath("assets"));
-		return FindParentHandleInChildren(assetsDirectory, parentFolder);
+		// Environment maps are generated with compute passes that rely on renderer state
+		if (type == AssetType::EnvMap)
+			return true;
+
+		// The OpenGL texture and material constructors create samplers and register shader reload callbacks
+		// directly, which needs the main thread's context
+		if (RendererAPI::Current() == RendererAPIType::OpenGL)
+			return type == AssetType::Texture || type == AssetType::Mesh;
+
+		return false;
 	}
 
-	void AssetManager::OnFileSystemChanged(FileSystemChangedEvent e)
+	// Metadata can change on the main thread (renames, moves) while the data is decoded
+	static void RefreshMetadata(Ref<Asset>& asset, const Ref<Asset>& current)
+	{
+		asset->FilePath = current->FilePath;
+		asset->FileName = current->FileName;
+		asset->Extension = current->Extension;
+		asset->ParentDirectory = current->ParentDirectory;
+	}
+
+	static void LoadAssetData(Ref<AssetLoadRequest> request, Ref<Asset> asset)
 	{
-		e.NewName = Utils::RemoveExtension(e.NewName);
-		e.OldName = Utils::RemoveExtension(e.OldName);
+		// GPU uploads are recorded into the request instead of the frame's queue, which isn't safe to touch from here
+		RenderCommandQueue* previousQueue = Renderer::GetThreadCommandQueue();
+		Renderer::SetThreadCommandQueue(&request->Commands);
+		request->Success = AssetImporter::TryLoadData(asset);
+		Renderer::SetThreadCommandQueue(previousQueue);
+
+		request->Result = asset;
+		request->State.store(AssetLoadState::Decoded, std::memory_order_release);
+	}
 
-		AssetHandle parentHandle = FindParentHandle(e.FilePath);
+	Ref<AssetLoadRequest> AssetManager::RequestAsyncLoad(AssetHandle assetHandle, AssetLoadPriority priority)
+	{
+		HZ_CORE_ASSERT(IsAssetHandleValid(assetHandle));
 
-		if (e.Action == FileSystemAction::Added)
+		auto it = s_LoadRequests.find(assetHandle);
+		if (it != s_LoadRequests.end())
 		{
-			if (e.IsDirectory)
-				ProcessDirectory(e.FilePath, parentHandle);
-			else
-				ImportAsset(e.FilePath, parentHandle);
+			Ref<AssetLoadRequest> request = it->second;
+			if (priority < request->Priority && request->State.load(std::memory_order_relaxed) == AssetLoadState::Queued)
+			{
+				request->Priority = priority;
+				s_LoadQueues[(size_t)priority].push_back(request);
+			}
+			return request;
+		}
+
+		Ref<AssetLoadRequest> request = Ref<AssetLoadRequest>::Create();
+		request->Handle = assetHandle;
+		request->Priority = priority;
+
+		const Ref<Asset>& asset = s_LoadedAssets[assetHandle];
+		if (asset->IsDataLoaded || asset->Type == AssetType::Directory)
+		{
+			request->Result = asset;
+			request->Success = true;
+			request->State = AssetLoadState::Loaded;
+			return request;
+		}
+
+		s_LoadRequests[assetHandle] = request;
+		s_LoadQueues[(size_t)priority].push_back(request);
+		return request;
+	}
+
+	void AssetManager::StartAsyncLoad(Ref<AssetLoadRequest> request)
+	{
+		request->State = AssetLoadState::Loading;
+		s_InFlightLoads.push_back(request);
+
+		// The worker only ever sees this copy, the registry's asset keeps changing on the main thread
+		Ref<Asset> asset = CreateUnloadedCopy(s_LoadedAssets[request->Handle]);
+		if (MustDecodeOnMainThread(asset->Type))
+		{
+			LoadAssetData(request, asset);
+			return;
+		}
+
+		JobSystem::Submit([request, asset]()
+		{
+			LoadAssetData(request, asset);
+		}, nullptr, JobPriority::Low);
+	}
+
+	void AssetManager::CompleteAsyncLoad(Ref<AssetLoadRequest> request)
+	{
+		Renderer::SubmitCommandQueue(request->Commands);
+
+		// The asset may have been removed while it was loading
+		if (IsAssetHandleValid(request->Handle))
+		{
+			RefreshMetadata(request->Result, s_LoadedAssets[request->Handle]);
+			s_LoadedAssets[request->Handle] = request->Result;
+			RegisterDependencies(request->Result);
+			TrackResidency(request->Result);
+		}
+
+		request->Result = nullptr;
+		request->State.store(request->Success ? AssetLoadState::Loaded : AssetLoadState::Failed, std::memory_order_release);
+
+		s_InFlightLoads.erase(std::remove(s_InFlightLoads.begin(), s_InFlightLoads.end(), request), s_InFlightLoads.end());
+		s_LoadRequests.erase(request->Handle);
+	}
+
+	bool AssetManager::FinishAsyncLoad(AssetHandle assetHandle)
+	{
+		auto it = s_LoadRequests.find(assetHandle);
+		if (it == s_LoadRequests.end())
+			return false;
+
+		Ref<AssetLoadRequest> request = it->second;
+		if (request->State.load(std::memory_order_relaxed) == AssetLoadState::Queued)
+		{
+			// Not started yet, cheaper to decode it right here than to wait for a worker
+			request->State = AssetLoadState::Loading;
+			s_InFlightLoads.push_back(request);
+			LoadAssetData(request, s_LoadedAssets[assetHandle]);
+		}
+		else
+		{
+			JobSystem::WaitUntil([&request]() { return request->State.load(std::memory_order_acquire) == AssetLoadState::Decoded; });
 		}
 
-		// TODO: Re import data if loaded
-		/*if (e.Action == FileSystemAction::Modified)
+		CompleteAsyncLoad(request);
+		return true;
+	}
+
+	void AssetManager::ProcessPendingReloads()
+	{
+		std::vector<Ref<AssetLoadRequest>> decoded;
+		for (auto& [handle, request] : s_ReloadRequests)
 		{
-			if (!e.IsDirectory)
-				ImportAsset(e.FilePath, parentHandle);
-		}*/
+			if (request->State.load(std::memory_order_acquire) == AssetLoadState::Decoded)
+				decoded.push_back(request);
+		}
 
-		if (e.Action == FileSystemAction::Rename)
+		for (auto& request : decoded)
+			CompleteReload(request);
+
+		std::vector<std::string> modifiedFiles;
 		{
-			for (auto it = s_LoadedAssets.begin(); it != s_LoadedAssets.end(); it++)
+			std::lock_guard<std::mutex> lock(s_PendingReloads.Mutex);
+			auto now = std::chrono::steady_clock::now();
+			for (auto it = s_PendingReloads.LastModified.begin(); it != s_PendingReloads.LastModified.end(); )
 			{
-				if (it->second->FileName == e.OldName)
+				if (now - it->second < s_ReloadCoalesceWindow)
 				{
-					it->second->FilePath = e.FilePath;
-					it->second->FileName = e.NewName;
+					it++;
+					continue;
 				}
+
+				modifiedFiles.push_back(it->first);
+				it = s_PendingReloads.LastModified.erase(it);
 			}
 		}
 
-		if (e.Action == FileSystemAction::Delete)
+		for (const std::string& filepath : modifiedFiles)
 		{
-			for (auto it = s_LoadedAssets.begin(); it != s_LoadedAssets.end(); it++)
+			AssetHandle handle = GetAssetHandleFromFilePath(filepath);
+			if (IsAssetHandleValid(handle))
+				ReloadAsset(handle);
+
+			// Assets built from this file, e.g. meshes using a texture
+			auto dependents = s_AssetDependents.find(filepath);
+			if (dependents != s_AssetDependents.end())
 			{
-				if (it->second->FilePath != e.FilePath)
-					continue;
+				for (AssetHandle dependent : dependents->second)
+				{
+					if (IsAssetHandleValid(dependent))
+						ReloadAsset(dependent);
+				}
+			}
+		}
+	}
+
+	void AssetManager::ReloadAsset(AssetHandle assetHandle)
+	{
+		const Ref<Asset>& asset = s_LoadedAssets[assetHandle];
+
+		// Unloaded assets pick up the new data whenever they are first used
+		if (!asset->IsDataLoaded || asset->Type == AssetType::Directory)
+			return;
+
+		// Decoding the old data already, try again once that is done
+		if (s_ReloadRequests.find(assetHandle) != s_ReloadRequests.end())
+		{
+			std::lock_guard<std::mutex> lock(s_PendingReloads.Mutex);
+			s_PendingReloads.LastModified[asset->FilePath] = std::chrono::steady_clock::now();
+			return;
+		}
+
+		HZ_CORE_INFO("Reloading asset: {0}", asset->FilePath);
+
+		Ref<Asset> reloaded = CreateUnloadedCopy(asset);
+
+		Ref<AssetLoadRequest> request = Ref<AssetLoadRequest>::Create();
+		request->Handle = assetHandle;
+		request->State = AssetLoadState::Loading;
+		s_ReloadRequests[assetHandle] = request;
+
+		if (MustDecodeOnMainThread(asset->Type))
+		{
+			LoadAssetData(request, reloaded);
+			return;
+		}
+
+		JobSystem::Submit([request, reloaded]()
+		{
+			LoadAssetData(request, reloaded);
+		}, nullptr, JobPriority::Low);
+	}
+
+	void AssetManager::CompleteReload(Ref<AssetLoadRequest> request)
+	{
+		Renderer::SubmitCommandQueue(request->Commands);
+		s_ReloadRequests.erase(request->Handle);
+
+		Ref<Asset> asset = request->Result;
+		request->Result = nullptr;
+		request->State.store(request->Success ? AssetLoadState::Loaded : AssetLoadState::Failed, std::memory_order_release);
+
+		if (!IsAssetHandleValid(request->Handle))
+			return;
+
+		// Keep the old data rather than swapping in a broken asset, e.g. when a file was caught halfway through being written
+		if (!request->Success)
+		{
+			HZ_CORE_ERROR("Failed to reload asset: {0}", asset->FilePath);
+			return;
+		}
+
+		RefreshMetadata(asset, s_LoadedAssets[request->Handle]);
+		s_LoadedAssets[request->Handle] = asset;
+		RegisterDependencies(asset);
+		TrackResidency(asset);
+
+		for (auto& callback : s_AssetReloadCallbacks)
+			callback(asset);
+	}
+
+	void AssetManager::RegisterDependencies(const Ref<Asset>& asset)
+	{
+		UnregisterDependencies(asset->Handle);
+
+		std::vector<std::string> dependencies;
+		if (asset->Type == AssetType::Mesh && asset->IsDataLoaded)
+		{
+			for (const std::string& texturePath : asset.As<Mesh>()->GetTextureFilePaths())
+				dependencies.push_back(NormalizePath(std::filesystem::path(texturePath).lexically_normal().string()));
+			for (const std::string& sourcePath : asset.As<Mesh>()->GetSourceFilePaths())
+				dependencies.push_back(NormalizePath(sourcePath));
+		}
+
+		if (dependencies.empty())
+			return;
+
+		for (const std::string& dependency : dependencies)
+			s_AssetDependents[dependency].push_back(asset->Handle);
+
+		s_AssetDependencies[asset->Handle] = std::move(dependencies);
+	}
 
-				RemoveAsset(it->first);
+	void AssetManager::UnregisterDependencies(AssetHandle assetHandle)
+	{
+		auto it = s_AssetDependencies.find(assetHandle);
+		if (it == s_AssetDependencies.end())
+			return;
+
+		for (const std::string& dependency : it->second)
+		{
+			auto dependents = s_AssetDependents.find(dependency);
+			if (dependents == s_AssetDependents.end())
+				continue;
+
+			auto& handles = dependents->second;
+			handles.erase(std::remove(handles.begin(), handles.end(), assetHandle), handles.end());
+			if (handles.empty())
+				s_AssetDependents.erase(dependents);
+		}
+
+		s_AssetDependencies.erase(it);
+	}
+
+	void AssetManager::SetMemoryBudget(uint64_t cpuBytes, uint64_t gpuBytes)
+	{
+		s_CPUMemoryBudget = cpuBytes;
+		s_GPUMemoryBudget = gpuBytes;
+	}
+
+	void AssetManager::TouchAsset(const Ref<Asset>& asset)
+	{
+		if (!asset->IsDataLoaded)
+			return;
+
+		auto it = s_AssetResidency.find(asset->Handle);
+		if (it == s_AssetResidency.end())
+			TrackResidency(asset);
+		else
+			it->second.LastUsedFrame = s_FrameIndex;
+	}
+
+	void AssetManager::TrackResidency(const Ref<Asset>& asset)
+	{
+		UntrackResidency(asset->Handle);
+		if (!asset->IsDataLoaded || asset->Type == AssetType::Directory)
+			return;
+
+		AssetResidency& residency = s_AssetResidency[asset->Handle];
+		residency.Usage = asset->GetMemoryUsage();
+		residency.LastUsedFrame = s_FrameIndex;
+
+		AssetTypeMemoryStats& stats = s_MemoryStats[asset->Type];
+		stats.ResidentCount++;
+		stats.CPUBytes += residency.Usage.CPUBytes;
+		stats.GPUBytes += residency.Usage.GPUBytes;
+		s_ResidentMemory.CPUBytes += residency.Usage.CPUBytes;
+		s_ResidentMemory.GPUBytes += residency.Usage.GPUBytes;
+
+		if (s_EvictedAssets.erase(asset->Handle))
+			stats.Reloads++;
+	}
+
+	void AssetManager::UntrackResidency(AssetHandle assetHandle)
+	{
+		auto it = s_AssetResidency.find(assetHandle);
+		if (it == s_AssetResidency.end())
+			return;
+
+		const AssetMemoryUsage& usage = it->second.Usage;
+		AssetTypeMemoryStats& stats = s_MemoryStats[s_LoadedAssets[assetHandle]->Type];
+		stats.ResidentCount--;
+		stats.CPUBytes -= usage.CPUBytes;
+		stats.GPUBytes -= usage.GPUBytes;
+		s_ResidentMemory.CPUBytes -= usage.CPUBytes;
+		s_ResidentMemory.GPUBytes -= usage.GPUBytes;
+
+		s_AssetResidency.erase(it);
+	}
+
+	void AssetManager::EvictUnusedAssets()
+	{
+		auto overCPUBudget = []() { return s_CPUMemoryBudget > 0 && s_ResidentMemory.CPUBytes > s_CPUMemoryBudget; };
+		auto overGPUBudget = []() { return s_GPUMemoryBudget > 0 && s_ResidentMemory.GPUBytes > s_GPUMemoryBudget; };
+		if (!overCPUBudget() && !overGPUBudget())
+			return;
+
+		std::vector<std::pair<uint64_t, AssetHandle>> candidates; // Last used frame, handle
+		for (auto& [handle, residency] : s_AssetResidency)
+		{
+			if (s_FrameIndex - residency.LastUsedFrame < s_EvictionGraceFrames)
+				continue;
+
+			// Held outside the manager (e.g. by a scene), unloading it here wouldn't free anything
+			if (s_LoadedAssets[handle]->GetRefCount() > 1 || s_ReloadRequests.find(handle) != s_ReloadRequests.end())
+				continue;
+
+			candidates.emplace_back(residency.LastUsedFrame, handle);
+		}
+
+		std::sort(candidates.begin(), candidates.end());
+
+		for (auto& [lastUsedFrame, handle] : candidates)
+		{
+			bool overCPU = overCPUBudget(), overGPU = overGPUBudget();
+			if (!overCPU && !overGPU)
 				break;
+
+			// Only evict what helps with the budget that is exceeded
+			const AssetMemoryUsage& usage = s_AssetResidency[handle].Usage;
+			if ((overCPU && usage.CPUBytes > 0) || (overGPU && usage.GPUBytes > 0))
+				EvictAsset(handle);
+		}
+	}
+
+	void AssetManager::EvictAsset(AssetHandle assetHandle)
+	{
+		HZ_CORE_TRACE("Evicting asset: {0}", s_LoadedAssets[assetHandle]->FilePath);
+
+		AssetType type = s_LoadedAssets[assetHandle]->Type;
+		UntrackResidency(assetHandle);
+		UnregisterDependencies(assetHandle);
+		s_LoadedAssets[assetHandle] = CreateUnloadedCopy(s_LoadedAssets[assetHandle]);
+
+		s_EvictedAssets.insert(assetHandle);
+		s_MemoryStats[type].Evictions++;
+	}
+
+	Ref<Asset> AssetManager::GetPlaceholderAsset(AssetType type)
+	{
+		auto it = s_PlaceholderAssets.find(type);
+		if (it == s_PlaceholderAssets.end())
+			return nullptr;
+
+		return it->second;
+	}
+
+	void AssetManager::SetPlaceholderAsset(AssetType type, const Ref<Asset>& placeholder)
+	{
+		s_PlaceholderAssets[type] = placeholder;
+	}
+
+	std::vector<Ref<Asset>> AssetManager::GetAssetsInDirectory(AssetHandle directoryHandle)
+	{
+		std::vector<Ref<Asset>> results;
+
+		auto it = s_LoadedAssets.find(directoryHandle);
+		if (it == s_LoadedAssets.end() || it->second->Type != AssetType::Directory)
+			return results;
+
+		Ref<Directory> directory = it->second.As<Directory>();
+		results.reserve(directory->ChildDirectories.size() + directory->ChildAssets.size());
+
+		for (AssetHandle child : directory->ChildDirectories)
+			results.push_back(s_LoadedAssets[child]);
+
+		for (AssetHandle child : directory->ChildAssets)
+			results.push_back(s_LoadedAssets[child]);
+
+		return results;
+	}
+
+	AssetHandle AssetManager::FindParentHandle(const std::string& filepath)
+	{
+		return GetAssetHandleFromFilePath(GetParentPath(NormalizePath(filepath)));
+	}
+
+	void AssetManager::AddToIndex(const Ref<Asset>& asset)
+	{
+		// Re-importing an asset replaces the old instance
+		auto existing = s_LoadedAssets.find(asset->Handle);
+		if (existing != s_LoadedAssets.end())
+		{
+			Ref<Asset> existingAsset = existing->second;
+			RemoveFromIndex(existingAsset);
+		}
+
+		s_LoadedAssets[asset->Handle] = asset;
+		s_AssetPathIndex[asset->FilePath] = asset->Handle;
+
+		if (!IsAssetHandleValid(asset->ParentDirectory))
+			return;
+
+		Ref<Directory> parent = s_LoadedAssets[asset->ParentDirectory].As<Directory>();
+		if (asset->Type == AssetType::Directory)
+			parent->ChildDirectories.push_back(asset->Handle);
+		else
+			parent->ChildAssets.push_back(asset->Handle);
+	}
+
+	void AssetManager::RemoveFromIndex(const Ref<Asset>& asset)
+	{
+		// asset may be the instance stored in s_LoadedAssets, copy the handle before erasing it
+		AssetHandle handle = asset->Handle;
+
+		if (IsAssetHandleValid(asset->ParentDirectory))
+		{
+			Ref<Directory> parent = s_LoadedAssets[asset->ParentDirectory].As<Directory>();
+			auto& childList = asset->Type == AssetType::Directory ? parent->ChildDirectories : parent->ChildAssets;
+			childList.erase(std::remove(childList.begin(), childList.end(), asset->Handle), childList.end());
+		}
+
+		auto pathIt = s_AssetPathIndex.find(asset->FilePath);
+		if (pathIt != s_AssetPathIndex.end() && pathIt->second == handle)
+			s_AssetPathIndex.erase(pathIt);
+
+		UnregisterDependencies(handle);
+		UntrackResidency(handle);
+		s_EvictedAssets.erase(handle);
+		s_LoadedAssets.erase(handle);
+	}
+
+	void AssetManager::SetAssetFilePath(Ref<Asset> asset, const std::string& filepath)
+	{
+		std::string oldFilePath = asset->FilePath;
+		std::string newFilePath = NormalizePath(filepath);
+
+		auto pathIt = s_AssetPathIndex.find(oldFilePath);
+		if (pathIt != s_AssetPathIndex.end() && pathIt->second == asset->Handle)
+			s_AssetPathIndex.erase(pathIt);
+		s_AssetPathIndex[newFilePath] = asset->Handle;
+
+		auto registryIt = s_AssetRegistry.find(oldFilePath);
+		if (registryIt != s_AssetRegistry.end())
+		{
+			AssetMetadata metadata = registryIt->second;
+			metadata.FilePath = newFilePath;
+			s_AssetRegistry.erase(registryIt);
+			SetRegistryEntry(metadata); // Records are keyed by handle, this replaces the old path
+		}
+
+		asset->FilePath = newFilePath;
+
+		// Everything below a renamed directory moves with it
+		if (asset->Type == AssetType::Directory)
+		{
+			Ref<Directory> directory = asset.As<Directory>();
+			for (AssetHandle child : directory->ChildDirectories)
+			{
+				Ref<Asset>& childAsset = s_LoadedAssets[child];
+				SetAssetFilePath(childAsset, newFilePath + childAsset->FilePath.substr(oldFilePath.size()));
+			}
+
+			for (AssetHandle child : directory->ChildAssets)
+			{
+				Ref<Asset>& childAsset = s_LoadedAssets[child];
+				SetAssetFilePath(childAsset, newFilePath + childAsset->FilePath.substr(oldFilePath.size()));
+			}
+		}
+	}
+
+	void AssetManager::OnFileSystemChanged(FileSystemChangedEvent e)
+	{
+		// Runs on the file watcher thread, everything the events touch belongs to the main thread
+		std::lock_guard<std::mutex> lock(s_PendingReloads.Mutex);
+		s_PendingReloads.Events.push_back(std::move(e));
+	}
+
+	void AssetManager::ProcessFileSystemEvents()
+	{
+		std::vector<FileSystemChangedEvent> events;
+		{
+			std::lock_guard<std::mutex> lock(s_PendingReloads.Mutex);
+			events.swap(s_PendingReloads.Events);
+		}
+
+		if (events.empty())
+			return;
+
+		for (FileSystemChangedEvent& e : events)
+		{
+			e.FilePath = NormalizePath(e.FilePath);
+			std::string oldFilePath = GetParentPath(e.FilePath) + "/" + e.OldName;
+
+			e.NewName = Utils::RemoveExtension(e.NewName);
+			e.OldName = Utils::RemoveExtension(e.OldName);
+
+			AssetHandle parentHandle = FindParentHandle(e.FilePath);
+
+			if (e.Action == FileSystemAction::Added)
+			{
+				if (e.IsDirectory)
+					ProcessDirectory(e.FilePath, parentHandle);
+				else
+					ImportAsset(e.FilePath, parentHandle);
+			}
+
+			// Coalesced and reimported by ProcessPendingReloads
+			if (e.Action == FileSystemAction::Modified)
+			{
+				if (!e.IsDirectory)
+				{
+					std::lock_guard<std::mutex> lock(s_PendingReloads.Mutex);
+					s_PendingReloads.LastModified[e.FilePath] = std::chrono::steady_clock::now();
+				}
+			}
+
+			if (e.Action == FileSystemAction::Rename)
+			{
+				AssetHandle handle = GetAssetHandleFromFilePath(oldFilePath);
+				if (IsAssetHandleValid(handle))
+				{
+					Ref<Asset>& asset = s_LoadedAssets[handle];
+					SetAssetFilePath(asset, e.FilePath);
+					asset->FileName = e.NewName;
+				}
+			}
+
+			if (e.Action == FileSystemAction::Delete)
+			{
+				AssetHandle handle = GetAssetHandleFromFilePath(e.FilePath);
+				if (IsAssetHandleValid(handle))
+					RemoveAsset(handle);
 			}
 		}
 
+		UpdateRegistryCache();
 		s_AssetsChangeCallback();
 	}
 
@@ -154,26 +901,17 @@ namespace Hazel {
 
 	bool AssetManager::IsDirectory(const std::string& filepath)
 	{
-		for (auto& [handle, asset] : s_LoadedAssets)
-		{
-			if (asset->Type == AssetType::Directory && asset->FilePath == filepath)
-				return true;
-		}
-
-		return false;
+		AssetHandle handle = GetAssetHandleFromFilePath(filepath);
+		return IsAssetHandleValid(handle) && s_LoadedAssets[handle]->Type == AssetType::Directory;
 	}
 
 	AssetHandle AssetManager::GetAssetHandleFromFilePath(const std::string& filepath)
 	{
-		std::string fixedFilepath = filepath;
-		std::replace(fixedFilepath.begin(), fixedFilepath.end(), '\\', '/');
-		for (auto& [id, asset] : s_LoadedAssets)
-		{
-			if (asset->FilePath == fixedFilepath)
-				return id;
-		}
+		auto it = s_AssetPathIndex.find(NormalizePath(filepath));
+		if (it == s_AssetPathIndex.end())
+			return 0;
 
-		return 0;
+		return it->second;
 	}
 
 	bool AssetManager::IsAssetHandleValid(AssetHandle assetHandle)
@@ -184,11 +922,9 @@ namespace Hazel {
 	void AssetManager::Rename(AssetHandle assetHandle, const std::string& newName)
 	{
 		Ref<Asset>& asset = s_LoadedAssets[assetHandle];
-		AssetMetadata& metadata = s_AssetRegistry[asset->FilePath];
 		std::string newFilePath = FileSystem::Rename(asset->FilePath, newName);
-		asset->FilePath = newFilePath;
+		SetAssetFilePath(asset, newFilePath);
 		asset->FileName = newName;
-		metadata.FilePath = newFilePath;
 		UpdateRegistryCache();
 	}
 
@@ -197,30 +933,24 @@ namespace Hazel {
 		Ref<Asset> asset = s_LoadedAssets[assetHandle];
 		if (asset->Type == AssetType::Directory)
 		{
-			if (IsAssetHandleValid(asset->ParentDirectory))
-			{
-				auto& childList = s_LoadedAssets[asset->ParentDirectory].As<Directory>()->ChildDirectories;
-				childList.erase(std::remove(childList.begin(), childList.end(), assetHandle), childList.end());
-			}
+			// Copies, removing a child also removes it from these lists
+			Ref<Directory> directory = asset.As<Directory>();
+			std::vector<AssetHandle> childDirectories = directory->ChildDirectories;
+			std::vector<AssetHandle> childAssets = directory->ChildAssets;
 
-			for (auto child : asset.As<Directory>()->ChildDirectories)
+			for (AssetHandle child : childDirectories)
 				RemoveAsset(child);
 
-			for (auto it = s_LoadedAssets.begin(); it != s_LoadedAssets.end(); )
+			for (AssetHandle child : childAssets)
 			{
-				if (it->second->ParentDirectory != assetHandle)
-				{
-					it++;
-					continue;
-				}
-
-				s_AssetRegistry.erase(it->second->FilePath);
-				it = s_LoadedAssets.erase(it);
+				Ref<Asset> childAsset = s_LoadedAssets[child];
+				RemoveRegistryEntry(childAsset->FilePath);
+				RemoveFromIndex(childAsset);
 			}
 		}
 
-		s_AssetRegistry.erase(asset->FilePath);
-		s_LoadedAssets.erase(assetHandle);
+		RemoveRegistryEntry(asset->FilePath);
+		RemoveFromIndex(asset);
 
 		UpdateRegistryCache();
 	}
@@ -241,10 +971,93 @@ namespace Hazel {
 
 	void AssetManager::LoadAssetRegistry()
 	{
-		if (!FileSystem::Exists("assets/cache/AssetRegistryCache.hzr"))
+		// Shipping builds read it from the pak archive, the handles scenes refer to have to match. Writing it back
+		// would only leave a loose copy next to the archive that shadows it.
+		s_RegistryJournal.ReadOnly = VirtualFileSystem::IsInArchive(s_AssetRegistryPath);
+
+		Timer timer;
+		FileView file;
+		if (!VirtualFileSystem::ReadFile(s_AssetRegistryPath, file) || file.GetSize() == 0)
+		{
+			s_RegistryJournal.NeedsSnapshot = true;
+			LoadLegacyAssetRegistry();
+			return;
+		}
+
+		const uint8_t* fileData = file.GetData();
+		uint64_t fileSize = file.GetSize();
+		if (fileSize < s_RegistryHeaderSize || memcmp(fileData, s_RegistryMagic, sizeof(s_RegistryMagic)) != 0
+			|| *(const uint32_t*)(fileData + sizeof(s_RegistryMagic)) != s_RegistryVersion)
+		{
+			HZ_CORE_ERROR("Asset Registry file is invalid or outdated, it will be rebuilt.");
+			s_RegistryJournal.NeedsSnapshot = true;
+			return;
+		}
+
+		// Replay the journal, later records for a handle override earlier ones
+		std::unordered_map<uint64_t, AssetMetadata> entries;
+		uint64_t recordCount = 0;
+		uint64_t offset = s_RegistryHeaderSize;
+		while (offset + s_RegistryRecordHeaderSize <= fileSize)
+		{
+			const uint8_t* record = fileData + offset;
+
+			uint64_t handle;
+			uint16_t pathLength;
+			memcpy(&handle, record + 2, sizeof(handle));
+			memcpy(&pathLength, record + 10, sizeof(pathLength));
+
+			if (offset + s_RegistryRecordHeaderSize + pathLength > fileSize)
+				break;
+
+			if ((RegistryRecordType)record[0] == RegistryRecordType::Remove)
+			{
+				entries.erase(handle);
+			}
+			else
+			{
+				AssetMetadata& metadata = entries[handle];
+				metadata.Handle = handle;
+				metadata.Type = (AssetType)record[1];
+				metadata.FilePath.assign((const char*)record + s_RegistryRecordHeaderSize, pathLength);
+			}
+
+			offset += s_RegistryRecordHeaderSize + pathLength;
+			recordCount++;
+		}
+
+		if (offset != fileSize)
+		{
+			// Records appended after the torn one would be skipped on the next load
+			HZ_CORE_WARN("Asset Registry file ends with an incomplete record, it was probably interrupted while writing.");
+			s_RegistryJournal.NeedsSnapshot = true;
+		}
+
+		file.Release();
+
+		// Entries for files that no longer exist are pruned once the assets directory has been scanned
+		s_AssetRegistry.reserve(entries.size());
+		for (auto& [handle, metadata] : entries)
+		{
+			if (metadata.Handle == 0)
+			{
+				HZ_CORE_WARN("AssetHandle for {0} is 0, this shouldn't happen.", metadata.FilePath);
+				continue;
+			}
+
+			s_AssetRegistry[metadata.FilePath] = std::move(metadata);
+		}
+
+		s_RegistryJournal.RecordCount = recordCount;
+		HZ_CORE_INFO("Loaded Asset Registry: {0} entries from {1} records in {2}ms", s_AssetRegistry.size(), recordCount, timer.ElapsedMillis());
+	}
+
+	void AssetManager::LoadLegacyAssetRegistry()
+	{
+		if (!FileSystem::Exists(s_LegacyAssetRegistryPath))
 			return;
 
-		std::ifstream stream("assets/cache/AssetRegistryCache.hzr");
+		std::ifstream stream(s_LegacyAssetRegistryPath);
 		HZ_CORE_ASSERT(stream);
 		std::stringstream strStream;
 		strStream << stream.rdbuf();
@@ -264,12 +1077,6 @@ namespace Hazel {
 			metadata.FilePath = entry["FilePath"].as<std::string>();
 			metadata.Type = (AssetType)entry["Type"].as<int>();
 
-			if (!FileSystem::Exists(metadata.FilePath))
-			{
-				HZ_CORE_WARN("Tried to load metadata for non-existing asset: {0}", metadata.FilePath);
-				continue;
-			}
-
 			if (metadata.Handle == 0)
 			{
 				HZ_CORE_WARN("AssetHandle for {0} is 0, this shouldn't happen.", metadata.FilePath);
@@ -278,6 +1085,28 @@ namespace Hazel {
 
 			s_AssetRegistry[metadata.FilePath] = metadata;
 		}
+
+		HZ_CORE_INFO("Converted {0} to the binary Asset Registry", s_LegacyAssetRegistryPath);
+	}
+
+	void AssetManager::SetRegistryEntry(const AssetMetadata& metadata)
+	{
+		s_AssetRegistry[metadata.FilePath] = metadata;
+		WriteRegistryRecord(s_RegistryJournal.PendingRecords, RegistryRecordType::Set, metadata);
+		s_RegistryJournal.RecordCount++;
+		s_RegistryJournal.ChangedSinceExport = true;
+	}
+
+	void AssetManager::RemoveRegistryEntry(const std::string& filepath)
+	{
+		auto it = s_AssetRegistry.find(filepath);
+		if (it == s_AssetRegistry.end())
+			return;
+
+		WriteRegistryRecord(s_RegistryJournal.PendingRecords, RegistryRecordType::Remove, it->second);
+		s_RegistryJournal.RecordCount++;
+		s_RegistryJournal.ChangedSinceExport = true;
+		s_AssetRegistry.erase(it);
 	}
 
 	Ref<Asset> AssetManager::CreateAsset(const std::string& filepath, AssetType type, AssetHandle parentHandle)
@@ -288,8 +1117,7 @@ namespace Hazel {
 			asset = Ref<Directory>::Create();
 
 		std::string extension = Utils::GetExtension(filepath);
-		asset->FilePath = filepath;
-		std::replace(asset->FilePath.begin(), asset->FilePath.end(), '\\', '/');
+		asset->FilePath = NormalizePath(filepath);
 
 		if (s_AssetRegistry.find(asset->FilePath) != s_AssetRegistry.end())
 		{
@@ -330,15 +1158,74 @@ namespace Hazel {
 			metadata.Handle = asset->Handle;
 			metadata.FilePath = asset->FilePath;
 			metadata.Type = asset->Type;
-			s_AssetRegistry[asset->FilePath] = metadata;
+			SetRegistryEntry(metadata);
 		}
 
-		s_LoadedAssets[asset->Handle] = asset;
+		AddToIndex(asset);
+	}
+
+	// Contents of a directory on disk, filled in by the parallel scan before any asset is created
+	struct ScannedDirectory
+	{
+		std::string Path;
+		std::vector<std::string> Files;
+		std::vector<ScannedDirectory> Directories;
+	};
+
+	static void ScanDirectory(ScannedDirectory& directory, JobCounter& counter)
+	{
+		std::error_code error;
+		if (!std::filesystem::is_directory(directory.Path, error) && VirtualFileSystem::HasMountedArchives())
+		{
+			// Shipping builds only have the pak archive
+			std::vector<std::string> directories;
+			VirtualFileSystem::GetDirectoryContents(directory.Path, directory.Files, directories);
+			for (std::string& subdirectory : directories)
+				directory.Directories.push_back({ std::move(subdirectory) });
+		}
+		else
+		{
+			for (auto& entry : std::filesystem::directory_iterator(directory.Path, error))
+			{
+				if (entry.is_directory(error))
+					directory.Directories.push_back({ entry.path().string() });
+				else
+					directory.Files.push_back(entry.path().string());
+			}
+
+			if (error)
+				HZ_CORE_WARN("Failed to scan {0}: {1}", directory.Path, error.message());
+		}
+
+		// Subdirectories are fanned out once this directory is complete, so their storage doesn't move anymore
+		for (ScannedDirectory& subdirectory : directory.Directories)
+		{
+			JobSystem::Submit([&subdirectory, &counter]()
+			{
+				ScanDirectory(subdirectory, counter);
+			}, &counter);
+		}
 	}
 
 	AssetHandle AssetManager::ProcessDirectory(const std::string& directoryPath, AssetHandle parentHandle)
 	{
-		Ref<Directory> dirInfo = CreateAsset(directoryPath, AssetType::Directory, parentHandle).As<Directory>();
+		// Walking the file system is the slow part and runs on the job system, creating the assets
+		// touches the registry and the index so it happens afterwards on this thread
+		ScannedDirectory root;
+		root.Path = directoryPath;
+
+		Timer timer;
+		JobCounter counter;
+		ScanDirectory(root, counter);
+		JobSystem::Wait(counter);
+		HZ_CORE_TRACE("Walked {0} in {1}ms", directoryPath, timer.ElapsedMillis());
+
+		return ImportScannedDirectory(root, parentHandle);
+	}
+
+	AssetHandle AssetManager::ImportScannedDirectory(const ScannedDirectory& directory, AssetHandle parentHandle)
+	{
+		Ref<Directory> dirInfo = CreateAsset(directory.Path, AssetType::Directory, parentHandle).As<Directory>();
 		dirInfo->IsDataLoaded = true;
 
 		if (s_AssetRegistry.find(dirInfo->FilePath) == s_AssetRegistry.end())
@@ -347,52 +1234,37 @@ namespace Hazel {
 			metadata.Handle = dirInfo->Handle;
 			metadata.FilePath = dirInfo->FilePath;
 			metadata.Type = dirInfo->Type;
-			s_AssetRegistry[dirInfo->FilePath] = metadata;
+			SetRegistryEntry(metadata);
 		}
 
-		s_LoadedAssets[dirInfo->Handle] = dirInfo;
+		AddToIndex(dirInfo);
 
-		if (IsAssetHandleValid(parentHandle))
-			s_LoadedAssets[parentHandle].As<Directory>()->ChildDirectories.push_back(dirInfo->Handle);
+		dirInfo->ChildDirectories.reserve(directory.Directories.size());
+		dirInfo->ChildAssets.reserve(directory.Files.size());
 
-		for (auto entry : std::filesystem::directory_iterator(directoryPath))
-		{
-			if (entry.is_directory())
-				ProcessDirectory(entry.path().string(), dirInfo->Handle);
-			else
-				ImportAsset(entry.path().string(), dirInfo->Handle);
-		}
+		for (const ScannedDirectory& subdirectory : directory.Directories)
+			ImportScannedDirectory(subdirectory, dirInfo->Handle);
+
+		for (const std::string& file : directory.Files)
+			ImportAsset(file, dirInfo->Handle);
 
 		return dirInfo->Handle;
 	}
 
 	void AssetManager::ReloadAssets()
 	{
+		Timer timer;
 		ProcessDirectory("assets", 0);
-
-		// Sort the assets alphabetically (not the best impl)
-		std::vector<std::pair<std::string, Ref<Asset>>> sortedVec;
-		for (auto& [handle, asset] : s_LoadedAssets)
-		{
-			std::string filename = asset->FileName;
-			std::for_each(filename.begin(), filename.end(), [](char& c)
-				{
-					c = std::tolower(c);
-				});
-			sortedVec.push_back(std::make_pair(filename, asset));
-		}
-
-		std::sort(sortedVec.begin(), sortedVec.end());
-		s_LoadedAssets.clear();
-
-		for (auto& p : sortedVec)
-			s_LoadedAssets[p.second->Handle] = p.second;
+		HZ_CORE_INFO("Scanned and indexed {0} assets ({1} paths) in {2}ms", s_LoadedAssets.size(), s_AssetPathIndex.size(), timer.ElapsedMillis());
 
 		// Remove any non-existent assets from the asset registry
 		for (auto it = s_AssetRegistry.begin(); it != s_AssetRegistry.end(); )
 		{
 			if (s_LoadedAssets.find(it->second.Handle) == s_LoadedAssets.end())
 			{
+				WriteRegistryRecord(s_RegistryJournal.PendingRecords, RegistryRecordType::Remove, it->second);
+				s_RegistryJournal.RecordCount++;
+				s_RegistryJournal.ChangedSinceExport = true;
 				it = s_AssetRegistry.erase(it);
 			}
 			else
@@ -404,27 +1276,146 @@ namespace Hazel {
 
 	void AssetManager::UpdateRegistryCache()
 	{
+		if (s_RegistryJournal.ReadOnly)
+		{
+			s_RegistryJournal.PendingRecords.clear();
+			return;
+		}
+
+		if (s_RegistryJournal.NeedsSnapshot || s_RegistryJournal.RecordCount > s_AssetRegistry.size() * 2 + 1024)
+		{
+			WriteRegistrySnapshot();
+			return;
+		}
+
+		if (s_RegistryJournal.PendingRecords.empty())
+			return;
+
+		Timer timer;
+		{
+			std::ofstream stream(s_AssetRegistryPath, std::ios::binary | std::ios::app);
+			stream.write((const char*)s_RegistryJournal.PendingRecords.data(), s_RegistryJournal.PendingRecords.size());
+		}
+		HZ_CORE_TRACE("Appended {0} bytes to the Asset Registry in {1}ms", s_RegistryJournal.PendingRecords.size(), timer.ElapsedMillis());
+		s_RegistryJournal.PendingRecords.clear();
+	}
+
+	void AssetManager::WriteRegistrySnapshot()
+	{
+		Timer timer;
+		std::vector<uint8_t> buffer;
+		buffer.reserve(s_RegistryHeaderSize + s_AssetRegistry.size() * (s_RegistryRecordHeaderSize + 64));
+		buffer.insert(buffer.end(), s_RegistryMagic, s_RegistryMagic + sizeof(s_RegistryMagic));
+		buffer.insert(buffer.end(), (const uint8_t*)&s_RegistryVersion, (const uint8_t*)&s_RegistryVersion + sizeof(s_RegistryVersion));
+
+		for (auto& [filepath, metadata] : s_AssetRegistry)
+			WriteRegistryRecord(buffer, RegistryRecordType::Set, metadata);
+
+		// Written next to the registry and swapped in, so an interrupted write can't lose the old one
+		std::string tempPath = std::string(s_AssetRegistryPath) + ".tmp";
+		{
+			std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+			stream.write((const char*)buffer.data(), buffer.size());
+		}
+
+		std::error_code error;
+		std::filesystem::rename(tempPath, s_AssetRegistryPath, error);
+		if (error)
+			HZ_CORE_ERROR("Failed to write Asset Registry: {0}", error.message());
+
+		s_RegistryJournal.PendingRecords.clear();
+		s_RegistryJournal.RecordCount = s_AssetRegistry.size();
+		s_RegistryJournal.NeedsSnapshot = false;
+		HZ_CORE_INFO("Wrote Asset Registry snapshot: {0} entries ({1} KB) in {2}ms", s_AssetRegistry.size(), buffer.size() / 1024, timer.ElapsedMillis());
+	}
+
+	void AssetManager::ExportRegistry(const std::string& filepath)
+	{
+		std::map<std::string, const AssetMetadata*> sortedRegistry;
+		for (auto& [path, metadata] : s_AssetRegistry)
+			sortedRegistry[path] = &metadata;
+
 		YAML::Emitter out;
 		out << YAML::BeginMap;
 
 		out << YAML::Key << "Assets" << YAML::BeginSeq;
-		for (auto& [filepath, metadata] : s_AssetRegistry)
+		for (auto& [path, metadata] : sortedRegistry)
 		{
 			out << YAML::BeginMap;
-			out << YAML::Key << "Handle" << YAML::Value << metadata.Handle;
-			out << YAML::Key << "FilePath" << YAML::Value << metadata.FilePath;
-			out << YAML::Key << "Type" << YAML::Value << (int)metadata.Type;
+			out << YAML::Key << "Handle" << YAML::Value << metadata->Handle;
+			out << YAML::Key << "FilePath" << YAML::Value << metadata->FilePath;
+			out << YAML::Key << "Type" << YAML::Value << (int)metadata->Type;
 			out << YAML::EndMap;
 		}
 		out << YAML::EndSeq;
 		out << YAML::EndMap;
 
-		std::ofstream fout("assets/cache/AssetRegistryCache.hzr");
+		std::ofstream fout(filepath);
 		fout << out.c_str();
+
+		s_RegistryJournal.ChangedSinceExport = false;
+	}
+
+	bool AssetManager::BuildAssetPak(const std::string& filepath, const PakWriteOptions& options)
+	{
+		// Scenes refer to assets by handle, the registry has to ship with them. A snapshot drops stale journal records.
+		s_RegistryJournal.PendingRecords.clear();
+		WriteRegistrySnapshot();
+
+		std::vector<std::string> files;
+		files.push_back(s_AssetRegistryPath);
+
+		// The rest of the cache is rebuilt on demand, except for the derived data entries. Shipping those saves
+		// packaged builds from compiling shaders and cooking meshes and colliders on first load.
+		DerivedDataCache::GetEntryPaths(files);
+
+		const std::filesystem::path cacheDirectory = std::filesystem::path(s_AssetRegistryPath).parent_path();
+
+		std::error_code error;
+		auto it = std::filesystem::recursive_directory_iterator("assets", error);
+		for (; !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+		{
+			if (it->is_directory(error))
+			{
+				if (it->path().lexically_normal() == cacheDirectory.lexically_normal())
+					it.disable_recursion_pending();
+				continue;
+			}
+
+			files.push_back(it->path().string());
+		}
+
+		if (error)
+		{
+			HZ_CORE_ERROR("Failed to scan assets for the pak archive: {0}", error.message());
+			return false;
+		}
+
+		return PakArchive::Write(filepath, files, options);
 	}
 
 	std::unordered_map<AssetHandle, Ref<Asset>> AssetManager::s_LoadedAssets;
+	std::unordered_map<std::string, AssetHandle> AssetManager::s_AssetPathIndex;
 	std::unordered_map<std::string, AssetManager::AssetMetadata> AssetManager::s_AssetRegistry;
 	AssetManager::AssetsChangeEventFn AssetManager::s_AssetsChangeCallback;
 
+	std::unordered_map<AssetHandle, Ref<AssetLoadRequest>> AssetManager::s_LoadRequests;
+	std::array<std::deque<Ref<AssetLoadRequest>>, (size_t)AssetLoadPriority::Count> AssetManager::s_LoadQueues;
+	std::vector<Ref<AssetLoadRequest>> AssetManager::s_InFlightLoads;
+	uint32_t AssetManager::s_MaxConcurrentLoads = 1;
+	std::unordered_map<AssetType, Ref<Asset>> AssetManager::s_PlaceholderAssets;
+
+	std::unordered_map<AssetHandle, Ref<AssetLoadRequest>> AssetManager::s_ReloadRequests;
+	std::unordered_map<std::string, std::vector<AssetHandle>> AssetManager::s_AssetDependents;
+	std::unordered_map<AssetHandle, std::vector<std::string>> AssetManager::s_AssetDependencies;
+	std::vector<AssetManager::AssetReloadedFn> AssetManager::s_AssetReloadCallbacks;
+
+	std::unordered_map<AssetHandle, AssetResidency> AssetManager::s_AssetResidency;
+	std::unordered_map<AssetType, AssetTypeMemoryStats> AssetManager::s_MemoryStats;
+	std::unordered_set<AssetHandle> AssetManager::s_EvictedAssets;
+	AssetMemoryUsage AssetManager::s_ResidentMemory;
+	uint64_t AssetManager::s_CPUMemoryBudget = 0;
+	uint64_t AssetManager::s_GPUMemoryBudget = 0;
+	uint64_t AssetManager::s_FrameIndex = 0;
+
 }
\ No newline at end of file
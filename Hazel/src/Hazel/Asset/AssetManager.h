@@ -2,17 +2,79 @@
 
 #include "AssetImporter.h"
 #include "Hazel/Utilities/FileSystem.h"
+#include "Hazel/Utilities/PakArchive.h"
 #include "Hazel/Utilities/StringUtils.h"
+#include "Hazel/Renderer/RenderCommandQueue.h"
 
+#include <array>
+#include <atomic>
+#include <deque>
 #include <map>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace Hazel {
 
+	enum class AssetLoadPriority : uint8_t
+	{
+		Visible = 0, // Needed for the current frame
+		Prefetch,    // Likely needed soon
+		Background,
+		Count
+	};
+
+	enum class AssetLoadState : uint8_t
+	{
+		Queued, Loading, Decoded, Loaded, Failed
+	};
+
+	// One asynchronous load. The asset is decoded on a worker, which records its GPU uploads into
+	// Commands; the main thread then hands those to the render thread and publishes the asset.
+	struct AssetLoadRequest : public RefCounted
+	{
+		AssetHandle Handle;
+		AssetLoadPriority Priority = AssetLoadPriority::Background;
+		std::atomic<AssetLoadState> State = AssetLoadState::Queued;
+
+		// Written by the worker before State becomes Decoded
+		Ref<Asset> Result;
+		bool Success = false;
+		RenderCommandQueue Commands;
+
+		bool IsDone() const
+		{
+			AssetLoadState state = State.load(std::memory_order_acquire);
+			return state == AssetLoadState::Loaded || state == AssetLoadState::Failed;
+		}
+	};
+
+	// Resident data of one asset type, plus how often that type has been evicted and loaded back
+	struct AssetTypeMemoryStats
+	{
+		uint32_t ResidentCount = 0;
+		uint64_t CPUBytes = 0;
+		uint64_t GPUBytes = 0;
+		uint64_t Evictions = 0;
+		uint64_t Reloads = 0; // Loaded again after being evicted
+	};
+
+	struct AssetResidency
+	{
+		AssetMemoryUsage Usage;
+		uint64_t LastUsedFrame = 0;
+	};
+
+	template<typename T>
+	class AsyncAsset;
+
+	struct ScannedDirectory;
+
 	class AssetManager
 	{
 	public:
 		using AssetsChangeEventFn = std::function<void()>;
+		using AssetReloadedFn = std::function<void(const Ref<Asset>&)>;
+		using PreloadProgressFn = std::function<void(uint32_t loadedCount, uint32_t totalCount)>;
 
 		struct AssetMetadata
 		{
@@ -25,6 +87,13 @@ namespace Hazel {
 		static void SetAssetChangeCallback(const AssetsChangeEventFn& callback);
 		static void Shutdown();
 
+		// Publishes finished async loads and reloads and starts queued ones, called once per frame on the main thread
+		static void Update();
+
+		// Called on the main thread with the new instance (same handle) once a modified asset has been reimported
+		// and swapped in. Whoever holds the old instance should replace it.
+		static void AddAssetReloadCallback(const AssetReloadedFn& callback);
+
 		static std::vector<Ref<Asset>> GetAssetsInDirectory(AssetHandle directoryHandle);
 		static std::vector<Ref<Asset>> SearchAssets(const std::string& query, const std::string& searchPath, AssetType desiredTypes = AssetType::None);
 
@@ -38,6 +107,23 @@ namespace Hazel {
 
 		static AssetType GetAssetTypeForFileType(const std::string& extension);
 
+		// Human readable copy of the registry, sorted by path so it diffs cleanly
+		static void ExportRegistry(const std::string& filepath);
+
+		// Packs the assets directory (minus derived data) and the registry into one archive for shipping builds,
+		// which mount it through the VirtualFileSystem
+		static bool BuildAssetPak(const std::string& filepath, const PakWriteOptions& options = PakWriteOptions());
+
+		// While resident assets exceed either budget, the least recently used ones that nothing outside the
+		// manager references are unloaded; GetAsset loads them again. A budget of 0 is unlimited.
+		static void SetMemoryBudget(uint64_t cpuBytes, uint64_t gpuBytes);
+		static uint64_t GetCPUMemoryBudget() { return s_CPUMemoryBudget; }
+		static uint64_t GetGPUMemoryBudget() { return s_GPUMemoryBudget; }
+
+		static const AssetMemoryUsage& GetResidentMemory() { return s_ResidentMemory; }
+		static const std::unordered_map<AssetType, AssetTypeMemoryStats>& GetMemoryStats() { return s_MemoryStats; }
+		static const std::unordered_map<AssetHandle, AssetResidency>& GetResidency() { return s_AssetResidency; }
+
 		template<typename T, typename... Args>
 		static Ref<T> CreateNewAsset(const std::string& filename, AssetType type, AssetHandle directoryHandle, Args&&... args)
 		{
@@ -53,14 +139,14 @@ namespace Hazel {
 			asset->ParentDirectory = directoryHandle;
 			asset->Handle = AssetHandle();
 			asset->IsDataLoaded = true;
-			s_LoadedAssets[asset->Handle] = asset;
+			AddToIndex(asset);
 			AssetImporter::Serialize(asset);
 
 			AssetMetadata metadata;
 			metadata.Handle = asset->Handle;
 			metadata.FilePath = asset->FilePath;
 			metadata.Type = asset->Type;
-			s_AssetRegistry[asset->FilePath] = metadata;
+			SetRegistryEntry(metadata);
 			UpdateRegistryCache();
 
 			return asset;
@@ -72,12 +158,42 @@ namespace Hazel {
 			HZ_CORE_ASSERT(s_LoadedAssets.find(assetHandle) != s_LoadedAssets.end());
 			Ref<Asset>& asset = s_LoadedAssets[assetHandle];
 
-			if (!asset->IsDataLoaded && loadData)
+			// An async load that is already in flight is finished instead of decoding the asset twice
+			if (!asset->IsDataLoaded && loadData && !FinishAsyncLoad(assetHandle))
+			{
 				AssetImporter::TryLoadData(asset);
+				RegisterDependencies(asset);
+			}
+
+			// Only loads count as a use, metadata lookups (e.g. from the content browser) shouldn't keep assets resident
+			if (loadData)
+				TouchAsset(asset);
 
 			return asset.As<T>();
 		}
 
+		// Queues the asset's data to be loaded on a worker thread. Requesting an asset that is already
+		// queued raises its priority if the new one is higher.
+		template<typename T>
+		static AsyncAsset<T> GetAssetAsync(AssetHandle assetHandle, AssetLoadPriority priority = AssetLoadPriority::Visible)
+		{
+			return AsyncAsset<T>(assetHandle, RequestAsyncLoad(assetHandle, priority));
+		}
+
+		// Returned by AsyncAsset::Get until the asset is loaded, may be null
+		static Ref<Asset> GetPlaceholderAsset(AssetType type);
+		static void SetPlaceholderAsset(AssetType type, const Ref<Asset>& placeholder);
+
+		// Upper bound on assets decoded at the same time, so background loads can't take over every worker
+		static void SetMaxConcurrentLoads(uint32_t count) { s_MaxConcurrentLoads = count > 0 ? count : 1; }
+		static uint32_t GetMaxConcurrentLoads() { return s_MaxConcurrentLoads; }
+		static uint32_t GetPendingLoadCount() { return (uint32_t)s_LoadRequests.size(); }
+
+		// Loads all of the assets concurrently, using every worker, and returns once each one is loaded or has
+		// failed. Blocks the calling (main) thread; progress is reported every time another asset is done.
+		// Returns false if any of them failed to load.
+		static bool PreloadAssets(const std::vector<AssetHandle>& assetHandles, const PreloadProgressFn& progressCallback = nullptr);
+
 		template<typename T>
 		static Ref<T> GetAsset(const std::string& filepath, bool loadData = true)
 		{
@@ -86,21 +202,108 @@ namespace Hazel {
 
 	private:
 		static void LoadAssetRegistry();
+		static void LoadLegacyAssetRegistry();
+		static void WriteRegistrySnapshot();
+		static void SetRegistryEntry(const AssetMetadata& metadata);
+		static void RemoveRegistryEntry(const std::string& filepath);
 		static Ref<Asset> CreateAsset(const std::string& filepath, AssetType type, AssetHandle parentHandle);
 		static void ImportAsset(const std::string& filepath, AssetHandle parentHandle);
 		static AssetHandle ProcessDirectory(const std::string& directoryPath, AssetHandle parentHandle);
+		static AssetHandle ImportScannedDirectory(const ScannedDirectory& directory, AssetHandle parentHandle);
 		static void ReloadAssets();
+		// Writes registry changes made since the last call
 		static void UpdateRegistryCache();
 
+		// Queues the event, ProcessFileSystemEvents applies it from Update
 		static void OnFileSystemChanged(FileSystemChangedEvent e);
+		static void ProcessFileSystemEvents();
 
-		static AssetHandle FindParentHandleInChildren(Ref<Directory>& dir, const std::string& dirName);
 		static AssetHandle FindParentHandle(const std::string& filepath);
 
+		// Keeps s_LoadedAssets, the path index and the parent directory's child lists in sync
+		static void AddToIndex(const Ref<Asset>& asset);
+		static void RemoveFromIndex(const Ref<Asset>& asset);
+		static void SetAssetFilePath(Ref<Asset> asset, const std::string& filepath);
+
+		// Publishes decoded loads and starts queued ones while below s_MaxConcurrentLoads
+		static void ProcessLoadQueues();
+		static Ref<AssetLoadRequest> RequestAsyncLoad(AssetHandle assetHandle, AssetLoadPriority priority);
+		static void StartAsyncLoad(Ref<AssetLoadRequest> request);
+		static void CompleteAsyncLoad(Ref<AssetLoadRequest> request);
+		static bool FinishAsyncLoad(AssetHandle assetHandle);
+
+		// Reloads are decoded like async loads, the old instance stays in use until the new one is ready
+		static void ProcessPendingReloads();
+		static void ReloadAsset(AssetHandle assetHandle);
+		static void CompleteReload(Ref<AssetLoadRequest> request);
+		static void RegisterDependencies(const Ref<Asset>& asset);
+		static void UnregisterDependencies(AssetHandle assetHandle);
+
+		// Residency is tracked for every asset whose data is loaded, in s_AssetResidency and the per type stats
+		static void TouchAsset(const Ref<Asset>& asset);
+		static void TrackResidency(const Ref<Asset>& asset);
+		static void UntrackResidency(AssetHandle assetHandle);
+		static void EvictUnusedAssets();
+		static void EvictAsset(AssetHandle assetHandle);
+
 	private:
 		static std::unordered_map<AssetHandle, Ref<Asset>> s_LoadedAssets;
+		static std::unordered_map<std::string, AssetHandle> s_AssetPathIndex; // Normalized file path -> handle, for every loaded asset
 		static std::unordered_map<std::string, AssetMetadata> s_AssetRegistry;
 		static AssetsChangeEventFn s_AssetsChangeCallback;
+
+		static std::unordered_map<AssetHandle, Ref<AssetLoadRequest>> s_LoadRequests; // Queued or in flight
+		static std::array<std::deque<Ref<AssetLoadRequest>>, (size_t)AssetLoadPriority::Count> s_LoadQueues;
+		static std::vector<Ref<AssetLoadRequest>> s_InFlightLoads;
+		static uint32_t s_MaxConcurrentLoads;
+		static std::unordered_map<AssetType, Ref<Asset>> s_PlaceholderAssets;
+
+		static std::unordered_map<AssetHandle, Ref<AssetLoadRequest>> s_ReloadRequests; // In flight
+		static std::unordered_map<std::string, std::vector<AssetHandle>> s_AssetDependents; // File path -> assets built from it
+		static std::unordered_map<AssetHandle, std::vector<std::string>> s_AssetDependencies;
+		static std::vector<AssetReloadedFn> s_AssetReloadCallbacks;
+
+		static std::unordered_map<AssetHandle, AssetResidency> s_AssetResidency;
+		static std::unordered_map<AssetType, AssetTypeMemoryStats> s_MemoryStats;
+		static std::unordered_set<AssetHandle> s_EvictedAssets; // Not loaded again since
+		static AssetMemoryUsage s_ResidentMemory;
+		static uint64_t s_CPUMemoryBudget, s_GPUMemoryBudget;
+		static uint64_t s_FrameIndex;
+	};
+
+	// Result of AssetManager::GetAssetAsync
+	template<typename T>
+	class AsyncAsset
+	{
+	public:
+		AsyncAsset() = default;
+		AsyncAsset(AssetHandle handle, const Ref<AssetLoadRequest>& request)
+			: m_Handle(handle), m_Request(request) {}
+
+		bool IsReady() const { return !m_Request || m_Request->IsDone(); }
+		bool Failed() const { return m_Request && m_Request->State.load(std::memory_order_acquire) == AssetLoadState::Failed; }
+
+		// The loaded asset once ready, the placeholder for its type until then
+		Ref<T> Get() const
+		{
+			if (!AssetManager::IsAssetHandleValid(m_Handle))
+				return nullptr;
+
+			Ref<Asset> asset = AssetManager::GetAsset<Asset>(m_Handle, false);
+			if (!IsReady())
+				return AssetManager::GetPlaceholderAsset(asset->Type).As<T>();
+
+			// Counts as a use of the asset, and loads it again if it was evicted since
+			if (!Failed())
+				return AssetManager::GetAsset<T>(m_Handle);
+
+			return asset.As<T>();
+		}
+
+		AssetHandle GetHandle() const { return m_Handle; }
+	private:
+		AssetHandle m_Handle = 0;
+		Ref<AssetLoadRequest> m_Request;
 	};
 
 }
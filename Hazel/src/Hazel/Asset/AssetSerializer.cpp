@@ -2,6 +2,7 @@
 #include "AssetSerializer.h"
 #include "Hazel/Utilities/StringUtils.h"
 #include "Hazel/Utilities/FileSystem.h"
+#include "Hazel/Utilities/VirtualFileSystem.h"
 #include "Hazel/Renderer/Mesh.h"
 #include "Hazel/Renderer/SceneRenderer.h"
 
@@ -67,15 +68,12 @@ namespace Hazel {
 
 	bool PhysicsMaterialSerializer::TryLoadData(Ref<Asset>& asset) const
 	{
-		std::ifstream stream(asset->FilePath);
-		if (!stream.is_open())
+		FileView file;
+		if (!VirtualFileSystem::ReadFile(asset->FilePath, file))
 			return false;
 
 		Ref<Asset> temp = asset;
-		std::stringstream strStream;
-		strStream << stream.rdbuf();
-
-		YAML::Node data = YAML::Load(strStream.str());
+		YAML::Node data = YAML::Load(std::string(file.GetString()));
 
 		float staticFriction = data["StaticFriction"].as<float>();
 		float dynamicFriction = data["DynamicFriction"].as<float>();
@@ -0,0 +1,439 @@
+#include "hzpch.h"
+#include "DerivedDataCache.h"
+
+#include "Hazel/Utilities/FileSystem.h"
+#include "Hazel/Utilities/VirtualFileSystem.h"
+
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+namespace Hazel {
+
+	static const char* s_DerivedDataCacheDirectory = "assets/cache/ddc/";
+
+	static constexpr char s_EntryMagic[4] = { 'H', 'D', 'D', 'C' };
+	static constexpr uint32_t s_EntryVersion = 1;
+
+	struct DerivedDataEntryHeader
+	{
+		char Magic[4];
+		uint32_t Version;
+		uint64_t Key;
+		uint64_t Size;
+	};
+
+	struct DerivedDataEntry
+	{
+		uint64_t Size = 0; // Including the header
+		std::filesystem::file_time_type LastAccess;
+	};
+
+	struct DerivedDataCacheData
+	{
+		std::mutex Mutex;
+		std::unordered_map<std::string, DerivedDataEntry> Entries; // By path
+		uint64_t SizeBudget = 0;
+		DerivedDataCacheStats Stats;
+	};
+
+	static DerivedDataCacheData* s_Data = nullptr;
+
+	static std::string GetEntryPath(const DerivedDataKey& key)
+	{
+		char filename[32];
+		sprintf(filename, "/%016llx.ddc", (unsigned long long)key.GetHash());
+		return s_DerivedDataCacheDirectory + key.GetBucket() + filename;
+	}
+
+	// Expects the lock to be held
+	static void EvictEntries(const std::string& keepPath)
+	{
+		if (s_Data->Stats.TotalSize <= s_Data->SizeBudget)
+			return;
+
+		std::vector<std::pair<std::filesystem::file_time_type, std::string>> entries;
+		entries.reserve(s_Data->Entries.size());
+		for (auto& [path, entry] : s_Data->Entries)
+		{
+			if (path != keepPath)
+				entries.emplace_back(entry.LastAccess, path);
+		}
+		std::sort(entries.begin(), entries.end());
+
+		// Leave some headroom so the next few writes don't evict again straight away
+		uint64_t targetSize = s_Data->SizeBudget - s_Data->SizeBudget / 10;
+		for (auto& [lastAccess, path] : entries)
+		{
+			if (s_Data->Stats.TotalSize <= targetSize)
+				break;
+
+			std::error_code error;
+			std::filesystem::remove(path, error);
+
+			s_Data->Stats.TotalSize -= s_Data->Entries.at(path).Size;
+			s_Data->Stats.Evictions++;
+			s_Data->Entries.erase(path);
+		}
+
+		s_Data->Stats.EntryCount = (uint32_t)s_Data->Entries.size();
+	}
+
+	DerivedDataKey::DerivedDataKey(const std::string& bucket)
+		: m_Bucket(bucket), m_Hash(DerivedDataCache::Hash(bucket.data(), bucket.size()))
+	{
+	}
+
+	DerivedDataKey& DerivedDataKey::Add(const void* data, size_t size)
+	{
+		m_Hash = DerivedDataCache::Hash(data, size, m_Hash);
+		return *this;
+	}
+
+	DerivedDataKey& DerivedDataKey::Add(const std::string& string)
+	{
+		return Add(string.data(), string.size());
+	}
+
+	DerivedDataKey& DerivedDataKey::Add(const char* string)
+	{
+		return Add(string, strlen(string));
+	}
+
+	DerivedDataKey& DerivedDataKey::AddFile(const std::string& filepath)
+	{
+		m_Hash = DerivedDataCache::HashFile(filepath, m_Hash);
+		return *this;
+	}
+
+	void DerivedDataCache::Init(uint64_t sizeBudget)
+	{
+		HZ_CORE_ASSERT(!s_Data, "DerivedDataCache already initialized!");
+
+		s_Data = new DerivedDataCacheData();
+		s_Data->SizeBudget = sizeBudget;
+
+		std::error_code error;
+		std::filesystem::create_directories(s_DerivedDataCacheDirectory, error);
+
+		// Write times double as access times, so the LRU order carries over between sessions
+		for (auto& directoryEntry : std::filesystem::recursive_directory_iterator(s_DerivedDataCacheDirectory, error))
+		{
+			if (!directoryEntry.is_regular_file())
+				continue;
+
+			std::string path = directoryEntry.path().generic_string();
+			if (directoryEntry.path().extension() != ".ddc")
+			{
+				// Left behind by an interrupted write
+				std::filesystem::remove(directoryEntry.path(), error);
+				continue;
+			}
+
+			DerivedDataEntry& entry = s_Data->Entries[path];
+			entry.Size = directoryEntry.file_size();
+			entry.LastAccess = directoryEntry.last_write_time();
+			s_Data->Stats.TotalSize += entry.Size;
+		}
+
+		s_Data->Stats.EntryCount = (uint32_t)s_Data->Entries.size();
+		EvictEntries({});
+
+		HZ_CORE_INFO("Derived data cache: {0} entries, {1:.2f} MB", s_Data->Stats.EntryCount, s_Data->Stats.TotalSize / (1024.0 * 1024.0));
+	}
+
+	void DerivedDataCache::Shutdown()
+	{
+		if (!s_Data)
+			return;
+
+		const DerivedDataCacheStats& stats = s_Data->Stats;
+		HZ_CORE_INFO("Derived data cache: {0} hits, {1} misses, {2} writes, {3} evictions", stats.Hits, stats.Misses, stats.Writes, stats.Evictions);
+
+		delete s_Data;
+		s_Data = nullptr;
+	}
+
+	bool DerivedDataCache::Get(const DerivedDataKey& key, Buffer& outData)
+	{
+		HZ_CORE_ASSERT(s_Data, "DerivedDataCache not initialized!");
+
+		std::string path = GetEntryPath(key);
+
+		// Entries shipped in a pak archive aren't on disk, so they're never indexed
+		bool found = false;
+		{
+			std::lock_guard<std::mutex> lock(s_Data->Mutex);
+			found = s_Data->Entries.find(path) != s_Data->Entries.end();
+		}
+
+		FileView file;
+		if (found || VirtualFileSystem::HasMountedArchives())
+			found = VirtualFileSystem::ReadFile(path, file);
+
+		if (!found)
+		{
+			std::lock_guard<std::mutex> lock(s_Data->Mutex);
+			s_Data->Stats.Misses++;
+			return false;
+		}
+
+		DerivedDataEntryHeader header;
+		bool valid = file.GetSize() >= sizeof(header);
+		if (valid)
+		{
+			memcpy(&header, file.GetData(), sizeof(header));
+			valid = memcmp(header.Magic, s_EntryMagic, sizeof(s_EntryMagic)) == 0
+				&& header.Version == s_EntryVersion
+				&& header.Key == key.GetHash()
+				&& header.Size == file.GetSize() - sizeof(header)
+				&& header.Size <= std::numeric_limits<uint32_t>::max();
+		}
+
+		if (valid)
+		{
+			outData.Allocate((uint32_t)header.Size);
+			outData.Size = (uint32_t)header.Size;
+			if (header.Size)
+				memcpy(outData.Data, file.GetData() + sizeof(header), header.Size);
+		}
+		// Loose entries stay mapped until released, which would keep them from being removed or replaced
+		file.Release();
+
+		std::lock_guard<std::mutex> lock(s_Data->Mutex);
+		auto it = s_Data->Entries.find(path);
+		if (!valid)
+		{
+			HZ_CORE_WARN("Discarding corrupt derived data entry {0}", path);
+
+			if (it != s_Data->Entries.end())
+			{
+				std::error_code error;
+				std::filesystem::remove(path, error);
+
+				s_Data->Stats.TotalSize -= it->second.Size;
+				s_Data->Entries.erase(it);
+				s_Data->Stats.EntryCount = (uint32_t)s_Data->Entries.size();
+			}
+
+			s_Data->Stats.Misses++;
+			return false;
+		}
+
+		if (it != s_Data->Entries.end())
+		{
+			std::error_code error;
+			it->second.LastAccess = std::filesystem::file_time_type::clock::now();
+			std::filesystem::last_write_time(path, it->second.LastAccess, error);
+		}
+
+		s_Data->Stats.Hits++;
+		s_Data->Stats.BytesRead += header.Size;
+		return true;
+	}
+
+	void DerivedDataCache::GetEntryPaths(std::vector<std::string>& outPaths)
+	{
+		HZ_CORE_ASSERT(s_Data, "DerivedDataCache not initialized!");
+
+		std::lock_guard<std::mutex> lock(s_Data->Mutex);
+		outPaths.reserve(outPaths.size() + s_Data->Entries.size());
+		for (auto& [path, entry] : s_Data->Entries)
+			outPaths.push_back(path);
+	}
+
+	void DerivedDataCache::Put(const DerivedDataKey& key, const void* data, uint64_t size)
+	{
+		HZ_CORE_ASSERT(s_Data, "DerivedDataCache not initialized!");
+
+		std::string path = GetEntryPath(key);
+
+		DerivedDataEntryHeader header;
+		memcpy(header.Magic, s_EntryMagic, sizeof(s_EntryMagic));
+		header.Version = s_EntryVersion;
+		header.Key = key.GetHash();
+		header.Size = size;
+
+		std::error_code error;
+		std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+
+		// Several jobs can produce the same entry at once, each writes its own temp file and the rename decides the winner
+		std::string tempPath = path + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+		{
+			std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+			stream.write((const char*)&header, sizeof(header));
+			stream.write((const char*)data, size);
+			if (!stream)
+			{
+				HZ_CORE_ERROR("Failed to write derived data entry {0}", path);
+				stream.close();
+				std::filesystem::remove(tempPath, error);
+				return;
+			}
+		}
+
+		std::filesystem::rename(tempPath, path, error);
+		if (error)
+		{
+			HZ_CORE_ERROR("Failed to write derived data entry {0}: {1}", path, error.message());
+			std::filesystem::remove(tempPath, error);
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(s_Data->Mutex);
+		DerivedDataEntry& entry = s_Data->Entries[path];
+		s_Data->Stats.TotalSize -= entry.Size;
+		entry.Size = sizeof(header) + size;
+		entry.LastAccess = std::filesystem::file_time_type::clock::now();
+		s_Data->Stats.TotalSize += entry.Size;
+		s_Data->Stats.EntryCount = (uint32_t)s_Data->Entries.size();
+		s_Data->Stats.Writes++;
+		s_Data->Stats.BytesWritten += size;
+
+		EvictEntries(path);
+	}
+
+	void DerivedDataCache::Remove(const DerivedDataKey& key)
+	{
+		HZ_CORE_ASSERT(s_Data, "DerivedDataCache not initialized!");
+
+		std::string path = GetEntryPath(key);
+
+		std::lock_guard<std::mutex> lock(s_Data->Mutex);
+		auto it = s_Data->Entries.find(path);
+		if (it == s_Data->Entries.end())
+			return;
+
+		std::error_code error;
+		std::filesystem::remove(path, error);
+
+		s_Data->Stats.TotalSize -= it->second.Size;
+		s_Data->Entries.erase(it);
+		s_Data->Stats.EntryCount = (uint32_t)s_Data->Entries.size();
+	}
+
+	void DerivedDataCache::SetSizeBudget(uint64_t sizeBudget)
+	{
+		std::lock_guard<std::mutex> lock(s_Data->Mutex);
+		s_Data->SizeBudget = sizeBudget;
+		EvictEntries({});
+	}
+
+	uint64_t DerivedDataCache::GetSizeBudget()
+	{
+		return s_Data->SizeBudget;
+	}
+
+	DerivedDataCacheStats DerivedDataCache::GetStats()
+	{
+		std::lock_guard<std::mutex> lock(s_Data->Mutex);
+		return s_Data->Stats;
+	}
+
+	static constexpr uint64_t s_Prime1 = 0x9E3779B185EBCA87ull;
+	static constexpr uint64_t s_Prime2 = 0xC2B2AE3D27D4EB4Full;
+	static constexpr uint64_t s_Prime3 = 0x165667B19E3779F9ull;
+	static constexpr uint64_t s_Prime4 = 0x85EBCA77C2B2AE63ull;
+	static constexpr uint64_t s_Prime5 = 0x27D4EB2F165667C5ull;
+
+	static uint64_t RotateLeft(uint64_t value, int bits)
+	{
+		return (value << bits) | (value >> (64 - bits));
+	}
+
+	static uint64_t Read64(const uint8_t* data)
+	{
+		uint64_t value;
+		memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	static uint32_t Read32(const uint8_t* data)
+	{
+		uint32_t value;
+		memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	static uint64_t HashRound(uint64_t accumulator, uint64_t input)
+	{
+		accumulator += input * s_Prime2;
+		accumulator = RotateLeft(accumulator, 31);
+		return accumulator * s_Prime1;
+	}
+
+	static uint64_t HashMergeRound(uint64_t accumulator, uint64_t value)
+	{
+		accumulator ^= HashRound(0, value);
+		return accumulator * s_Prime1 + s_Prime4;
+	}
+
+	uint64_t DerivedDataCache::Hash(const void* data, size_t size, uint64_t seed)
+	{
+		const uint8_t* p = (const uint8_t*)data;
+		const uint8_t* end = p + size;
+
+		uint64_t hash;
+		if (size >= 32)
+		{
+			uint64_t v1 = seed + s_Prime1 + s_Prime2;
+			uint64_t v2 = seed + s_Prime2;
+			uint64_t v3 = seed;
+			uint64_t v4 = seed - s_Prime1;
+
+			for (; p + 32 <= end; p += 32)
+			{
+				v1 = HashRound(v1, Read64(p));
+				v2 = HashRound(v2, Read64(p + 8));
+				v3 = HashRound(v3, Read64(p + 16));
+				v4 = HashRound(v4, Read64(p + 24));
+			}
+
+			hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+			hash = HashMergeRound(hash, v1);
+			hash = HashMergeRound(hash, v2);
+			hash = HashMergeRound(hash, v3);
+			hash = HashMergeRound(hash, v4);
+		}
+		else
+		{
+			hash = seed + s_Prime5;
+		}
+
+		hash += (uint64_t)size;
+
+		for (; p + 8 <= end; p += 8)
+		{
+			hash ^= HashRound(0, Read64(p));
+			hash = RotateLeft(hash, 27) * s_Prime1 + s_Prime4;
+		}
+
+		if (p + 4 <= end)
+		{
+			hash ^= (uint64_t)Read32(p) * s_Prime1;
+			hash = RotateLeft(hash, 23) * s_Prime2 + s_Prime3;
+			p += 4;
+		}
+
+		for (; p < end; p++)
+		{
+			hash ^= (uint64_t)(*p) * s_Prime5;
+			hash = RotateLeft(hash, 11) * s_Prime1;
+		}
+
+		hash ^= hash >> 33;
+		hash *= s_Prime2;
+		hash ^= hash >> 29;
+		hash *= s_Prime3;
+		hash ^= hash >> 32;
+		return hash;
+	}
+
+	uint64_t DerivedDataCache::HashFile(const std::string& filepath, uint64_t seed)
+	{
+		FileView file;
+		VirtualFileSystem::ReadFile(filepath, file);
+		return Hash(file.GetData(), file.GetSize(), seed);
+	}
+
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Hazel/Core/Buffer.h"
+
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Hazel {
+
+	// Identifies a piece of derived data: the bytes it was built from plus every parameter that affects the build.
+	// Anything that changes the output has to be added, otherwise stale entries will be handed out.
+	class DerivedDataKey
+	{
+	public:
+		explicit DerivedDataKey(const std::string& bucket);
+
+		DerivedDataKey& Add(const void* data, size_t size);
+		DerivedDataKey& Add(const std::string& string);
+		DerivedDataKey& Add(const char* string);
+
+		template<typename T>
+		DerivedDataKey& Add(const T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Only plain values can be hashed directly");
+			return Add(&value, sizeof(T));
+		}
+
+		// Hashes the file's contents, not its path or timestamp
+		DerivedDataKey& AddFile(const std::string& filepath);
+
+		const std::string& GetBucket() const { return m_Bucket; }
+		uint64_t GetHash() const { return m_Hash; }
+	private:
+		std::string m_Bucket;
+		uint64_t m_Hash;
+	};
+
+	struct DerivedDataCacheStats
+	{
+		uint64_t Hits = 0;
+		uint64_t Misses = 0;
+		uint64_t Writes = 0;
+		uint64_t Evictions = 0;
+		uint64_t BytesRead = 0;
+		uint64_t BytesWritten = 0;
+
+		uint64_t TotalSize = 0;
+		uint32_t EntryCount = 0;
+	};
+
+	// Content-addressed store for data derived from assets (compiled shaders, cooked meshes and colliders),
+	// kept under assets/cache/ddc and read through the VirtualFileSystem, so entries shipped in a pak archive
+	// are found too. Entries are never invalidated explicitly: a changed source or build parameter produces
+	// a new key, and old entries are evicted least recently used first once the cache grows past its size
+	// budget. Safe to use from any thread.
+	class DerivedDataCache
+	{
+	public:
+		static void Init(uint64_t sizeBudget = 2ull * 1024 * 1024 * 1024);
+		static void Shutdown();
+
+		// outData is allocated on a hit and has to be released by the caller
+		static bool Get(const DerivedDataKey& key, Buffer& outData);
+		static void Put(const DerivedDataKey& key, const void* data, uint64_t size);
+		static void Remove(const DerivedDataKey& key);
+
+		// Every entry currently on disk, e.g. to ship with the assets they were derived from
+		static void GetEntryPaths(std::vector<std::string>& outPaths);
+
+		static void SetSizeBudget(uint64_t sizeBudget);
+		static uint64_t GetSizeBudget();
+
+		static DerivedDataCacheStats GetStats();
+
+		// XXH64
+		static uint64_t Hash(const void* data, size_t size, uint64_t seed = 0);
+		static uint64_t HashFile(const std::string& filepath, uint64_t seed = 0);
+	};
+
+}
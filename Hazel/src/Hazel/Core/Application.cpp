@@ -10,8 +10,13 @@
 #include "Hazel/Script/ScriptEngine.h"
 #include "Hazel/Physics/Physics.h"
 #include "Hazel/Asset/AssetManager.h"
+#include "Hazel/Asset/DerivedDataCache.h"
+#include "Hazel/Scene/Scene.h"
+#include "Hazel/Utilities/VirtualFileSystem.h"
 
 #include "Input.h"
+#include "JobSystem.h"
+#include "FrameAllocator.h"
 
 #define GLFW_EXPOSE_NATIVE_WIN32
 #include <GLFW/glfw3native.h>
@@ -37,9 +42,25 @@ namespace Hazel {
 		m_Window->Maximize();
 		m_Window->SetVSync(true);
 
+		JobSystem::Init();
+
+#if defined(HZ_DIST)
+		// Shipping builds read their assets from the archive built by AssetManager::BuildAssetPak, when there is one
+		VirtualFileSystem::Mount("assets.hpak");
+#endif
+
+		// Before the renderer, shaders are compiled (or fetched) during its init
+		DerivedDataCache::Init();
+
 		// Init renderer and execute command queue to compile all shaders
-		Renderer::Init();
+		RendererConfig rendererConfig;
+		rendererConfig.Threading = props.RenderThreadPolicy;
+		rendererConfig.FrameLatency = props.RenderFrameLatency;
+		Renderer::Init(rendererConfig);
 		Renderer::WaitAndRender();
+
+		// One arena per frame the render thread can have in flight
+		FrameAllocator::Init(Renderer::GetRenderThread().GetQueueCount());
 		
 		m_ImGuiLayer = ImGuiLayer::Create();
 		PushOverlay(m_ImGuiLayer);
@@ -48,10 +69,17 @@ namespace Hazel {
 		Physics::Init();
 
 		AssetManager::Init();
+		AssetManager::AddAssetReloadCallback(Scene::OnAssetReloaded);
+
+		// ImGui's setup registers GLFW callbacks, so everything submitted so far has to run on the main thread
+		Renderer::WaitAndRender();
+		Renderer::StartRenderThread();
 	}
 
 	Application::~Application()
 	{
+		Renderer::GetRenderThread().BlockUntilRenderComplete();
+
 		for (Layer* layer : m_LayerStack)
 		{
 			layer->OnDetach();
@@ -59,6 +87,9 @@ namespace Hazel {
 		}
 
 		FramebufferPool::GetGlobal()->GetAll().clear();
+
+		// Every frame has been executed, drop what the frames kept alive while the renderer can still free it
+		FrameAllocator::Shutdown();
 		
 		Physics::Shutdown();
 		ScriptEngine::Shutdown();
@@ -66,6 +97,10 @@ namespace Hazel {
 
 		Renderer::WaitAndRender();
 		Renderer::Shutdown();
+
+		DerivedDataCache::Shutdown();
+		JobSystem::Shutdown();
+		VirtualFileSystem::UnmountAll();
 	}
 
 	void Application::PushLayer(Layer* layer)
@@ -91,6 +126,25 @@ namespace Hazel {
 		ImGui::Separator();
 		ImGui::Text("Frame Time: %.2fms\n", m_TimeStep.GetMilliseconds());
 
+		RenderThread& renderThread = Renderer::GetRenderThread();
+		if (renderThread.IsRunning())
+		{
+			ImGui::Text("Render Thread: %.2fms (%u frame latency)", renderThread.GetExecuteMillis(), renderThread.GetFrameLatency());
+			ImGui::Text("Main Thread Wait: %.2fms", renderThread.GetWaitMillis());
+		}
+		else
+		{
+			ImGui::Text("Render Thread: disabled");
+		}
+
+		const FrameAllocatorStats& frameAllocatorStats = FrameAllocator::GetLastFrameStats();
+		std::string frameBytes = Utils::BytesToString(frameAllocatorStats.BytesAllocated);
+		ImGui::Text("Frame Allocations: %u (%s, %u blocks)", frameAllocatorStats.Allocations, frameBytes.c_str(), frameAllocatorStats.BlockCount);
+
+		DerivedDataCacheStats cacheStats = DerivedDataCache::GetStats();
+		std::string cacheSize = Utils::BytesToString(cacheStats.TotalSize);
+		ImGui::Text("Derived Data Cache: %llu hits, %llu misses (%u entries, %s)", cacheStats.Hits, cacheStats.Misses, cacheStats.EntryCount, cacheSize.c_str());
+
 		if (RendererAPI::Current() == RendererAPIType::Vulkan)
 		{
 			GPUMemoryStats memoryStats = VulkanAllocator::GetStats();
@@ -117,21 +171,21 @@ namespace Hazel {
 
 			if (!m_Minimized)
 			{
+				FrameAllocator::BeginFrame();
 				Renderer::BeginFrame();
+				AssetManager::Update();
 				//VulkanRenderer::BeginFrame();
 				for (Layer* layer : m_LayerStack)
 					layer->OnUpdate(m_TimeStep);
 			
-				// Render ImGui on render thread
-				Application* app = this;
-				Renderer::Submit([app]() { app->RenderImGui(); });
-				Renderer::Submit([=]() {m_ImGuiLayer->End(); });
+				// ImGui is built here since layers touch game state in OnImGuiRender,
+				// End() submits the resulting draw data to the render thread
+				RenderImGui();
+				m_ImGuiLayer->End();
 				Renderer::EndFrame();
 
-				// On Render thread
-				m_Window->GetRenderContext()->BeginFrame();
-				Renderer::WaitAndRender();
-				m_Window->SwapBuffers();
+				// Executed (and presented) by the render thread while the next frame is recorded
+				Renderer::GetRenderThread().Kick(true);
 			}
 
 			float time = GetTime();
@@ -172,7 +226,9 @@ namespace Hazel {
 			return false;
 		}
 		m_Minimized = false;
-		
+
+		// The swapchain can't be recreated while the render thread is presenting
+		Renderer::GetRenderThread().BlockUntilRenderComplete();
 		m_Window->GetRenderContext()->OnResize(width, height);
 
 		auto& fbs = FramebufferPool::GetGlobal()->GetAll();
@@ -9,12 +9,17 @@
 
 #include "Hazel/ImGui/ImGuiLayer.h"
 
+#include "Hazel/Renderer/RenderThread.h"
+
 namespace Hazel {
 
 	struct ApplicationProps
 	{
 		std::string Name;
 		uint32_t WindowWidth, WindowHeight;
+
+		ThreadingPolicy RenderThreadPolicy = ThreadingPolicy::SingleThreaded; // OpenGL always runs SingleThreaded
+		uint32_t RenderFrameLatency = 1; // Frames the main thread may run ahead of the render thread
 	};
 
 	class Application
@@ -0,0 +1,144 @@
+#include "hzpch.h"
+#include "FrameAllocator.h"
+
+#include <new>
+#include <thread>
+
+namespace Hazel {
+
+	struct FrameArena
+	{
+		struct Block
+		{
+			uint8_t* Data = nullptr;
+			size_t Size = 0;
+		};
+
+		std::vector<Block> Blocks;
+		uint32_t CurrentBlock = 0;
+		size_t Offset = 0;
+
+		// References held by KeepAlive, living in the arena's own blocks
+		std::vector<std::pair<void*, void(*)(void*)>> Releases;
+
+		FrameAllocatorStats Stats;
+	};
+
+	struct FrameAllocatorData
+	{
+		std::vector<FrameArena> Arenas; // One per frame in flight
+		uint32_t CurrentArena = 0;
+		size_t BlockSize = 0;
+
+		FrameAllocatorStats LastFrameStats;
+		std::thread::id MainThread;
+	};
+
+	static FrameAllocatorData* s_Data = nullptr;
+
+	static constexpr size_t BlockAlignment = 64;
+
+	static size_t AlignOffset(size_t offset, size_t alignment)
+	{
+		return (offset + alignment - 1) & ~(alignment - 1);
+	}
+
+	static void ReleaseKeptAlive(FrameArena& arena)
+	{
+		for (auto& [object, release] : arena.Releases)
+			release(object);
+		arena.Releases.clear();
+	}
+
+	void FrameAllocator::Init(uint32_t frameCount, size_t blockSize)
+	{
+		HZ_CORE_ASSERT(!s_Data, "FrameAllocator already initialized!");
+		HZ_CORE_ASSERT(frameCount > 0);
+
+		s_Data = new FrameAllocatorData();
+		s_Data->Arenas.resize(frameCount);
+		s_Data->BlockSize = blockSize;
+		s_Data->MainThread = std::this_thread::get_id();
+	}
+
+	void FrameAllocator::Shutdown()
+	{
+		if (!s_Data)
+			return;
+
+		for (auto& arena : s_Data->Arenas)
+		{
+			ReleaseKeptAlive(arena);
+			for (auto& block : arena.Blocks)
+				::operator delete(block.Data, std::align_val_t(BlockAlignment));
+		}
+
+		delete s_Data;
+		s_Data = nullptr;
+	}
+
+	void FrameAllocator::BeginFrame()
+	{
+		HZ_CORE_ASSERT(s_Data, "FrameAllocator not initialized!");
+
+		s_Data->LastFrameStats = s_Data->Arenas[s_Data->CurrentArena].Stats;
+		s_Data->CurrentArena = (s_Data->CurrentArena + 1) % (uint32_t)s_Data->Arenas.size();
+
+		// Keeps all blocks, a frame that needed more than one will likely need them again
+		FrameArena& arena = s_Data->Arenas[s_Data->CurrentArena];
+		ReleaseKeptAlive(arena);
+		arena.CurrentBlock = 0;
+		arena.Offset = 0;
+		arena.Stats = {};
+		arena.Stats.BlockCount = arena.Blocks.empty() ? 0 : 1;
+	}
+
+	void* FrameAllocator::Allocate(size_t size, size_t alignment)
+	{
+		HZ_CORE_ASSERT(s_Data, "FrameAllocator not initialized!");
+		HZ_CORE_ASSERT(std::this_thread::get_id() == s_Data->MainThread, "FrameAllocator can only be used on the main thread!");
+		HZ_CORE_ASSERT(alignment <= BlockAlignment && (alignment & (alignment - 1)) == 0, "Unsupported alignment!");
+
+		FrameArena& arena = s_Data->Arenas[s_Data->CurrentArena];
+		arena.Stats.Allocations++;
+		arena.Stats.BytesAllocated += size;
+
+		size_t offset = AlignOffset(arena.Offset, alignment);
+		while (arena.CurrentBlock >= arena.Blocks.size() || offset + size > arena.Blocks[arena.CurrentBlock].Size)
+		{
+			// Move on to the next block, reusing blocks from earlier frames before allocating new ones
+			if (arena.CurrentBlock < arena.Blocks.size() && !arena.Blocks.empty())
+				arena.CurrentBlock++;
+
+			if (arena.CurrentBlock >= arena.Blocks.size())
+			{
+				FrameArena::Block block;
+				block.Size = std::max(s_Data->BlockSize, AlignOffset(size, BlockAlignment));
+				block.Data = (uint8_t*)::operator new(block.Size, std::align_val_t(BlockAlignment));
+				arena.Blocks.push_back(block);
+			}
+
+			arena.Stats.BlockCount = arena.CurrentBlock + 1;
+			offset = 0;
+		}
+
+		arena.Offset = offset + size;
+		return arena.Blocks[arena.CurrentBlock].Data + offset;
+	}
+
+	void FrameAllocator::AddRelease(void* object, void(*release)(void*))
+	{
+		s_Data->Arenas[s_Data->CurrentArena].Releases.emplace_back(object, release);
+	}
+
+	const FrameAllocatorStats& FrameAllocator::GetStats()
+	{
+		return s_Data->Arenas[s_Data->CurrentArena].Stats;
+	}
+
+	const FrameAllocatorStats& FrameAllocator::GetLastFrameStats()
+	{
+		return s_Data->LastFrameStats;
+	}
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Hazel/Core/Ref.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Hazel {
+
+	struct FrameAllocatorStats
+	{
+		uint32_t Allocations = 0;
+		uint64_t BytesAllocated = 0;
+		uint32_t BlockCount = 0;
+	};
+
+	// Bump allocator for data that only lives for one frame. Memory allocated during a frame stays valid
+	// until the render thread has executed that frame, after which it is reused without being freed.
+	// Destructors are never run: use it for trivially destructible data, or clear containers before the frame ends.
+	// KeepAlive is the exception, those references are released when the frame's arena is recycled.
+	// Main thread only.
+	class FrameAllocator
+	{
+	public:
+		// frameCount is how many frames can be in flight at once, i.e. the render thread's queue count
+		static void Init(uint32_t frameCount, size_t blockSize = 4 * 1024 * 1024);
+		static void Shutdown();
+
+		// Switches to the arena of the oldest frame, which has finished rendering by now
+		static void BeginFrame();
+
+		static void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		template<typename T>
+		static T* AllocateArray(size_t count)
+		{
+			return (T*)Allocate(count * sizeof(T), alignof(T));
+		}
+
+		// Holds a reference until the render thread has executed this frame, so render commands can capture
+		// the returned raw pointer instead of copying the Ref
+		template<typename T>
+		static T* KeepAlive(const Ref<T>& object)
+		{
+			if (!object)
+				return nullptr;
+
+			Ref<T>* reference = new (Allocate(sizeof(Ref<T>), alignof(Ref<T>))) Ref<T>(object);
+			AddRelease(reference, [](void* reference) { ((Ref<T>*)reference)->~Ref<T>(); });
+			return reference->Raw();
+		}
+
+		static const FrameAllocatorStats& GetStats();
+		static const FrameAllocatorStats& GetLastFrameStats();
+	private:
+		static void AddRelease(void* object, void(*release)(void*));
+	};
+
+	// Standard allocator on top of the FrameAllocator for frame-scoped containers
+	template<typename T>
+	struct FrameStdAllocator
+	{
+		using value_type = T;
+
+		FrameStdAllocator() = default;
+
+		template<typename U>
+		FrameStdAllocator(const FrameStdAllocator<U>&) {}
+
+		T* allocate(size_t count) { return FrameAllocator::AllocateArray<T>(count); }
+		void deallocate(T*, size_t) {} // Released with the frame
+
+		template<typename U>
+		bool operator==(const FrameStdAllocator<U>&) const { return true; }
+		template<typename U>
+		bool operator!=(const FrameStdAllocator<U>&) const { return false; }
+	};
+
+	// Has to be recreated (not just cleared) every frame, its storage belongs to the frame it was allocated in
+	template<typename T>
+	using FrameVector = std::vector<T, FrameStdAllocator<T>>;
+
+}
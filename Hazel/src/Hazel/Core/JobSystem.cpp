@@ -0,0 +1,304 @@
+#include "hzpch.h"
+#include "JobSystem.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Hazel {
+
+	struct Job
+	{
+		JobFunc Func;
+		JobCounter* Counter = nullptr;
+		JobPriority Priority = JobPriority::High;
+	};
+
+	struct JobQueue
+	{
+		std::mutex Mutex;
+		std::deque<Job> Jobs[(size_t)JobPriority::Count];
+	};
+
+	struct JobSystemData
+	{
+		std::vector<std::thread> Workers;
+		std::vector<std::unique_ptr<JobQueue>> Queues; // One per worker
+
+		std::mutex WakeMutex;
+		std::condition_variable WakeCondition;
+		std::atomic<uint32_t> QueuedJobs = 0;
+		std::atomic<uint32_t> NextQueue = 0;
+		std::atomic<bool> Running = false;
+	};
+
+	static JobSystemData* s_Data = nullptr;
+	static thread_local int32_t s_WorkerIndex = -1;
+	// Priority of the job the calling thread is executing, High outside of jobs
+	static thread_local JobPriority s_CurrentPriority = JobPriority::High;
+
+	static void ExecuteJob(Job& job)
+	{
+		JobPriority previousPriority = s_CurrentPriority;
+		s_CurrentPriority = job.Priority;
+		job.Func();
+		s_CurrentPriority = previousPriority;
+
+		if (job.Counter)
+			job.Counter->Value.fetch_sub(1, std::memory_order_acq_rel);
+	}
+
+	static bool PopJob(uint32_t queueIndex, JobPriority priority, bool steal, Job& outJob)
+	{
+		JobQueue& queue = *s_Data->Queues[queueIndex];
+		std::lock_guard<std::mutex> lock(queue.Mutex);
+		std::deque<Job>& jobs = queue.Jobs[(size_t)priority];
+		if (jobs.empty())
+			return false;
+
+		if (steal)
+		{
+			outJob = std::move(jobs.front());
+			jobs.pop_front();
+		}
+		else
+		{
+			outJob = std::move(jobs.back());
+			jobs.pop_back();
+		}
+
+		s_Data->QueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	// Runs one job of at most lowestPriority from the calling thread's own queue, or stolen from another one
+	static bool TryExecuteJob(JobPriority lowestPriority)
+	{
+		uint32_t queueCount = (uint32_t)s_Data->Queues.size();
+		uint32_t start = s_WorkerIndex >= 0 ? (uint32_t)s_WorkerIndex : 0;
+
+		Job job;
+		for (uint32_t priority = 0; priority <= (uint32_t)lowestPriority; priority++)
+		{
+			if (s_WorkerIndex >= 0 && PopJob(start, (JobPriority)priority, false, job))
+			{
+				ExecuteJob(job);
+				return true;
+			}
+
+			for (uint32_t i = 1; i <= queueCount; i++)
+			{
+				if (PopJob((start + i) % queueCount, (JobPriority)priority, true, job))
+				{
+					ExecuteJob(job);
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	// Threads waiting outside of a Low job only help with High jobs, see JobPriority
+	static bool TryExecuteJobWhileWaiting()
+	{
+		return TryExecuteJob(s_CurrentPriority);
+	}
+
+	static void WorkerThread(int32_t workerIndex)
+	{
+		s_WorkerIndex = workerIndex;
+
+		while (s_Data->Running)
+		{
+			if (TryExecuteJob(JobPriority::Low))
+				continue;
+
+			std::unique_lock<std::mutex> lock(s_Data->WakeMutex);
+			s_Data->WakeCondition.wait(lock, []() { return s_Data->QueuedJobs > 0 || !s_Data->Running; });
+		}
+	}
+
+	void JobSystem::Init(uint32_t workerCount)
+	{
+		HZ_CORE_ASSERT(!s_Data, "JobSystem already initialized!");
+
+		if (workerCount == 0)
+		{
+			uint32_t hardwareThreads = std::thread::hardware_concurrency();
+			workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+		}
+
+		s_Data = new JobSystemData();
+		s_Data->Running = true;
+
+		for (uint32_t i = 0; i < workerCount; i++)
+			s_Data->Queues.push_back(std::make_unique<JobQueue>());
+
+		for (uint32_t i = 0; i < workerCount; i++)
+			s_Data->Workers.emplace_back(WorkerThread, (int32_t)i);
+
+		HZ_CORE_INFO("JobSystem initialized with {0} worker threads", workerCount);
+	}
+
+	void JobSystem::Shutdown()
+	{
+		if (!s_Data)
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(s_Data->WakeMutex);
+			s_Data->Running = false;
+		}
+		s_Data->WakeCondition.notify_all();
+
+		for (auto& worker : s_Data->Workers)
+			worker.join();
+
+		delete s_Data;
+		s_Data = nullptr;
+	}
+
+	void JobSystem::Submit(JobFunc job, JobCounter* counter, JobPriority priority)
+	{
+		if (counter)
+			counter->Value.fetch_add(1, std::memory_order_relaxed);
+
+		if (s_CurrentPriority == JobPriority::Low)
+			priority = JobPriority::Low;
+
+		if (!s_Data)
+		{
+			Job inlineJob = { std::move(job), counter, priority };
+			ExecuteJob(inlineJob);
+			return;
+		}
+
+		// Counted before it becomes visible, otherwise a worker could pop it first and take the count below zero
+		s_Data->QueuedJobs.fetch_add(1, std::memory_order_relaxed);
+
+		// Workers push onto their own queue, other threads spread jobs across all of them
+		uint32_t queueIndex = s_WorkerIndex >= 0 ? (uint32_t)s_WorkerIndex : s_Data->NextQueue++ % (uint32_t)s_Data->Queues.size();
+		{
+			JobQueue& queue = *s_Data->Queues[queueIndex];
+			std::lock_guard<std::mutex> lock(queue.Mutex);
+			queue.Jobs[(size_t)priority].push_back({ std::move(job), counter, priority });
+		}
+
+		// Taking the wake mutex makes sure a worker can't miss the notification between checking and waiting
+		{
+			std::lock_guard<std::mutex> lock(s_Data->WakeMutex);
+		}
+		s_Data->WakeCondition.notify_one();
+	}
+
+	void JobSystem::ParallelFor(uint32_t count, uint32_t batchSize, const std::function<void(uint32_t, uint32_t)>& func)
+	{
+		if (count == 0)
+			return;
+
+		if (batchSize == 0)
+			batchSize = 1;
+
+		// Not worth the overhead for a single batch
+		if (!s_Data || count <= batchSize)
+		{
+			func(0, count);
+			return;
+		}
+
+		JobCounter counter;
+		for (uint32_t begin = batchSize; begin < count; begin += batchSize)
+		{
+			uint32_t end = std::min(begin + batchSize, count);
+			Submit([&func, begin, end]() { func(begin, end); }, &counter);
+		}
+
+		// The first batch runs on the calling thread while the workers pick up the rest
+		func(0, batchSize);
+		Wait(counter);
+	}
+
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		while (!counter.IsDone())
+		{
+			if (!s_Data || !TryExecuteJobWhileWaiting())
+				std::this_thread::yield();
+		}
+	}
+
+	void JobSystem::WaitUntil(const std::function<bool()>& condition)
+	{
+		while (!condition())
+		{
+			if (!s_Data || !TryExecuteJobWhileWaiting())
+				std::this_thread::yield();
+		}
+	}
+
+	uint32_t JobSystem::GetWorkerCount()
+	{
+		return s_Data ? (uint32_t)s_Data->Workers.size() : 0;
+	}
+
+	int32_t JobSystem::GetCurrentWorkerIndex()
+	{
+		return s_WorkerIndex;
+	}
+
+	JobGraph::JobHandle JobGraph::AddJob(JobFunc func)
+	{
+		m_Nodes.push_back({ std::move(func) });
+		return (JobHandle)m_Nodes.size() - 1;
+	}
+
+	void JobGraph::AddDependency(JobHandle job, JobHandle dependsOn)
+	{
+		HZ_CORE_ASSERT(job < m_Nodes.size() && dependsOn < m_Nodes.size(), "Invalid job handle!");
+		HZ_CORE_ASSERT(job != dependsOn, "A job can't depend on itself!");
+
+		m_Nodes[dependsOn].Dependents.push_back(job);
+		m_Nodes[job].DependencyCount++;
+	}
+
+	void JobGraph::Execute()
+	{
+		uint32_t count = (uint32_t)m_Nodes.size();
+		std::vector<std::atomic<uint32_t>> remainingDependencies(count);
+		for (uint32_t i = 0; i < count; i++)
+			remainingDependencies[i] = m_Nodes[i].DependencyCount;
+
+		JobCounter counter;
+		std::function<void(JobHandle)> submit = [&](JobHandle handle)
+		{
+			JobSystem::Submit([&, handle]()
+			{
+				m_Nodes[handle].Func();
+
+				// Dependents are submitted before this job's counter is released, so the counter
+				// can't reach zero while there is still work left in the graph
+				for (JobHandle dependent : m_Nodes[handle].Dependents)
+				{
+					if (--remainingDependencies[dependent] == 0)
+						submit(dependent);
+				}
+			}, &counter);
+		};
+
+		bool hasRoot = false;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (m_Nodes[i].DependencyCount == 0)
+			{
+				submit(i);
+				hasRoot = true;
+			}
+		}
+		HZ_CORE_ASSERT(hasRoot || count == 0, "JobGraph has a dependency cycle!");
+
+		JobSystem::Wait(counter);
+	}
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+namespace Hazel {
+
+	// Number of submitted jobs that have not finished yet; JobSystem::Wait returns once it reaches zero
+	struct JobCounter
+	{
+		std::atomic<uint32_t> Value = 0;
+
+		bool IsDone() const { return Value.load(std::memory_order_acquire) == 0; }
+	};
+
+	using JobFunc = std::function<void()>;
+
+	// High is for work someone is about to wait on (scene systems, physics tasks, parallel fors). Low is for
+	// long running background work like asset decoding: waiting threads only pick Low jobs up when they are
+	// waiting inside a Low job themselves, so a frame never stalls on a decode it doesn't need.
+	// Jobs submitted from inside a Low job are Low as well.
+	enum class JobPriority : uint8_t
+	{
+		High = 0,
+		Low,
+		Count
+	};
+
+	// Fixed pool of worker threads, each with a job deque per priority. Workers pop their own deques
+	// LIFO and steal FIFO from the others when they run dry, High jobs before Low ones.
+	class JobSystem
+	{
+	public:
+		// workerCount == 0 uses one worker per hardware thread, minus the main thread
+		static void Init(uint32_t workerCount = 0);
+		static void Shutdown();
+
+		// Runs the job inline if the job system hasn't been initialized
+		static void Submit(JobFunc job, JobCounter* counter = nullptr, JobPriority priority = JobPriority::High);
+
+		// Splits [0, count) into batches of batchSize and runs func(begin, end) for each of them
+		// across the workers. The calling thread helps and returns once every batch is done.
+		static void ParallelFor(uint32_t count, uint32_t batchSize, const std::function<void(uint32_t, uint32_t)>& func);
+
+		// Executes pending jobs on the calling thread until the counter reaches zero (see JobPriority for which)
+		static void Wait(JobCounter& counter);
+
+		// Executes pending jobs on the calling thread until the condition returns true (see JobPriority for which)
+		static void WaitUntil(const std::function<bool()>& condition);
+
+		static uint32_t GetWorkerCount();
+
+		// Index of the calling worker thread, or -1 on any other thread
+		static int32_t GetCurrentWorkerIndex();
+	};
+
+	// A set of jobs with dependencies between them. A job is submitted to the JobSystem
+	// as soon as every job it depends on has finished.
+	class JobGraph
+	{
+	public:
+		using JobHandle = uint32_t;
+
+		JobHandle AddJob(JobFunc func);
+
+		// job won't start before dependsOn has finished
+		void AddDependency(JobHandle job, JobHandle dependsOn);
+
+		// Runs every job once and blocks (helping with other jobs) until all of them are done.
+		// The graph can be executed again afterwards.
+		void Execute();
+
+		void Clear() { m_Nodes.clear(); }
+		uint32_t GetJobCount() const { return (uint32_t)m_Nodes.size(); }
+	private:
+		struct Node
+		{
+			JobFunc Func;
+			std::vector<JobHandle> Dependents;
+			uint32_t DependencyCount = 0;
+		};
+
+		std::vector<Node> m_Nodes;
+	};
+
+}
@@ -60,7 +60,7 @@ namespace Hazel {
             return true;
         }
 
-		bool IntersectsTriangle(const glm::vec3& A, const glm::vec3& B, const glm::vec3& C, float& t)
+		bool IntersectsTriangle(const glm::vec3& A, const glm::vec3& B, const glm::vec3& C, float& t) const
         {
 			glm::vec3 E1 = B - A;
 			glm::vec3 E2 = C - A;
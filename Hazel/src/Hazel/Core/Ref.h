@@ -1,24 +1,123 @@
 #pragma once
 
 #include <stdint.h>
+#include <atomic>
+#include <mutex>
+
+// Atomic refcounts make Refs safe to copy and release across threads (render thread, jobs).
+// Define as 0 to go back to plain counters where everything lives on one thread.
+#ifndef HZ_ATOMIC_REFCOUNT
+	#define HZ_ATOMIC_REFCOUNT 1
+#endif
 
 namespace Hazel {
 
+	// Created the first time a WeakRef to an object is made, and outlives the object as long as WeakRefs point to it
+	struct RefControlBlock
+	{
+		std::mutex Mutex;
+		bool Alive = true;
+		std::atomic<uint32_t> WeakCount = 1; // Number of WeakRefs, plus one held by the object while alive
+
+		void IncWeakCount() { WeakCount.fetch_add(1, std::memory_order_relaxed); }
+		void DecWeakCount()
+		{
+			if (WeakCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				delete this;
+		}
+	};
+
 	class RefCounted
 	{
 	public:
+		RefCounted() = default;
+
+		// Copies of an object start out unreferenced, the count belongs to the instance
+		RefCounted(const RefCounted&) {}
+		RefCounted& operator=(const RefCounted&) { return *this; }
+
+		~RefCounted()
+		{
+			RefControlBlock* controlBlock = m_ControlBlock.load(std::memory_order_acquire);
+			if (controlBlock)
+			{
+				// Waits for any WeakRef::Lock that is still looking at this object
+				{
+					std::lock_guard<std::mutex> lock(controlBlock->Mutex);
+					controlBlock->Alive = false;
+				}
+				controlBlock->DecWeakCount();
+			}
+		}
+
 		void IncRefCount() const
 		{
+#if HZ_ATOMIC_REFCOUNT
+			m_RefCount.fetch_add(1, std::memory_order_relaxed);
+#else
 			m_RefCount++;
+#endif
 		}
-		void DecRefCount() const
+
+		// Returns the new count, the caller deletes the object when it reaches zero
+		uint32_t DecRefCount() const
+		{
+#if HZ_ATOMIC_REFCOUNT
+			return m_RefCount.fetch_sub(1, std::memory_order_acq_rel) - 1;
+#else
+			return --m_RefCount;
+#endif
+		}
+
+		// Increments the count unless it already reached zero, i.e. the object is being destroyed
+		bool TryIncRefCount() const
+		{
+#if HZ_ATOMIC_REFCOUNT
+			uint32_t count = m_RefCount.load(std::memory_order_relaxed);
+			while (count != 0)
+			{
+				if (m_RefCount.compare_exchange_weak(count, count + 1, std::memory_order_relaxed))
+					return true;
+			}
+			return false;
+#else
+			if (m_RefCount == 0)
+				return false;
+			m_RefCount++;
+			return true;
+#endif
+		}
+
+		uint32_t GetRefCount() const
 		{
-			m_RefCount--;
+#if HZ_ATOMIC_REFCOUNT
+			return m_RefCount.load(std::memory_order_relaxed);
+#else
+			return m_RefCount;
+#endif
 		}
 
-		uint32_t GetRefCount() const { return m_RefCount; }
+		RefControlBlock* GetControlBlock() const
+		{
+			RefControlBlock* controlBlock = m_ControlBlock.load(std::memory_order_acquire);
+			if (controlBlock)
+				return controlBlock;
+
+			RefControlBlock* newBlock = new RefControlBlock();
+			if (m_ControlBlock.compare_exchange_strong(controlBlock, newBlock, std::memory_order_acq_rel))
+				return newBlock;
+
+			// Another thread created one first
+			delete newBlock;
+			return controlBlock;
+		}
 	private:
-		mutable uint32_t m_RefCount = 0; // TODO: atomic
+#if HZ_ATOMIC_REFCOUNT
+		mutable std::atomic<uint32_t> m_RefCount = 0;
+#else
+		mutable uint32_t m_RefCount = 0;
+#endif
+		mutable std::atomic<RefControlBlock*> m_ControlBlock = nullptr;
 	};
 
 	template<typename T>
@@ -68,6 +167,12 @@ namespace Hazel {
 			IncRef();
 		}
 
+		Ref(Ref<T>&& other) noexcept
+			: m_Instance(other.m_Instance)
+		{
+			other.m_Instance = nullptr;
+		}
+
 		Ref& operator=(std::nullptr_t)
 		{
 			DecRef();
@@ -75,32 +180,49 @@ namespace Hazel {
 			return *this;
 		}
 
+		// other's pointer is always read before releasing ours, the object we release may own other
 		Ref& operator=(const Ref<T>& other)
 		{
+			T* instance = other.m_Instance;
 			other.IncRef();
 			DecRef();
 
-			m_Instance = other.m_Instance;
+			m_Instance = instance;
+			return *this;
+		}
+
+		Ref& operator=(Ref<T>&& other) noexcept
+		{
+			if (this != &other)
+			{
+				T* instance = other.m_Instance;
+				other.m_Instance = nullptr;
+				DecRef();
+
+				m_Instance = instance;
+			}
 			return *this;
 		}
 
 		template<typename T2>
 		Ref& operator=(const Ref<T2>& other)
 		{
+			T* instance = (T*)other.m_Instance;
 			other.IncRef();
 			DecRef();
 
-			m_Instance = other.m_Instance;
+			m_Instance = instance;
 			return *this;
 		}
 
 		template<typename T2>
 		Ref& operator=(Ref<T2>&& other)
 		{
+			T* instance = (T*)other.m_Instance;
+			other.m_Instance = nullptr;
 			DecRef();
 
-			m_Instance = other.m_Instance;
-			other.m_Instance = nullptr;
+			m_Instance = instance;
 			return *this;
 		}
 
@@ -162,8 +284,7 @@ namespace Hazel {
 		{
 			if (m_Instance)
 			{
-				m_Instance->DecRefCount();
-				if (m_Instance->GetRefCount() == 0)
+				if (m_Instance->DecRefCount() == 0)
 				{
 					delete m_Instance;
 				}
@@ -172,9 +293,126 @@ namespace Hazel {
 
 		template<class T2>
 		friend class Ref;
+		template<class T2>
+		friend class WeakRef;
 		T* m_Instance;
 	};
 
-	// TODO: WeakRef
+	// Non-owning reference. Lock() returns a Ref if the object is still alive, which is safe to call from any thread.
+	template<typename T>
+	class WeakRef
+	{
+	public:
+		WeakRef() = default;
+
+		WeakRef(const Ref<T>& ref)
+		{
+			Assign(ref.m_Instance);
+		}
+
+		WeakRef(const WeakRef<T>& other)
+			: m_Instance(other.m_Instance), m_ControlBlock(other.m_ControlBlock)
+		{
+			if (m_ControlBlock)
+				m_ControlBlock->IncWeakCount();
+		}
+
+		WeakRef(WeakRef<T>&& other) noexcept
+			: m_Instance(other.m_Instance), m_ControlBlock(other.m_ControlBlock)
+		{
+			other.m_Instance = nullptr;
+			other.m_ControlBlock = nullptr;
+		}
+
+		~WeakRef()
+		{
+			Release();
+		}
+
+		WeakRef& operator=(const Ref<T>& ref)
+		{
+			Release();
+			Assign(ref.m_Instance);
+			return *this;
+		}
+
+		WeakRef& operator=(const WeakRef<T>& other)
+		{
+			if (this != &other)
+			{
+				if (other.m_ControlBlock)
+					other.m_ControlBlock->IncWeakCount();
+				Release();
+
+				m_Instance = other.m_Instance;
+				m_ControlBlock = other.m_ControlBlock;
+			}
+			return *this;
+		}
+
+		WeakRef& operator=(WeakRef<T>&& other) noexcept
+		{
+			if (this != &other)
+			{
+				Release();
+
+				m_Instance = other.m_Instance;
+				m_ControlBlock = other.m_ControlBlock;
+				other.m_Instance = nullptr;
+				other.m_ControlBlock = nullptr;
+			}
+			return *this;
+		}
+
+		Ref<T> Lock() const
+		{
+			Ref<T> ref;
+			if (!m_ControlBlock)
+				return ref;
+
+			// The object can't finish destruction while the control block is locked
+			std::lock_guard<std::mutex> lock(m_ControlBlock->Mutex);
+			if (m_ControlBlock->Alive && m_Instance->TryIncRefCount())
+				ref.m_Instance = m_Instance; // Already counted by TryIncRefCount
+			return ref;
+		}
+
+		// Only a hint when other threads may release the object, use Lock() to actually access it
+		bool IsValid() const
+		{
+			if (!m_ControlBlock)
+				return false;
+
+			std::lock_guard<std::mutex> lock(m_ControlBlock->Mutex);
+			return m_ControlBlock->Alive && m_Instance->GetRefCount() > 0;
+		}
+
+		operator bool() const { return IsValid(); }
+
+		void Reset()
+		{
+			Release();
+		}
+	private:
+		void Assign(T* instance)
+		{
+			m_Instance = instance;
+			m_ControlBlock = instance ? instance->GetControlBlock() : nullptr;
+			if (m_ControlBlock)
+				m_ControlBlock->IncWeakCount();
+		}
+
+		void Release()
+		{
+			if (m_ControlBlock)
+				m_ControlBlock->DecWeakCount();
+
+			m_Instance = nullptr;
+			m_ControlBlock = nullptr;
+		}
+	private:
+		T* m_Instance = nullptr;
+		RefControlBlock* m_ControlBlock = nullptr;
+	};
 
 }
@@ -0,0 +1,142 @@
+#include "hzpch.h"
+#include "AssetMemoryWindow.h"
+#include "Hazel/Asset/AssetManager.h"
+
+#include "imgui.h"
+
+#include "Hazel/ImGui/ImGui.h"
+#include "Hazel/Platform/Vulkan/VulkanAllocator.h"
+
+namespace Hazel {
+
+	static const char* AssetTypeToString(AssetType type)
+	{
+		switch (type)
+		{
+			case AssetType::Scene:      return "Scene";
+			case AssetType::Mesh:       return "Mesh";
+			case AssetType::Texture:    return "Texture";
+			case AssetType::EnvMap:     return "Environment";
+			case AssetType::Audio:      return "Audio";
+			case AssetType::Script:     return "Script";
+			case AssetType::PhysicsMat: return "Physics Material";
+			case AssetType::Directory:  return "Directory";
+			case AssetType::Other:      return "Other";
+		}
+		return "Unknown";
+	}
+
+	void AssetMemoryWindow::OnImGuiRender(bool& show)
+	{
+		if (!show)
+			return;
+
+		ImGui::Begin("Asset Memory", &show);
+		RenderBudget();
+		ImGui::Separator();
+		RenderTypeStats();
+		ImGui::Separator();
+		RenderResidentAssets();
+		ImGui::End();
+	}
+
+	void AssetMemoryWindow::RenderBudget()
+	{
+		const AssetMemoryUsage& resident = AssetManager::GetResidentMemory();
+		int cpuBudgetMB = (int)(AssetManager::GetCPUMemoryBudget() / (1024 * 1024));
+		int gpuBudgetMB = (int)(AssetManager::GetGPUMemoryBudget() / (1024 * 1024));
+
+		UI::BeginPropertyGrid();
+		bool modified = UI::Property("CPU Budget (MB, 0 = unlimited)", cpuBudgetMB);
+		modified |= UI::Property("GPU Budget (MB, 0 = unlimited)", gpuBudgetMB);
+		UI::EndPropertyGrid();
+
+		if (modified)
+			AssetManager::SetMemoryBudget((uint64_t)std::max(cpuBudgetMB, 0) * 1024 * 1024, (uint64_t)std::max(gpuBudgetMB, 0) * 1024 * 1024);
+
+		auto budgetBar = [](const char* label, uint64_t used, uint64_t budget)
+		{
+			std::string usedString = Utils::BytesToString(used);
+			if (budget == 0)
+			{
+				ImGui::Text("%s: %s", label, usedString.c_str());
+				return;
+			}
+
+			std::string budgetString = Utils::BytesToString(budget);
+			std::string overlay = usedString + " / " + budgetString;
+			ImGui::Text("%s", label);
+			ImGui::SameLine();
+			ImGui::ProgressBar(std::min((float)((double)used / (double)budget), 1.0f), ImVec2(-1.0f, 0.0f), overlay.c_str());
+		};
+
+		budgetBar("CPU", resident.CPUBytes, AssetManager::GetCPUMemoryBudget());
+		budgetBar("GPU", resident.GPUBytes, AssetManager::GetGPUMemoryBudget());
+	}
+
+	void AssetMemoryWindow::RenderTypeStats()
+	{
+		ImGui::Columns(6);
+		ImGui::Text("Type"); ImGui::NextColumn();
+		ImGui::Text("Resident"); ImGui::NextColumn();
+		ImGui::Text("CPU"); ImGui::NextColumn();
+		ImGui::Text("GPU"); ImGui::NextColumn();
+		ImGui::Text("Evictions"); ImGui::NextColumn();
+		ImGui::Text("Reloads"); ImGui::NextColumn();
+		ImGui::Separator();
+
+		for (auto& [type, stats] : AssetManager::GetMemoryStats())
+		{
+			if (stats.ResidentCount == 0 && stats.Evictions == 0)
+				continue;
+
+			std::string cpu = Utils::BytesToString(stats.CPUBytes);
+			std::string gpu = Utils::BytesToString(stats.GPUBytes);
+			ImGui::Text("%s", AssetTypeToString(type)); ImGui::NextColumn();
+			ImGui::Text("%u", stats.ResidentCount); ImGui::NextColumn();
+			ImGui::Text("%s", cpu.c_str()); ImGui::NextColumn();
+			ImGui::Text("%s", gpu.c_str()); ImGui::NextColumn();
+			ImGui::Text("%llu", stats.Evictions); ImGui::NextColumn();
+			ImGui::Text("%llu", stats.Reloads); ImGui::NextColumn();
+		}
+
+		ImGui::Columns(1);
+	}
+
+	void AssetMemoryWindow::RenderResidentAssets()
+	{
+		if (!ImGui::CollapsingHeader("Resident Assets"))
+			return;
+
+		// Largest first, those are what a budget decides about
+		std::vector<std::pair<AssetHandle, AssetResidency>> assets(AssetManager::GetResidency().begin(), AssetManager::GetResidency().end());
+		std::sort(assets.begin(), assets.end(), [](const auto& a, const auto& b)
+		{
+			return a.second.Usage.CPUBytes + a.second.Usage.GPUBytes > b.second.Usage.CPUBytes + b.second.Usage.GPUBytes;
+		});
+
+		ImGui::Columns(4);
+		ImGui::Text("Asset"); ImGui::NextColumn();
+		ImGui::Text("CPU"); ImGui::NextColumn();
+		ImGui::Text("GPU"); ImGui::NextColumn();
+		ImGui::Text("Last Used (frame)"); ImGui::NextColumn();
+		ImGui::Separator();
+
+		for (auto& [handle, residency] : assets)
+		{
+			if (!AssetManager::IsAssetHandleValid(handle))
+				continue;
+
+			Ref<Asset> asset = AssetManager::GetAsset<Asset>(handle, false);
+			std::string cpu = Utils::BytesToString(residency.Usage.CPUBytes);
+			std::string gpu = Utils::BytesToString(residency.Usage.GPUBytes);
+			ImGui::Text("%s", asset->FilePath.c_str()); ImGui::NextColumn();
+			ImGui::Text("%s", cpu.c_str()); ImGui::NextColumn();
+			ImGui::Text("%s", gpu.c_str()); ImGui::NextColumn();
+			ImGui::Text("%llu", residency.LastUsedFrame); ImGui::NextColumn();
+		}
+
+		ImGui::Columns(1);
+	}
+
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+namespace Hazel {
+
+	// Resident asset memory per type, eviction churn and the AssetManager's memory budget
+	class AssetMemoryWindow
+	{
+	public:
+		static void OnImGuiRender(bool& show);
+
+	private:
+		static void RenderBudget();
+		static void RenderTypeStats();
+		static void RenderResidentAssets();
+	};
+
+}
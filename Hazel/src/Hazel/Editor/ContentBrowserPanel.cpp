@@ -496,6 +496,15 @@ namespace Hazel {
 			else
 				m_CurrentDirFiles.push_back(asset);
 		}
+
+		// The asset manager doesn't keep children in any order, only the directory being shown gets sorted
+		auto compare = [](const Ref<Asset>& a, const Ref<Asset>& b)
+		{
+			return std::lexicographical_compare(a->FileName.begin(), a->FileName.end(), b->FileName.begin(), b->FileName.end(),
+				[](char lhs, char rhs) { return std::tolower(lhs) < std::tolower(rhs); });
+		};
+		std::sort(m_CurrentDirFolders.begin(), m_CurrentDirFolders.end(), compare);
+		std::sort(m_CurrentDirFiles.begin(), m_CurrentDirFiles.end(), compare);
 	}
 
 }
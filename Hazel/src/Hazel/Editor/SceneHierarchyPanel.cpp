@@ -345,8 +345,8 @@ namespace Hazel {
 		memset(imguiName, 0, 128);
 		sprintf(imguiName, "Mesh##%d", imguiMeshID++);
 
-		// Mesh Hierarchy
-		if (ImGui::TreeNode(imguiName))
+		// Mesh Hierarchy, cooked meshes don't keep the assimp scene around
+		if (mesh->m_Scene && ImGui::TreeNode(imguiName))
 		{
 			auto rootNode = mesh->m_Scene->mRootNode;
 			MeshNodeHierarchy(mesh, rootNode);
@@ -550,7 +550,7 @@ namespace Hazel {
 			ImGui::PushItemWidth(contentRegionAvailable.x * 0.5f);
 			if (ImGui::InputText("##Tag", buffer, 256))
 			{
-				tag = std::string(buffer);
+				m_Context->SetEntityTag(entity, std::string(buffer));
 			}
 			ImGui::PopItemWidth();
 		}
@@ -0,0 +1,166 @@
+#include "hzpch.h"
+#include "BVH.h"
+
+namespace Hazel {
+
+	static constexpr uint32_t s_BinCount = 16;
+	// Cost of visiting a node relative to testing a leaf
+	static constexpr float s_TraversalCost = 1.0f;
+
+	static float GetHalfArea(const glm::vec3& min, const glm::vec3& max)
+	{
+		glm::vec3 extent = max - min;
+		return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+	}
+
+	void BVH::Build(const AABB* bounds, uint32_t count)
+	{
+		m_Nodes.clear();
+		m_Primitives.resize(count);
+		if (count == 0)
+			return;
+
+		std::vector<glm::vec3> centroids(count);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			centroids[i] = (bounds[i].Min + bounds[i].Max) * 0.5f;
+			m_Primitives[i] = i;
+		}
+
+		// A binary tree with at least one primitive per leaf never has more than 2n - 1 nodes
+		m_Nodes.reserve(2 * count - 1);
+		m_Nodes.push_back({ glm::vec3(0.0f), 0, glm::vec3(0.0f), count });
+
+		struct BuildEntry
+		{
+			uint32_t Node;
+			uint32_t Depth;
+		};
+		std::vector<BuildEntry> stack = { { 0, 0 } };
+		while (!stack.empty())
+		{
+			BuildEntry entry = stack.back();
+			stack.pop_back();
+
+			uint32_t first = m_Nodes[entry.Node].FirstChildOrPrimitive;
+			uint32_t nodeCount = m_Nodes[entry.Node].PrimitiveCount;
+
+			glm::vec3 min(FLT_MAX), max(-FLT_MAX);
+			glm::vec3 centroidMin(FLT_MAX), centroidMax(-FLT_MAX);
+			for (uint32_t i = first; i < first + nodeCount; i++)
+			{
+				min = glm::min(min, bounds[m_Primitives[i]].Min);
+				max = glm::max(max, bounds[m_Primitives[i]].Max);
+				centroidMin = glm::min(centroidMin, centroids[m_Primitives[i]]);
+				centroidMax = glm::max(centroidMax, centroids[m_Primitives[i]]);
+			}
+			m_Nodes[entry.Node].Min = min;
+			m_Nodes[entry.Node].Max = max;
+
+			if (nodeCount == 1 || entry.Depth + 1 >= MaxDepth)
+				continue;
+
+			// Sort the centroids into bins along each axis and pick the boundary between bins where
+			// area * primitive count, summed over both sides, is lowest
+			struct Bin
+			{
+				glm::vec3 Min{ FLT_MAX }, Max{ -FLT_MAX };
+				uint32_t Count = 0;
+			};
+
+			float bestCost = FLT_MAX;
+			int bestAxis = -1;
+			uint32_t bestSplit = 0; // Bins below this go left
+			glm::vec3 centroidExtent = centroidMax - centroidMin;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				if (centroidExtent[axis] <= 0.0f)
+					continue;
+
+				float binScale = s_BinCount / centroidExtent[axis];
+				Bin bins[s_BinCount];
+				for (uint32_t i = first; i < first + nodeCount; i++)
+				{
+					uint32_t primitive = m_Primitives[i];
+					uint32_t binIndex = glm::min(s_BinCount - 1, (uint32_t)((centroids[primitive][axis] - centroidMin[axis]) * binScale));
+					Bin& bin = bins[binIndex];
+					bin.Min = glm::min(bin.Min, bounds[primitive].Min);
+					bin.Max = glm::max(bin.Max, bounds[primitive].Max);
+					bin.Count++;
+				}
+
+				// Left side costs for every boundary sweeping forwards, then add the right side sweeping backwards
+				float leftCosts[s_BinCount - 1];
+				uint32_t leftCounts[s_BinCount - 1];
+				Bin left;
+				for (uint32_t i = 0; i < s_BinCount - 1; i++)
+				{
+					left.Min = glm::min(left.Min, bins[i].Min);
+					left.Max = glm::max(left.Max, bins[i].Max);
+					left.Count += bins[i].Count;
+					leftCounts[i] = left.Count;
+					leftCosts[i] = left.Count ? GetHalfArea(left.Min, left.Max) * left.Count : 0.0f;
+				}
+
+				Bin right;
+				for (uint32_t i = s_BinCount - 1; i > 0; i--)
+				{
+					right.Min = glm::min(right.Min, bins[i].Min);
+					right.Max = glm::max(right.Max, bins[i].Max);
+					right.Count += bins[i].Count;
+					if (leftCounts[i - 1] == 0 || right.Count == 0)
+						continue;
+
+					float cost = leftCosts[i - 1] + GetHalfArea(right.Min, right.Max) * right.Count;
+					if (cost < bestCost)
+					{
+						bestCost = cost;
+						bestAxis = axis;
+						bestSplit = i;
+					}
+				}
+			}
+
+			uint32_t leftCount;
+			if (bestAxis == -1)
+			{
+				// Every centroid is in the same place, so no boundary separates them. Halve big nodes anyway.
+				if (nodeCount <= MaxLeafSize)
+					continue;
+
+				leftCount = nodeCount / 2;
+			}
+			else
+			{
+				// Testing the leaf has to be cheaper than visiting both children. Leaves are tested up to MaxLeafSize
+				// primitives at once (see SubmeshBVH), so a full one costs about as much as a single primitive.
+				float area = GetHalfArea(min, max);
+				float splitCost = s_TraversalCost + (area > 0.0f ? bestCost / area : 0.0f);
+				float leafCost = (float)((nodeCount + MaxLeafSize - 1) / MaxLeafSize);
+				if (nodeCount <= MaxLeafSize && leafCost <= splitCost)
+					continue;
+
+				float binScale = s_BinCount / centroidExtent[bestAxis];
+				float axisMin = centroidMin[bestAxis];
+				auto begin = m_Primitives.begin() + first;
+				auto middle = std::partition(begin, begin + nodeCount, [&](uint32_t primitive)
+				{
+					return glm::min(s_BinCount - 1, (uint32_t)((centroids[primitive][bestAxis] - axisMin) * binScale)) < bestSplit;
+				});
+				leftCount = (uint32_t)(middle - begin);
+			}
+
+			uint32_t left = (uint32_t)m_Nodes.size();
+			m_Nodes.push_back({ glm::vec3(0.0f), first, glm::vec3(0.0f), leftCount });
+			m_Nodes.push_back({ glm::vec3(0.0f), first + leftCount, glm::vec3(0.0f), nodeCount - leftCount });
+			m_Nodes[entry.Node].FirstChildOrPrimitive = left;
+			m_Nodes[entry.Node].PrimitiveCount = 0;
+
+			stack.push_back({ left, entry.Depth + 1 });
+			stack.push_back({ left + 1, entry.Depth + 1 });
+		}
+
+		m_Nodes.shrink_to_fit();
+	}
+
+}
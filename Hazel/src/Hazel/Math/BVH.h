@@ -0,0 +1,163 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Hazel/Core/Math/AABB.h"
+#include "Hazel/Core/Math/Ray.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+	#define HZ_BVH_SSE 1
+	#include <emmintrin.h>
+#else
+	#define HZ_BVH_SSE 0
+#endif
+
+namespace Hazel {
+
+	// Binary bounding volume hierarchy over a set of boxes, built with the binned surface area heuristic.
+	// Only node bounds and the order of the primitives are stored, the owner tests its primitives itself
+	// through the leaf callback of Raycast.
+	class BVH
+	{
+	public:
+		static constexpr uint32_t MaxLeafSize = 4; // Larger leaves are only made when the tree gets too deep
+		static constexpr uint32_t MaxDepth = 64;
+
+		void Build(const AABB* bounds, uint32_t count);
+
+		// Visits the leaves the ray passes through, nearest first. closest is the farthest distance to accept, in multiples
+		// of the ray's direction. leafTest(const uint32_t* primitives, uint32_t count, float& closest) tests a leaf's
+		// primitives, lowers closest to the nearest hit and returns whether there was one.
+		template<typename LeafTest>
+		bool Raycast(const Ray& ray, float& closest, LeafTest&& leafTest) const;
+
+		bool IsEmpty() const { return m_Nodes.empty(); }
+		size_t GetMemoryUsage() const { return m_Nodes.capacity() * sizeof(Node) + m_Primitives.capacity() * sizeof(uint32_t); }
+	private:
+		struct alignas(16) Node
+		{
+			glm::vec3 Min;
+			uint32_t FirstChildOrPrimitive; // Inner nodes: left child, the right one follows it. Leaves: first entry in m_Primitives.
+			glm::vec3 Max;
+			uint32_t PrimitiveCount;        // 0 for inner nodes
+		};
+
+		static_assert(sizeof(Node) == 32);
+
+		// Slab test against a node's box, outDistance is where the ray enters it
+		struct RayData
+		{
+#if HZ_BVH_SSE
+			__m128 Origin, InverseDirection;
+
+			RayData(const Ray& ray)
+				: Origin(_mm_setr_ps(ray.Origin.x, ray.Origin.y, ray.Origin.z, 0.0f)),
+				InverseDirection(_mm_setr_ps(1.0f / ray.Direction.x, 1.0f / ray.Direction.y, 1.0f / ray.Direction.z, 0.0f)) {}
+
+			bool Intersects(const Node& node, float maxDistance, float& outDistance) const
+			{
+				// The w lanes hold the node's integers, they're ignored by only reducing x, y and z
+				__m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(&node.Min.x), Origin), InverseDirection);
+				__m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(&node.Max.x), Origin), InverseDirection);
+				__m128 tMin = _mm_min_ps(t0, t1);
+				__m128 tMax = _mm_max_ps(t0, t1);
+
+				__m128 tNear = _mm_max_ss(_mm_max_ss(tMin, _mm_shuffle_ps(tMin, tMin, _MM_SHUFFLE(1, 1, 1, 1))),
+					_mm_max_ss(_mm_shuffle_ps(tMin, tMin, _MM_SHUFFLE(2, 2, 2, 2)), _mm_setzero_ps()));
+				__m128 tFar = _mm_min_ss(_mm_min_ss(tMax, _mm_shuffle_ps(tMax, tMax, _MM_SHUFFLE(1, 1, 1, 1))),
+					_mm_min_ss(_mm_shuffle_ps(tMax, tMax, _MM_SHUFFLE(2, 2, 2, 2)), _mm_set_ss(maxDistance)));
+				outDistance = _mm_cvtss_f32(tNear);
+				return _mm_comile_ss(tNear, tFar);
+			}
+#else
+			glm::vec3 Origin, InverseDirection;
+
+			RayData(const Ray& ray)
+				: Origin(ray.Origin), InverseDirection(1.0f / ray.Direction) {}
+
+			bool Intersects(const Node& node, float maxDistance, float& outDistance) const
+			{
+				glm::vec3 t0 = (node.Min - Origin) * InverseDirection;
+				glm::vec3 t1 = (node.Max - Origin) * InverseDirection;
+				glm::vec3 tMin = glm::min(t0, t1);
+				glm::vec3 tMax = glm::max(t0, t1);
+
+				float tNear = glm::max(glm::max(tMin.x, tMin.y), glm::max(tMin.z, 0.0f));
+				float tFar = glm::min(glm::min(tMax.x, tMax.y), glm::min(tMax.z, maxDistance));
+				outDistance = tNear;
+				return tNear <= tFar;
+			}
+#endif
+		};
+
+		std::vector<Node> m_Nodes;
+		std::vector<uint32_t> m_Primitives;
+	};
+
+	template<typename LeafTest>
+	bool BVH::Raycast(const Ray& ray, float& closest, LeafTest&& leafTest) const
+	{
+		if (m_Nodes.empty())
+			return false;
+
+		RayData rayData(ray);
+		float distance;
+		if (!rayData.Intersects(m_Nodes[0], closest, distance))
+			return false;
+
+		// Nodes waiting to be visited, with the distance the ray enters them at. Each level pushes at most two
+		// and pops one, so the depth limit bounds the stack.
+		struct StackEntry
+		{
+			uint32_t Node;
+			float Distance;
+		};
+		StackEntry stack[MaxDepth + 1];
+		uint32_t stackSize = 0;
+		stack[stackSize++] = { 0, distance };
+
+		bool hit = false;
+		while (stackSize > 0)
+		{
+			StackEntry entry = stack[--stackSize];
+			if (entry.Distance > closest)
+				continue;
+
+			const Node& node = m_Nodes[entry.Node];
+			if (node.PrimitiveCount > 0)
+			{
+				if (leafTest(&m_Primitives[node.FirstChildOrPrimitive], node.PrimitiveCount, closest))
+					hit = true;
+				continue;
+			}
+
+			// Visit the nearer child first, so later boxes can be skipped once a hit is closer than them
+			uint32_t left = node.FirstChildOrPrimitive, right = left + 1;
+			float leftDistance, rightDistance;
+			bool hitsLeft = rayData.Intersects(m_Nodes[left], closest, leftDistance);
+			bool hitsRight = rayData.Intersects(m_Nodes[right], closest, rightDistance);
+			if (hitsLeft && hitsRight)
+			{
+				if (leftDistance > rightDistance)
+				{
+					std::swap(left, right);
+					std::swap(leftDistance, rightDistance);
+				}
+				stack[stackSize++] = { right, rightDistance };
+				stack[stackSize++] = { left, leftDistance };
+			}
+			else if (hitsLeft)
+			{
+				stack[stackSize++] = { left, leftDistance };
+			}
+			else if (hitsRight)
+			{
+				stack[stackSize++] = { right, rightDistance };
+			}
+		}
+
+		return hit;
+	}
+
+}
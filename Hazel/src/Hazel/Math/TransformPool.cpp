@@ -0,0 +1,160 @@
+#include "hzpch.h"
+#include "TransformPool.h"
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+#if defined(_M_X64) || defined(__SSE2__)
+	#define HZ_TRANSFORM_POOL_SSE 1
+	#include <emmintrin.h>
+#else
+	#define HZ_TRANSFORM_POOL_SSE 0
+#endif
+
+namespace Hazel {
+
+	void TransformPool::Reserve(uint32_t count)
+	{
+		for (auto* component : { &m_TranslationX, &m_TranslationY, &m_TranslationZ, &m_RotationX, &m_RotationY, &m_RotationZ, &m_ScaleX, &m_ScaleY, &m_ScaleZ })
+			component->reserve(count);
+	}
+
+	void TransformPool::Clear()
+	{
+		// Keeps capacity so the pool can be refilled every frame without reallocating
+		for (auto* component : { &m_TranslationX, &m_TranslationY, &m_TranslationZ, &m_RotationX, &m_RotationY, &m_RotationZ, &m_ScaleX, &m_ScaleY, &m_ScaleZ })
+			component->clear();
+	}
+
+	uint32_t TransformPool::Add(const glm::vec3& translation, const glm::vec3& rotation, const glm::vec3& scale)
+	{
+		uint32_t index = Size();
+		m_TranslationX.push_back(translation.x);
+		m_TranslationY.push_back(translation.y);
+		m_TranslationZ.push_back(translation.z);
+		m_RotationX.push_back(rotation.x);
+		m_RotationY.push_back(rotation.y);
+		m_RotationZ.push_back(rotation.z);
+		m_ScaleX.push_back(scale.x);
+		m_ScaleY.push_back(scale.y);
+		m_ScaleZ.push_back(scale.z);
+		return index;
+	}
+
+#if HZ_TRANSFORM_POOL_SSE
+	// Four-wide sine and cosine. Wraps to [-pi, pi], folds to [-pi/2, pi/2] and evaluates
+	// the Taylor series up to x^11 / x^12, which is accurate to float precision on that range.
+	static void SinCos(__m128 x, __m128& outSin, __m128& outCos)
+	{
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		const __m128 pi = _mm_set1_ps(3.14159265358979f);
+		const __m128 halfPi = _mm_set1_ps(1.57079632679490f);
+
+		__m128 turns = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(0.159154943091895f))));
+		x = _mm_sub_ps(x, _mm_mul_ps(turns, _mm_set1_ps(6.28318530717959f)));
+
+		// sin(x) == sin(+-pi - x) and cos(x) == -cos(+-pi - x)
+		__m128 sign = _mm_and_ps(x, signMask);
+		__m128 fold = _mm_cmpgt_ps(_mm_andnot_ps(signMask, x), halfPi);
+		__m128 folded = _mm_sub_ps(_mm_or_ps(pi, sign), x);
+		x = _mm_or_ps(_mm_and_ps(fold, folded), _mm_andnot_ps(fold, x));
+		__m128 cosSign = _mm_and_ps(fold, signMask);
+
+		__m128 x2 = _mm_mul_ps(x, x);
+
+		__m128 s = _mm_set1_ps(-1.0f / 39916800.0f);
+		s = _mm_add_ps(_mm_mul_ps(s, x2), _mm_set1_ps(1.0f / 362880.0f));
+		s = _mm_add_ps(_mm_mul_ps(s, x2), _mm_set1_ps(-1.0f / 5040.0f));
+		s = _mm_add_ps(_mm_mul_ps(s, x2), _mm_set1_ps(1.0f / 120.0f));
+		s = _mm_add_ps(_mm_mul_ps(s, x2), _mm_set1_ps(-1.0f / 6.0f));
+		s = _mm_add_ps(_mm_mul_ps(s, x2), _mm_set1_ps(1.0f));
+		outSin = _mm_mul_ps(s, x);
+
+		__m128 c = _mm_set1_ps(1.0f / 479001600.0f);
+		c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(-1.0f / 3628800.0f));
+		c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(1.0f / 40320.0f));
+		c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(-1.0f / 720.0f));
+		c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(1.0f / 24.0f));
+		c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(-0.5f));
+		c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(1.0f));
+		outCos = _mm_xor_ps(c, cosSign);
+	}
+
+	// Takes one matrix column for four transforms (one register per row) and stores it into each matrix
+	static void StoreColumn(glm::mat4* outTransforms, int column, __m128 row0, __m128 row1, __m128 row2, __m128 row3)
+	{
+		_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+		_mm_storeu_ps(&outTransforms[0][column].x, row0);
+		_mm_storeu_ps(&outTransforms[1][column].x, row1);
+		_mm_storeu_ps(&outTransforms[2][column].x, row2);
+		_mm_storeu_ps(&outTransforms[3][column].x, row3);
+	}
+#endif
+
+	void TransformPool::ComposeTransforms(glm::mat4* outTransforms) const
+	{
+		uint32_t count = Size();
+		uint32_t i = 0;
+
+#if HZ_TRANSFORM_POOL_SSE
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 two = _mm_set1_ps(2.0f);
+		const __m128 half = _mm_set1_ps(0.5f);
+
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 sx, cx, sy, cy, sz, cz;
+			SinCos(_mm_mul_ps(_mm_loadu_ps(&m_RotationX[i]), half), sx, cx);
+			SinCos(_mm_mul_ps(_mm_loadu_ps(&m_RotationY[i]), half), sy, cy);
+			SinCos(_mm_mul_ps(_mm_loadu_ps(&m_RotationZ[i]), half), sz, cz);
+
+			// Same as glm::quat(eulerAngles)
+			__m128 cycz = _mm_mul_ps(cy, cz);
+			__m128 sysz = _mm_mul_ps(sy, sz);
+			__m128 sycz = _mm_mul_ps(sy, cz);
+			__m128 cysz = _mm_mul_ps(cy, sz);
+			__m128 qw = _mm_add_ps(_mm_mul_ps(cx, cycz), _mm_mul_ps(sx, sysz));
+			__m128 qx = _mm_sub_ps(_mm_mul_ps(sx, cycz), _mm_mul_ps(cx, sysz));
+			__m128 qy = _mm_add_ps(_mm_mul_ps(cx, sycz), _mm_mul_ps(sx, cysz));
+			__m128 qz = _mm_sub_ps(_mm_mul_ps(cx, cysz), _mm_mul_ps(sx, sycz));
+
+			// Same as glm::mat3_cast
+			__m128 xx = _mm_mul_ps(qx, qx), yy = _mm_mul_ps(qy, qy), zz = _mm_mul_ps(qz, qz);
+			__m128 xy = _mm_mul_ps(qx, qy), xz = _mm_mul_ps(qx, qz), yz = _mm_mul_ps(qy, qz);
+			__m128 wx = _mm_mul_ps(qw, qx), wy = _mm_mul_ps(qw, qy), wz = _mm_mul_ps(qw, qz);
+
+			__m128 scaleX = _mm_loadu_ps(&m_ScaleX[i]);
+			__m128 scaleY = _mm_loadu_ps(&m_ScaleY[i]);
+			__m128 scaleZ = _mm_loadu_ps(&m_ScaleZ[i]);
+
+			__m128 m00 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), scaleX);
+			__m128 m01 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), scaleX);
+			__m128 m02 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), scaleX);
+
+			__m128 m10 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), scaleY);
+			__m128 m11 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), scaleY);
+			__m128 m12 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), scaleY);
+
+			__m128 m20 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), scaleZ);
+			__m128 m21 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), scaleZ);
+			__m128 m22 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), scaleZ);
+
+			glm::mat4* out = outTransforms + i;
+			StoreColumn(out, 0, m00, m01, m02, zero);
+			StoreColumn(out, 1, m10, m11, m12, zero);
+			StoreColumn(out, 2, m20, m21, m22, zero);
+			StoreColumn(out, 3, _mm_loadu_ps(&m_TranslationX[i]), _mm_loadu_ps(&m_TranslationY[i]), _mm_loadu_ps(&m_TranslationZ[i]), one);
+		}
+#endif
+
+		for (; i < count; i++)
+		{
+			outTransforms[i] = glm::translate(glm::mat4(1.0f), { m_TranslationX[i], m_TranslationY[i], m_TranslationZ[i] })
+				* glm::toMat4(glm::quat(glm::vec3{ m_RotationX[i], m_RotationY[i], m_RotationZ[i] }))
+				* glm::scale(glm::mat4(1.0f), { m_ScaleX[i], m_ScaleY[i], m_ScaleZ[i] });
+		}
+	}
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace Hazel {
+
+	// Packed structure-of-arrays storage for translation/rotation(euler)/scale triples.
+	// Lets ComposeTransforms build matrices for four transforms per iteration with SSE.
+	class TransformPool
+	{
+	public:
+		void Reserve(uint32_t count);
+		void Clear();
+
+		uint32_t Add(const glm::vec3& translation, const glm::vec3& rotation, const glm::vec3& scale);
+		uint32_t Size() const { return (uint32_t)m_TranslationX.size(); }
+
+		// Writes translate * toMat4(quat(rotation)) * scale for every entry, equivalent to TransformComponent::GetTransform
+		void ComposeTransforms(glm::mat4* outTransforms) const;
+	private:
+		std::vector<float> m_TranslationX, m_TranslationY, m_TranslationZ;
+		std::vector<float> m_RotationX, m_RotationY, m_RotationZ;
+		std::vector<float> m_ScaleX, m_ScaleY, m_ScaleZ;
+	};
+
+}
@@ -4,6 +4,7 @@
 #include "PhysicsLayer.h"
 #include "PhysicsActor.h"
 #include "Hazel/Script/ScriptEngine.h"
+#include "Hazel/Core/JobSystem.h"
 
 #include <glm/gtx/rotate_vector.hpp>
 
@@ -21,10 +22,24 @@ namespace Hazel {
 	static physx::PxPhysics* s_Physics = nullptr;
 	static physx::PxCooking* s_CookingFactory = nullptr;
 	static physx::PxOverlapHit s_OverlapBuffer[OVERLAP_MAX_COLLIDERS];
-	static physx::PxDefaultCpuDispatcher* s_CPUDispatcher = nullptr;
+	static PhysicsJobDispatcher s_CPUDispatcher;
 
 	static ContactListener3D s_ContactListener;
 
+	void PhysicsJobDispatcher::submitTask(physx::PxBaseTask& task)
+	{
+		JobSystem::Submit([&task]()
+		{
+			task.run();
+			task.release();
+		});
+	}
+
+	uint32_t PhysicsJobDispatcher::getWorkerCount() const
+	{
+		return JobSystem::GetWorkerCount();
+	}
+
 	void PhysicsErrorCallback::reportError(physx::PxErrorCode::Enum code, const char* message, const char* file, int line)
 	{
 		const char* errorMessage = NULL;
@@ -162,16 +177,13 @@ namespace Hazel {
 
 	physx::PxScene* PXPhysicsWrappers::CreateScene()
 	{
-		if (!s_CPUDispatcher)
-			s_CPUDispatcher = physx::PxDefaultCpuDispatcherCreate(1);
-
 		physx::PxSceneDesc sceneDesc(s_Physics->getTolerancesScale());
 
 		const PhysicsSettings& settings = Physics::GetSettings();
 
 		sceneDesc.gravity = ToPhysXVector(settings.Gravity);
 		sceneDesc.broadPhaseType = HazelToPhysXBroadphaseType(settings.BroadphaseAlgorithm);
-		sceneDesc.cpuDispatcher = s_CPUDispatcher;
+		sceneDesc.cpuDispatcher = &s_CPUDispatcher;
 		sceneDesc.filterShader = HazelFilterShader;
 		sceneDesc.simulationEventCallback = &s_ContactListener;
 		sceneDesc.frictionType = HazelToPhysXFrictionType(settings.FrictionModel);
@@ -298,10 +310,12 @@ namespace Hazel {
 		newParams.meshWeldTolerance = 0.01f;
 		s_CookingFactory->setParams(newParams);
 
+		DerivedDataKey cacheKey = PhysicsMeshSerializer::GetCacheKey(collider.CollisionMesh, CookedColliderType::Convex, newParams);
 		if (invalidateOld)
-			PhysicsMeshSerializer::DeleteIfSerialized(collider.CollisionMesh->GetFilePath());
+			PhysicsMeshSerializer::DeleteIfSerialized(cacheKey);
 
-		if (!PhysicsMeshSerializer::IsSerialized(collider.CollisionMesh->GetFilePath()))
+		Buffer colliderBuffer;
+		if (!PhysicsMeshSerializer::DeserializeMesh(cacheKey, colliderBuffer))
 		{
 			const std::vector<Vertex>& vertices = collider.CollisionMesh->GetStaticVertices();
 			const std::vector<Index>& indices = collider.CollisionMesh->GetIndices();
@@ -352,7 +366,6 @@ namespace Hazel {
 				convexMesh->release();
 			}
 
-			Buffer colliderBuffer;
 			colliderBuffer.Allocate(bufferSize);
 
 			uint32_t offset = 0;
@@ -366,12 +379,11 @@ namespace Hazel {
 				delete[] data.Data;
 			}
 
-			PhysicsMeshSerializer::SerializeMesh(collider.CollisionMesh->GetFilePath(), colliderBuffer);
+			PhysicsMeshSerializer::SerializeMesh(cacheKey, colliderBuffer);
 			colliderBuffer.Release();
 		}
 		else
 		{
-			Buffer colliderBuffer = PhysicsMeshSerializer::DeserializeMesh(collider.CollisionMesh->GetFilePath());
 			uint32_t offset = 0;
 
 			for (const auto& submesh : collider.CollisionMesh->GetSubmeshes())
@@ -466,10 +478,12 @@ namespace Hazel {
 
 		collider.ProcessedMeshes.clear();
 
+		DerivedDataKey cacheKey = PhysicsMeshSerializer::GetCacheKey(collider.CollisionMesh, CookedColliderType::Triangle, s_CookingFactory->getParams());
 		if (invalidateOld)
-			PhysicsMeshSerializer::DeleteIfSerialized(collider.CollisionMesh->GetFilePath());
+			PhysicsMeshSerializer::DeleteIfSerialized(cacheKey);
 
-		if (!PhysicsMeshSerializer::IsSerialized(collider.CollisionMesh->GetFilePath()))
+		Buffer colliderBuffer;
+		if (!PhysicsMeshSerializer::DeserializeMesh(cacheKey, colliderBuffer))
 		{
 			const std::vector<Vertex>& vertices = collider.CollisionMesh->GetStaticVertices();
 			const std::vector<Index>& indices = collider.CollisionMesh->GetIndices();
@@ -518,7 +532,6 @@ namespace Hazel {
 				trimesh->release();
 			}
 
-			Buffer colliderBuffer;
 			colliderBuffer.Allocate(bufferSize);
 
 			uint32_t offset = 0;
@@ -532,12 +545,11 @@ namespace Hazel {
 				delete[] data.Data;
 			}
 
-			PhysicsMeshSerializer::SerializeMesh(collider.CollisionMesh->GetFilePath(), colliderBuffer);
+			PhysicsMeshSerializer::SerializeMesh(cacheKey, colliderBuffer);
 			colliderBuffer.Release();
 		}
 		else
 		{
-			Buffer colliderBuffer = PhysicsMeshSerializer::DeserializeMesh(collider.CollisionMesh->GetFilePath());
 			uint32_t offset = 0;
 
 			for (const auto& submesh : collider.CollisionMesh->GetSubmeshes())
@@ -722,10 +734,6 @@ namespace Hazel {
 
 	void PXPhysicsWrappers::Shutdown()
 	{
-		if (s_CPUDispatcher)
-			s_CPUDispatcher->release();
-		s_CPUDispatcher = nullptr;
-
 		if (s_CookingFactory)
 			s_CookingFactory->release();
 		s_CookingFactory = nullptr;
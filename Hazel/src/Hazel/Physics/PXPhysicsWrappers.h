@@ -21,6 +21,14 @@ namespace Hazel
 		virtual void operator()(const char* exp, const char* file, int line, bool& ignore);
 	};
 
+	// Runs PhysX tasks on the engine's JobSystem workers instead of a separate PhysX thread pool
+	class PhysicsJobDispatcher : public physx::PxCpuDispatcher
+	{
+	public:
+		virtual void submitTask(physx::PxBaseTask& task) override;
+		virtual uint32_t getWorkerCount() const override;
+	};
+
 	class ContactListener3D : public physx::PxSimulationEventCallback
 	{
 	public:
@@ -5,6 +5,7 @@
 #include "PhysicsActor.h"
 
 #include "Hazel/Script/ScriptEngine.h"
+#include "Hazel/Core/JobSystem.h"
 
 #include <PhysX/extensions/PxBroadPhaseExt.h>
 
@@ -85,7 +86,9 @@ namespace Hazel {
 		for (auto& actor : s_Actors)
 			actor->Update(s_Settings.FixedTimestep);
 
+		// PhysX tasks run on the JobSystem workers, so help out instead of blocking in fetchResults
 		s_Scene->simulate(s_Settings.FixedTimestep);
+		JobSystem::WaitUntil([]() { return s_Scene->checkResults(false); });
 		s_Scene->fetchResults(true);
 
 		for (auto& actor : s_Actors)
@@ -193,7 +193,7 @@ namespace Hazel {
 		physx::PxPhysics& physics = PXPhysicsWrappers::GetPhysics();
 
 		Ref<Scene> scene = Scene::GetScene(m_Entity.GetSceneUUID());
-		glm::mat4 transform = scene->GetTransformRelativeToParent(m_Entity);
+		const glm::mat4& transform = scene->GetWorldTransform(m_Entity);
 
 		if (m_RigidBody.BodyType == RigidBodyComponent::Type::Static)
 		{
@@ -258,7 +258,7 @@ namespace Hazel {
 		{
 			// Synchronize Physics Actor with static Entity
 			Ref<Scene> scene = Scene::GetScene(m_Entity.GetSceneUUID());
-			m_ActorInternal->setGlobalPose(ToPhysXTransform(scene->GetTransformRelativeToParent(m_Entity)));
+			m_ActorInternal->setGlobalPose(ToPhysXTransform(scene->GetWorldTransform(m_Entity)));
 		}
 	}
 
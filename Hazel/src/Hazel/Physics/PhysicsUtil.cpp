@@ -2,25 +2,8 @@
 #include "PhysicsUtil.h"
 #include "Hazel/Utilities/FileSystem.h"
 
-#include <filesystem>
-
 namespace Hazel {
 
-	namespace Utils {
-
-		static const char* GetCacheDirectory()
-		{
-			return "assets/cache/colliders/";
-		}
-
-		static void CreateCacheDirectoryIfNeeded()
-		{
-			std::string cacheDirectory = GetCacheDirectory();
-			if (!std::filesystem::exists(cacheDirectory))
-				std::filesystem::create_directories(cacheDirectory);
-		}
-	}
-
 	physx::PxTransform ToPhysXTransform(const TransformComponent& transform)
 	{
 		physx::PxQuat r = ToPhysXQuat(glm::normalize(glm::quat(transform.Rotation)));
@@ -109,71 +92,47 @@ namespace Hazel {
 		return physx::PxFilterFlag::eSUPPRESS;
 	}
 
-	void PhysicsMeshSerializer::DeleteIfSerialized(const std::string& filepath)
-	{
-		if (!FileSystem::Exists(Utils::GetCacheDirectory()))
-			FileSystem::CreateFolder(Utils::GetCacheDirectory());
-
-		std::filesystem::path path = filepath;
-		std::string cachePath = Utils::GetCacheDirectory() + path.filename().string() + ".pxm";
-		if (IsSerialized(filepath))
-			FileSystem::DeleteFile(cachePath);
-	}
-
-	void PhysicsMeshSerializer::SerializeMesh(const std::string& filepath, const Buffer& data)
+	DerivedDataKey PhysicsMeshSerializer::GetCacheKey(const Ref<Mesh>& mesh, CookedColliderType type, const physx::PxCookingParams& params)
 	{
-		if (!FileSystem::Exists(Utils::GetCacheDirectory()))
-			FileSystem::CreateFolder(Utils::GetCacheDirectory());
+		DerivedDataKey key("colliders");
+		key.Add((uint32_t)PX_PHYSICS_VERSION).Add(type);
 
-		std::filesystem::path path = filepath;
-		std::string cachePath = Utils::GetCacheDirectory() + path.filename().string() + ".pxm";
-
-		FILE* f = fopen(cachePath.c_str(), "wb");
-		if (f)
+		// Meshes built in code have no source file, their data is all there is
+		if (mesh->GetSourceHash())
 		{
-			fwrite(data.Data, sizeof(byte), data.Size / sizeof(byte), f);
-			fclose(f);
+			key.Add(mesh->GetSourceHash());
+			for (const std::string& filepath : mesh->GetSourceFilePaths())
+				key.Add(filepath).AddFile(filepath);
 		}
 		else
 		{
-			HZ_CORE_INFO("File Already Exists");
+			const std::vector<Vertex>& vertices = mesh->GetStaticVertices();
+			const std::vector<Index>& indices = mesh->GetIndices();
+			key.Add(vertices.data(), vertices.size() * sizeof(Vertex));
+			key.Add(indices.data(), indices.size() * sizeof(Index));
 		}
+
+		// Field by field, the struct has padding
+		key.Add(params.areaTestEpsilon).Add(params.planeTolerance).Add(params.convexMeshCookingType);
+		key.Add(params.suppressTriangleMeshRemapTable).Add(params.buildTriangleAdjacencies).Add(params.buildGPUData);
+		key.Add(params.scale.length).Add(params.scale.speed);
+		key.Add((uint32_t)params.meshPreprocessParams).Add(params.meshWeldTolerance);
+		key.Add(params.midphaseDesc.getType()).Add(params.gaussMapLimit);
+		return key;
 	}
 
-	bool PhysicsMeshSerializer::IsSerialized(const std::string& filepath)
+	void PhysicsMeshSerializer::DeleteIfSerialized(const DerivedDataKey& key)
 	{
-		if (!FileSystem::Exists(Utils::GetCacheDirectory()))
-			FileSystem::CreateFolder(Utils::GetCacheDirectory());
-
-		std::filesystem::path path = filepath;
-		std::string cachePath = Utils::GetCacheDirectory() + path.filename().string() + ".pxm";
-		return FileSystem::Exists(cachePath);
+		DerivedDataCache::Remove(key);
 	}
 
-	Buffer PhysicsMeshSerializer::DeserializeMesh(const std::string& filepath)
+	void PhysicsMeshSerializer::SerializeMesh(const DerivedDataKey& key, const Buffer& data)
 	{
-		if (!FileSystem::Exists(Utils::GetCacheDirectory()))
-			FileSystem::CreateFolder(Utils::GetCacheDirectory());
-
-		std::filesystem::path path = filepath;
-		std::string cachePath = Utils::GetCacheDirectory() + path.filename().string() + ".pxm";
-		FILE* f = fopen(cachePath.c_str(), "rb");
-		uint32_t size = 0;
-
-		Buffer buffer;
-
-		if (f)
-		{
-			fseek(f, 0, SEEK_END);
-			size = ftell(f);
-			fseek(f, 0, SEEK_SET);
-
-			buffer.Allocate(size);
-			fread(buffer.Data, sizeof(byte), size / sizeof(byte), f);
-
-			fclose(f);
-		}
+		DerivedDataCache::Put(key, data.Data, data.Size);
+	}
 
-		return buffer;
+	bool PhysicsMeshSerializer::DeserializeMesh(const DerivedDataKey& key, Buffer& outData)
+	{
+		return DerivedDataCache::Get(key, outData);
 	}
-}
\ No newline at end of file
+}
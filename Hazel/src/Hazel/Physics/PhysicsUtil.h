@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Hazel/Scene/Components.h"
+#include "Hazel/Asset/DerivedDataCache.h"
 
 #include <PhysX/PxPhysicsAPI.h>
 #include <glm/gtc/type_ptr.hpp>
@@ -25,13 +26,20 @@ namespace Hazel {
 	physx::PxFilterFlags HazelFilterShader(physx::PxFilterObjectAttributes attributes0, physx::PxFilterData filterData0, physx::PxFilterObjectAttributes attributes1,
 		physx::PxFilterData filterData1, physx::PxPairFlags& pairFlags, const void* constantBlock, physx::PxU32 constantBlockSize);
 
+	enum class CookedColliderType
+	{
+		Convex, Triangle
+	};
+
 	class PhysicsMeshSerializer
 	{
 	public:
-		static void DeleteIfSerialized(const std::string& filepath);
-		static void SerializeMesh(const std::string& filepath, const Buffer& data);
-		static bool IsSerialized(const std::string& filepath);
-		static Buffer DeserializeMesh(const std::string& filepath);
+		// Covers the mesh data, the collider type and the cooking parameters in use
+		static DerivedDataKey GetCacheKey(const Ref<Mesh>& mesh, CookedColliderType type, const physx::PxCookingParams& params);
+
+		static void DeleteIfSerialized(const DerivedDataKey& key);
+		static void SerializeMesh(const DerivedDataKey& key, const Buffer& data);
+		static bool DeserializeMesh(const DerivedDataKey& key, Buffer& outData);
 	};
 
 }
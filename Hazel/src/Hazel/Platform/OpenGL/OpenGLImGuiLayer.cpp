@@ -92,20 +92,26 @@ namespace Hazel {
 		Application& app = Application::Get();
 		io.DisplaySize = ImVec2(app.GetWindow().GetWidth(), app.GetWindow().GetHeight());
 
-		// Render to swapchain... how do we handle this better?
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-		// Rendering
 		ImGui::Render();
-		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
-		if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
+		// OpenGL always renders single threaded, so the draw data is still this frame's when the command runs
+		Renderer::Submit([]()
 		{
-			GLFWwindow* backup_current_context = glfwGetCurrentContext();
-			ImGui::UpdatePlatformWindows();
-			ImGui::RenderPlatformWindowsDefault();
-			glfwMakeContextCurrent(backup_current_context);
-		}
+			// Render to swapchain... how do we handle this better?
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+			// Rendering
+			ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+			ImGuiIO& io = ImGui::GetIO();
+			if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
+			{
+				GLFWwindow* backup_current_context = glfwGetCurrentContext();
+				ImGui::UpdatePlatformWindows();
+				ImGui::RenderPlatformWindowsDefault();
+				glfwMakeContextCurrent(backup_current_context);
+			}
+		});
 	}
 
 	void OpenGLImGuiLayer::OnImGuiRender()
@@ -22,6 +22,8 @@ namespace Hazel {
 			case ShaderDataType::Int3:     return GL_INT;
 			case ShaderDataType::Int4:     return GL_INT;
 			case ShaderDataType::Bool:     return GL_BOOL;
+			case ShaderDataType::Half2:    return GL_HALF_FLOAT;
+			case ShaderDataType::Short4Norm: return GL_SHORT;
 		}
 
 		HZ_CORE_ASSERT(false, "Unknown ShaderDataType!");
@@ -80,7 +82,7 @@ namespace Hazel {
 					glVertexAttribPointer(attribIndex,
 						element.GetComponentCount(),
 						glBaseType,
-						element.Normalized ? GL_TRUE : GL_FALSE,
+						element.Normalized || element.Type == ShaderDataType::Short4Norm ? GL_TRUE : GL_FALSE,
 						layout.GetStride(),
 						(const void*)(intptr_t)element.Offset);
 				}
@@ -117,7 +119,7 @@ namespace Hazel {
 					glVertexAttribPointer(attribIndex,
 						element.GetComponentCount(),
 						glBaseType,
-						element.Normalized ? GL_TRUE : GL_FALSE,
+						element.Normalized || element.Type == ShaderDataType::Short4Norm ? GL_TRUE : GL_FALSE,
 						layout.GetStride(),
 						(const void*)(intptr_t)element.Offset);
 				}
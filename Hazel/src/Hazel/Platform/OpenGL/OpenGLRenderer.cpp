@@ -344,15 +344,18 @@ namespace Hazel {
 		return { envFiltered, irradianceMap };
 	}
 
-	void OpenGLRenderer::RenderMesh(Ref<Pipeline> pipeline, Ref<Mesh> mesh, const glm::mat4& transform)
+	void OpenGLRenderer::RenderMesh(Ref<Pipeline> pipeline, Ref<Mesh> mesh, const glm::mat4& transform, const uint8_t* submeshLODs)
 	{
 		mesh->m_VertexBuffer->Bind();
 		pipeline->Bind();
 		mesh->m_IndexBuffer->Bind();
 
 		auto& materials = mesh->GetMaterials();
-		for (Submesh& submesh : mesh->m_Submeshes)
+		for (size_t i = 0; i < mesh->m_Submeshes.size(); i++)
 		{
+			const Submesh& submesh = mesh->m_Submeshes[i];
+			SubmeshLOD lod = submesh.GetLOD(submeshLODs ? submeshLODs[i] : 0);
+
 			// Material
 			auto material = materials[submesh.MaterialIndex].As<OpenGLMaterial>();
 			auto shader = material->GetShader();
@@ -367,22 +370,25 @@ namespace Hazel {
 				}
 			}
 
-			auto transformUniform = transform * submesh.Transform;
+			auto transformUniform = transform * submesh.Transform * submesh.DequantizeTransform;
 			shader->SetMat4("u_Renderer.Transform", transformUniform);
 
-			Renderer::Submit([submesh, material]()
+			// Only plain values are captured, no reference counting per draw
+			bool depthTest = material->GetFlag(MaterialFlag::DepthTest);
+			uint32_t baseVertex = submesh.BaseVertex;
+			Renderer::Submit([lod, baseVertex, depthTest]()
 			{
-				if (material->GetFlag(MaterialFlag::DepthTest))
+				if (depthTest)
 					glEnable(GL_DEPTH_TEST);
 				else
 					glDisable(GL_DEPTH_TEST);
 
-				glDrawElementsBaseVertex(GL_TRIANGLES, submesh.IndexCount, GL_UNSIGNED_INT, (void*)(sizeof(uint32_t) * submesh.BaseIndex), submesh.BaseVertex);
+				glDrawElementsBaseVertex(GL_TRIANGLES, lod.IndexCount, GL_UNSIGNED_INT, (void*)(sizeof(uint32_t) * lod.BaseIndex), baseVertex);
 			});
 		}
 	}
 
-	void OpenGLRenderer::RenderMeshWithoutMaterial(Ref<Pipeline> pipeline, Ref<Mesh> mesh, const glm::mat4& transform)
+	void OpenGLRenderer::RenderMeshWithoutMaterial(Ref<Pipeline> pipeline, Ref<Mesh> mesh, const glm::mat4& transform, const uint8_t* submeshLODs)
 	{
 		mesh->m_VertexBuffer->Bind();
 		pipeline->Bind();
@@ -391,8 +397,11 @@ namespace Hazel {
 		auto shader = pipeline->GetSpecification().Shader;
 		shader->Bind();
 
-		for (Submesh& submesh : mesh->m_Submeshes)
+		for (size_t i = 0; i < mesh->m_Submeshes.size(); i++)
 		{
+			const Submesh& submesh = mesh->m_Submeshes[i];
+			SubmeshLOD lod = submesh.GetLOD(submeshLODs ? submeshLODs[i] : 0);
+
 			if (false && mesh->m_IsAnimated)
 			{
 				for (size_t i = 0; i < mesh->m_BoneTransforms.size(); i++)
@@ -402,12 +411,13 @@ namespace Hazel {
 				}
 			}
 
-			auto transformUniform = transform * submesh.Transform;
+			auto transformUniform = transform * submesh.Transform * submesh.DequantizeTransform;
 			shader->SetMat4("u_Renderer.Transform", transformUniform);
 
-			Renderer::Submit([submesh]()
+			uint32_t baseVertex = submesh.BaseVertex;
+			Renderer::Submit([lod, baseVertex]()
 			{
-				glDrawElementsBaseVertex(GL_TRIANGLES, submesh.IndexCount, GL_UNSIGNED_INT, (void*)(sizeof(uint32_t) * submesh.BaseIndex), submesh.BaseVertex);
+				glDrawElementsBaseVertex(GL_TRIANGLES, lod.IndexCount, GL_UNSIGNED_INT, (void*)(sizeof(uint32_t) * lod.BaseIndex), baseVertex);
 			});
 		}
 	}
@@ -423,9 +433,10 @@ namespace Hazel {
 		auto shader = material->GetShader();
 		shader->SetMat4("u_Renderer.Transform", transform);
 
-		Renderer::Submit([material]()
+		bool depthTest = material->GetFlag(MaterialFlag::DepthTest);
+		Renderer::Submit([depthTest]()
 		{
-			if (material->GetFlag(MaterialFlag::DepthTest))
+			if (depthTest)
 				glEnable(GL_DEPTH_TEST);
 			else
 				glDisable(GL_DEPTH_TEST);
@@ -13,6 +13,8 @@
 #include <filesystem>
 
 #include "Hazel/Utilities/FileSystem.h"
+#include "Hazel/Utilities/VirtualFileSystem.h"
+#include "Hazel/Asset/DerivedDataCache.h"
 
 namespace Hazel {
 
@@ -25,23 +27,6 @@ namespace Hazel {
 
 #define PRINT_SHADERS 1
 
-	namespace Utils {
-
-		static const char* GetCacheDirectory()
-		{
-			// TODO: make sure the assets directory is valid
-			return "assets/cache/shader/opengl";
-		}
-		
-		static void CreateCacheDirectoryIfNeeded()
-		{
-			std::string cacheDirectory = GetCacheDirectory();
-			if (!std::filesystem::exists(cacheDirectory))
-				std::filesystem::create_directories(cacheDirectory);
-		}
-		
-	}
-
 	OpenGLShader::OpenGLShader(const std::string& filepath, bool forceRecompile)
 		: m_AssetPath(filepath)
 	{
@@ -69,7 +54,6 @@ namespace Hazel {
 	void OpenGLShader::Load(const std::string& source, bool forceCompile)
 	{
 		m_ShaderSource = PreProcess(source);
-		Utils::CreateCacheDirectoryIfNeeded();
 		Ref<OpenGLShader> instance = this;
 		Renderer::Submit([instance, forceCompile]() mutable
 		{
@@ -85,28 +69,15 @@ namespace Hazel {
 		s_UniformBuffers.clear();
 	}
 
-	static const char* GLShaderStageCachedVulkanFileExtension(uint32_t stage)
+	static bool GetCachedBinary(const DerivedDataKey& key, std::vector<uint32_t>& outBinary)
 	{
-		switch (stage)
-		{
-			case GL_VERTEX_SHADER:    return ".cached_vulkan.vert";
-			case GL_FRAGMENT_SHADER:  return ".cached_vulkan.frag";
-			case GL_COMPUTE_SHADER:   return ".cached_vulkan.comp";
-		}
-		HZ_CORE_ASSERT(false);
-		return "";
-	}
+		Buffer cachedBinary;
+		if (!DerivedDataCache::Get(key, cachedBinary))
+			return false;
 
-	static const char* GLShaderStageCachedOpenGLFileExtension(uint32_t stage)
-	{
-		switch (stage)
-		{
-		case GL_VERTEX_SHADER:    return ".cached_opengl.vert";
-		case GL_FRAGMENT_SHADER:  return ".cached_opengl.frag";
-		case GL_COMPUTE_SHADER:   return ".cached_opengl.comp";
-		}
-		HZ_CORE_ASSERT(false);
-		return "";
+		outBinary = std::vector<uint32_t>((uint32_t*)cachedBinary.Data, (uint32_t*)cachedBinary.Data + cachedBinary.Size / sizeof(uint32_t));
+		cachedBinary.Release();
+		return true;
 	}
 
 	static shaderc_shader_kind GLShaderStageToShaderC(uint32_t stage)
@@ -135,28 +106,15 @@ namespace Hazel {
 
 	void OpenGLShader::CompileOrGetVulkanBinary(std::unordered_map<uint32_t, std::vector<uint32_t>>& outputBinary, bool forceCompile)
 	{
-		std::filesystem::path cacheDirectory = Utils::GetCacheDirectory();
+		const bool optimize = false;
+
 		for (auto [stage, source] : m_ShaderSource)
 		{
-			auto extension = GLShaderStageCachedVulkanFileExtension(stage);
-			std::filesystem::path p = m_AssetPath;
-			if (!forceCompile)
-			{
-				std::filesystem::path p = m_AssetPath;
-				auto path = cacheDirectory / (p.filename().string() + extension);
-				std::string cachedFilePath = path.string();
+			DerivedDataKey cacheKey("shader/opengl");
+			cacheKey.Add("vulkan").Add(source).Add(stage).Add((uint32_t)shaderc_env_version_vulkan_1_2).Add(optimize);
 
-				FILE* f = fopen(cachedFilePath.c_str(), "rb");
-				if (f)
-				{
-					fseek(f, 0, SEEK_END);
-					uint64_t size = ftell(f);
-					fseek(f, 0, SEEK_SET);
-					outputBinary[stage] = std::vector<uint32_t>(size / sizeof(uint32_t));
-					fread(outputBinary[stage].data(), sizeof(uint32_t), outputBinary[stage].size(), f);
-					fclose(f);
-				}
-			}
+			if (!forceCompile)
+				GetCachedBinary(cacheKey, outputBinary[stage]);
 
 			if (outputBinary[stage].size() == 0)
 			{
@@ -165,7 +123,6 @@ namespace Hazel {
 				shaderc::CompileOptions options;
 				options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_2);
 				options.AddMacroDefinition("OPENGL");
-				const bool optimize = false;
 				if (optimize)
 					options.SetOptimizationLevel(shaderc_optimization_level_performance);
 
@@ -188,15 +145,7 @@ namespace Hazel {
 				}
 
 				// Cache compiled shader
-				{
-					std::filesystem::path p = m_AssetPath;
-					auto path = cacheDirectory / (p.filename().string() + extension);
-					std::string cachedFilePath = path.string();
-
-					FILE* f = fopen(cachedFilePath.c_str(), "wb");
-					fwrite(outputBinary[stage].data(), sizeof(uint32_t), outputBinary[stage].size(), f);
-					fclose(f);
-				}
+				DerivedDataCache::Put(cacheKey, outputBinary[stage].data(), outputBinary[stage].size() * sizeof(uint32_t));
 			}
 		}
 	}
@@ -212,8 +161,6 @@ namespace Hazel {
 		std::vector<GLuint> shaderRendererIDs;
 		shaderRendererIDs.reserve(vulkanBinaries.size());
 
-		std::filesystem::path cacheDirectory = Utils::GetCacheDirectory();
-		
 		m_ConstantBufferOffset = 0;
 		std::vector<std::vector<uint32_t>> shaderData;
 		for (auto [stage, binary] : vulkanBinaries)
@@ -226,25 +173,14 @@ namespace Hazel {
 				spirv_cross::CompilerGLSL glsl(binary);
 				ParseConstantBuffers(glsl);
 
-				std::filesystem::path p = m_AssetPath;
-				auto path = cacheDirectory / (p.filename().string() + GLShaderStageCachedOpenGLFileExtension(stage));
-				std::string cachedFilePath = path.string();
+				// Derived from the Vulkan binary, which already captures the source
+				DerivedDataKey cacheKey("shader/opengl");
+				cacheKey.Add("opengl").Add(binary.data(), binary.size() * sizeof(uint32_t)).Add(stage).Add((uint32_t)shaderc_env_version_opengl_4_5);
 
 				std::vector<uint32_t>& shaderStageData = shaderData.emplace_back();
 
 				if (!forceCompile)
-				{
-					FILE* f = fopen(cachedFilePath.c_str(), "rb");
-					if (f)
-					{
-						fseek(f, 0, SEEK_END);
-						uint64_t size = ftell(f);
-						fseek(f, 0, SEEK_SET);
-						shaderStageData = std::vector<uint32_t>(size / sizeof(uint32_t));
-						fread(shaderStageData.data(), sizeof(uint32_t), shaderStageData.size(), f);
-						fclose(f);
-					}
-				}
+					GetCachedBinary(cacheKey, shaderStageData);
 				
 				if (!shaderStageData.size())
 				{
@@ -264,14 +200,7 @@ namespace Hazel {
 
 					shaderStageData = std::vector<uint32_t>(module.cbegin(), module.cend());
 
-					{
-						std::filesystem::path p = m_AssetPath;
-						auto path = cacheDirectory / (p.filename().string() + GLShaderStageCachedOpenGLFileExtension(stage));
-						std::string cachedFilePath = path.string();
-						FILE* f = fopen(cachedFilePath.c_str(), "wb");
-						fwrite(shaderStageData.data(), sizeof(uint32_t), shaderStageData.size(), f);
-						fclose(f);
-					}
+					DerivedDataCache::Put(cacheKey, shaderStageData.data(), shaderStageData.size() * sizeof(uint32_t));
 				}
 
 				GLuint shaderID = glCreateShader(stage);
@@ -486,21 +415,14 @@ namespace Hazel {
 
 	std::string OpenGLShader::ReadShaderFromFile(const std::string& filepath) const
 	{
-		std::string result;
-		std::ifstream in(filepath, std::ios::in | std::ios::binary);
-		if (in)
-		{
-			in.seekg(0, std::ios::end);
-			result.resize(in.tellg());
-			in.seekg(0, std::ios::beg);
-			in.read(&result[0], result.size());
-		}
-		else
+		FileView file;
+		if (!VirtualFileSystem::ReadFile(filepath, file))
 		{
 			HZ_CORE_ASSERT(false, "Could not load shader!");
+			return std::string();
 		}
-		in.close();
-		return result;
+
+		return std::string(file.GetString());
 	}
 
 	std::unordered_map<GLenum, std::string> OpenGLShader::PreProcess(const std::string& source)
@@ -9,6 +9,7 @@
 #include "Hazel/Renderer/RendererAPI.h"
 
 #include "Hazel/Platform/OpenGL/OpenGLImage.h"
+#include "Hazel/Utilities/VirtualFileSystem.h"
 
 namespace Hazel {
 
@@ -29,12 +30,18 @@ namespace Hazel {
 	OpenGLTexture2D::OpenGLTexture2D(const std::string& path, TextureProperties properties)
 		: m_FilePath(path), m_Properties(properties)
 	{
+		// Decoded straight from the mapped file (or pak entry)
+		FileView file;
+		VirtualFileSystem::ReadFile(path, file);
+		const stbi_uc* fileData = file.GetData();
+		int fileSize = (int)file.GetSize();
+
 		int width, height, channels;
-		if (stbi_is_hdr(path.c_str()))
+		if (stbi_is_hdr_from_memory(fileData, fileSize))
 		{
 			HZ_CORE_INFO("Loading HDR texture {0}, srgb={1}", path, properties.SRGB);
 
-			float* imageData = stbi_loadf(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+			float* imageData = stbi_loadf_from_memory(fileData, fileSize, &width, &height, &channels, STBI_rgb_alpha);
 			HZ_CORE_ASSERT(imageData);
 			Buffer buffer(imageData, Utils::GetImageMemorySize(ImageFormat::RGBA32F, width, height));
 			m_Image = Image2D::Create(ImageFormat::RGBA32F, width, height, buffer);
@@ -43,7 +50,7 @@ namespace Hazel {
 		{
 			HZ_CORE_INFO("Loading texture {0}, srgb={1}", path, properties.SRGB);
 
-			stbi_uc* imageData = stbi_load(path.c_str(), &width, &height, &channels, properties.SRGB ? STBI_rgb : STBI_rgb_alpha);
+			stbi_uc* imageData = stbi_load_from_memory(fileData, fileSize, &width, &height, &channels, properties.SRGB ? STBI_rgb : STBI_rgb_alpha);
 			HZ_CORE_ASSERT(imageData);
 			//ImageFormat format = channels == 4 ? ImageFormat::RGBA : ImageFormat::RGB;
 			ImageFormat format = properties.SRGB ? ImageFormat::RGB : ImageFormat::RGBA;
@@ -19,6 +19,32 @@ namespace Hazel {
 
 	static VkCommandBuffer s_ImGuiCommandBuffer;
 
+	// Copy of a frame's draw data. The render thread renders it while the main thread already builds the next ImGui frame.
+	struct ImGuiDrawDataSnapshot
+	{
+		ImDrawData DrawData;
+		std::vector<ImDrawList*> DrawLists;
+
+		ImGuiDrawDataSnapshot(const ImDrawData* drawData)
+			: DrawData(*drawData)
+		{
+			DrawLists.reserve(drawData->CmdListsCount);
+			for (int i = 0; i < drawData->CmdListsCount; i++)
+				DrawLists.push_back(drawData->CmdLists[i]->CloneOutput());
+			DrawData.CmdLists = DrawLists.data();
+		}
+
+		~ImGuiDrawDataSnapshot()
+		{
+			for (ImDrawList* drawList : DrawLists)
+				IM_DELETE(drawList);
+		}
+	};
+
+	// One per render command queue; a queue is only recorded into again once it has been executed,
+	// so the snapshot it was rendering can be freed on the main thread
+	static std::vector<std::unique_ptr<ImGuiDrawDataSnapshot>> s_DrawDataSnapshots;
+
 	VulkanImGuiLayer::VulkanImGuiLayer()
 	{
 	}
@@ -146,6 +172,9 @@ namespace Hazel {
 
 	void VulkanImGuiLayer::OnDetach()
 	{
+		Renderer::GetRenderThread().BlockUntilRenderComplete();
+		s_DrawDataSnapshots.clear();
+
 		Renderer::Submit([]()
 		{
 			auto device = VulkanContext::GetCurrentDevice()->GetVulkanDevice();
@@ -159,6 +188,10 @@ namespace Hazel {
 
 	void VulkanImGuiLayer::Begin()
 	{
+		// Platform windows are rendered straight from ImGui's viewports, which NewFrame is about to reset
+		if (ImGui::GetPlatformIO().Viewports.Size > 1)
+			Renderer::GetRenderThread().BlockUntilRenderComplete();
+
 		ImGui_ImplVulkan_NewFrame();
 		ImGui_ImplGlfw_NewFrame();
 		ImGui::NewFrame();
@@ -169,78 +202,91 @@ namespace Hazel {
 	{
 		ImGui::Render();
 
-		Ref<VulkanContext> context = VulkanContext::Get();
-		VulkanSwapChain& swapChain = context->GetSwapChain();
-		VkCommandBuffer drawCommandBuffer = swapChain.GetCurrentDrawCommandBuffer();
-
-		VkClearValue clearValues[2];
-		clearValues[0].color = { {0.1f, 0.1f,0.1f, 1.0f} };
-		clearValues[1].depthStencil = { 1.0f, 0 };
-
-		uint32_t width = swapChain.GetWidth();
-		uint32_t height = swapChain.GetHeight();
-
-		VkRenderPassBeginInfo renderPassBeginInfo = {};
-		renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-		renderPassBeginInfo.pNext = nullptr;
-		renderPassBeginInfo.renderPass = swapChain.GetRenderPass();
-		renderPassBeginInfo.renderArea.offset.x = 0;
-		renderPassBeginInfo.renderArea.offset.y = 0;
-		renderPassBeginInfo.renderArea.extent.width = width;
-		renderPassBeginInfo.renderArea.extent.height = height;
-		renderPassBeginInfo.clearValueCount = 2; // Color + depth
-		renderPassBeginInfo.pClearValues = clearValues;
-		renderPassBeginInfo.framebuffer = swapChain.GetCurrentFramebuffer();
-
-		vkCmdBeginRenderPass(drawCommandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
-
-		VkCommandBufferInheritanceInfo inheritanceInfo = {};
-		inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
-		inheritanceInfo.renderPass = swapChain.GetRenderPass();
-		inheritanceInfo.framebuffer = swapChain.GetCurrentFramebuffer();
-
-		VkCommandBufferBeginInfo cmdBufInfo = {};
-		cmdBufInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-		cmdBufInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
-		cmdBufInfo.pInheritanceInfo = &inheritanceInfo;
-
-		VK_CHECK_RESULT(vkBeginCommandBuffer(s_ImGuiCommandBuffer, &cmdBufInfo));
-
-		VkViewport viewport = {};
-		viewport.x = 0.0f;
-		viewport.y = (float)height;
-		viewport.height = -(float)height;
-		viewport.width = (float)width;
-		viewport.minDepth = 0.0f;
-		viewport.maxDepth = 1.0f;
-		vkCmdSetViewport(s_ImGuiCommandBuffer, 0, 1, &viewport);
-
-		VkRect2D scissor = {};
-		scissor.extent.width = width;
-		scissor.extent.height = height;
-		scissor.offset.x = 0;
-		scissor.offset.y = 0;
-		vkCmdSetScissor(s_ImGuiCommandBuffer, 0, 1, &scissor);
-
-		ImDrawData* main_draw_data = ImGui::GetDrawData();
-		ImGui_ImplVulkan_RenderDrawData(main_draw_data, s_ImGuiCommandBuffer);
-
-		VK_CHECK_RESULT(vkEndCommandBuffer(s_ImGuiCommandBuffer));
-
-		std::vector<VkCommandBuffer> commandBuffers;
-		commandBuffers.push_back(s_ImGuiCommandBuffer);
-
-		vkCmdExecuteCommands(drawCommandBuffer, commandBuffers.size(), commandBuffers.data());
-
-		vkCmdEndRenderPass(drawCommandBuffer);
+		RenderThread& renderThread = Renderer::GetRenderThread();
+		s_DrawDataSnapshots.resize(renderThread.GetQueueCount());
+		auto& snapshot = s_DrawDataSnapshots[renderThread.GetSubmitQueueIndex()];
+		snapshot = std::make_unique<ImGuiDrawDataSnapshot>(ImGui::GetDrawData());
+		ImDrawData* drawData = &snapshot->DrawData;
 
 		ImGuiIO& io = ImGui::GetIO(); (void)io;
-		// Update and Render additional Platform Windows
-		if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
+		bool viewportsEnabled = io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable;
+		if (viewportsEnabled)
 		{
+			// Creating or moving platform windows can't overlap with the previous frame rendering them
+			renderThread.BlockUntilRenderComplete();
 			ImGui::UpdatePlatformWindows();
-			ImGui::RenderPlatformWindowsDefault();
 		}
+
+		Renderer::Submit([drawData, viewportsEnabled]()
+		{
+			Ref<VulkanContext> context = VulkanContext::Get();
+			VulkanSwapChain& swapChain = context->GetSwapChain();
+			VkCommandBuffer drawCommandBuffer = swapChain.GetCurrentDrawCommandBuffer();
+
+			VkClearValue clearValues[2];
+			clearValues[0].color = { {0.1f, 0.1f,0.1f, 1.0f} };
+			clearValues[1].depthStencil = { 1.0f, 0 };
+
+			uint32_t width = swapChain.GetWidth();
+			uint32_t height = swapChain.GetHeight();
+
+			VkRenderPassBeginInfo renderPassBeginInfo = {};
+			renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+			renderPassBeginInfo.pNext = nullptr;
+			renderPassBeginInfo.renderPass = swapChain.GetRenderPass();
+			renderPassBeginInfo.renderArea.offset.x = 0;
+			renderPassBeginInfo.renderArea.offset.y = 0;
+			renderPassBeginInfo.renderArea.extent.width = width;
+			renderPassBeginInfo.renderArea.extent.height = height;
+			renderPassBeginInfo.clearValueCount = 2; // Color + depth
+			renderPassBeginInfo.pClearValues = clearValues;
+			renderPassBeginInfo.framebuffer = swapChain.GetCurrentFramebuffer();
+
+			vkCmdBeginRenderPass(drawCommandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+
+			VkCommandBufferInheritanceInfo inheritanceInfo = {};
+			inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+			inheritanceInfo.renderPass = swapChain.GetRenderPass();
+			inheritanceInfo.framebuffer = swapChain.GetCurrentFramebuffer();
+
+			VkCommandBufferBeginInfo cmdBufInfo = {};
+			cmdBufInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+			cmdBufInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+			cmdBufInfo.pInheritanceInfo = &inheritanceInfo;
+
+			VK_CHECK_RESULT(vkBeginCommandBuffer(s_ImGuiCommandBuffer, &cmdBufInfo));
+
+			VkViewport viewport = {};
+			viewport.x = 0.0f;
+			viewport.y = (float)height;
+			viewport.height = -(float)height;
+			viewport.width = (float)width;
+			viewport.minDepth = 0.0f;
+			viewport.maxDepth = 1.0f;
+			vkCmdSetViewport(s_ImGuiCommandBuffer, 0, 1, &viewport);
+
+			VkRect2D scissor = {};
+			scissor.extent.width = width;
+			scissor.extent.height = height;
+			scissor.offset.x = 0;
+			scissor.offset.y = 0;
+			vkCmdSetScissor(s_ImGuiCommandBuffer, 0, 1, &scissor);
+
+			ImGui_ImplVulkan_RenderDrawData(drawData, s_ImGuiCommandBuffer);
+
+			VK_CHECK_RESULT(vkEndCommandBuffer(s_ImGuiCommandBuffer));
+
+			std::vector<VkCommandBuffer> commandBuffers;
+			commandBuffers.push_back(s_ImGuiCommandBuffer);
+
+			vkCmdExecuteCommands(drawCommandBuffer, commandBuffers.size(), commandBuffers.data());
+
+			vkCmdEndRenderPass(drawCommandBuffer);
+
+			// Render additional Platform Windows
+			if (viewportsEnabled)
+				ImGui::RenderPlatformWindowsDefault();
+		});
 	}
 
 	void VulkanImGuiLayer::OnImGuiRender()
@@ -17,6 +17,8 @@ namespace Hazel {
 			case ShaderDataType::Float2:    return VK_FORMAT_R32G32_SFLOAT;
 			case ShaderDataType::Float3:    return VK_FORMAT_R32G32B32_SFLOAT;
 			case ShaderDataType::Float4:    return VK_FORMAT_R32G32B32A32_SFLOAT;
+			case ShaderDataType::Half2:     return VK_FORMAT_R16G16_SFLOAT;
+			case ShaderDataType::Short4Norm: return VK_FORMAT_R16G16B16A16_SNORM;
 		}
 		HZ_CORE_ASSERT(false);
 		return VK_FORMAT_UNDEFINED;
@@ -7,6 +7,7 @@
 #include "VulkanContext.h"
 
 #include "Hazel/Renderer/Renderer.h"
+#include "Hazel/Core/FrameAllocator.h"
 
 #include "Hazel/Platform/Vulkan/VulkanPipeline.h"
 #include "Hazel/Platform/Vulkan/VulkanVertexBuffer.h"
@@ -124,33 +125,40 @@ namespace Hazel {
 		return s_Data->RenderCaps;
 	}
 
-	void VulkanRenderer::RenderMesh(Ref<Pipeline> pipeline, Ref<Mesh> mesh, const glm::mat4& transform)
+	void VulkanRenderer::RenderMesh(Ref<Pipeline> pipeline, Ref<Mesh> mesh, const glm::mat4& transform, const uint8_t* submeshLODs)
 	{
-		Renderer::Submit([pipeline, mesh, transform]() mutable
+		// Kept alive by the frame, the commands only capture raw pointers
+		VulkanPipeline* vulkanPipeline = (VulkanPipeline*)FrameAllocator::KeepAlive(pipeline);
+		Mesh* rawMesh = FrameAllocator::KeepAlive(mesh);
+
+		Renderer::Submit([vulkanPipeline, rawMesh]()
 		{
-			auto vulkanMeshVB = mesh->GetVertexBuffer().As<VulkanVertexBuffer>();
-			VkBuffer vbMeshBuffer = vulkanMeshVB->GetVulkanBuffer();
+			VkBuffer vbMeshBuffer = ((VulkanVertexBuffer*)rawMesh->GetVertexBuffer().Raw())->GetVulkanBuffer();
 			VkDeviceSize offsets[1] = { 0 };
 			vkCmdBindVertexBuffers(s_Data->ActiveCommandBuffer, 0, 1, &vbMeshBuffer, offsets);
 
-			auto vulkanMeshIB = Ref<VulkanIndexBuffer>(mesh->GetIndexBuffer());
-			VkBuffer ibBuffer = vulkanMeshIB->GetVulkanBuffer();
+			VkBuffer ibBuffer = ((VulkanIndexBuffer*)rawMesh->GetIndexBuffer().Raw())->GetVulkanBuffer();
 			vkCmdBindIndexBuffer(s_Data->ActiveCommandBuffer, ibBuffer, 0, VK_INDEX_TYPE_UINT32);
 
-			Ref<VulkanPipeline> vulkanPipeline = pipeline.As<VulkanPipeline>();
 			VkPipeline pipeline = vulkanPipeline->GetVulkanPipeline();
 			vkCmdBindPipeline(s_Data->ActiveCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
 		});
 
 		auto& submeshes = mesh->GetSubmeshes();
-		for (Submesh& submesh : submeshes)
+		auto& materials = mesh->GetMaterials();
+		for (size_t i = 0; i < submeshes.size(); i++)
 		{
-			auto& material = mesh->GetMaterials()[submesh.MaterialIndex].As<VulkanMaterial>();
+			const Submesh& submesh = submeshes[i];
+			SubmeshLOD lod = submesh.GetLOD(submeshLODs ? submeshLODs[i] : 0);
+			glm::mat4 worldTransform = transform * submesh.Transform * submesh.DequantizeTransform;
+			uint32_t baseVertex = submesh.BaseVertex;
+
+			// The mesh keeps its materials alive
+			VulkanMaterial* material = (VulkanMaterial*)materials[submesh.MaterialIndex].Raw();
 			material->UpdateForRendering();
 
-			Renderer::Submit([pipeline, submesh, material, transform]() mutable
+			Renderer::Submit([vulkanPipeline, material, lod, baseVertex, worldTransform]()
 			{
-				Ref<VulkanPipeline> vulkanPipeline = pipeline.As<VulkanPipeline>();
 				VkPipelineLayout layout = vulkanPipeline->GetVulkanPipelineLayout();
 
 				// Bind descriptor sets describing shader binding points
@@ -160,36 +168,39 @@ namespace Hazel {
 				};
 				vkCmdBindDescriptorSets(s_Data->ActiveCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, descriptorSets.size(), descriptorSets.data(), 0, nullptr);
 
-				glm::mat4 worldTransform = transform * submesh.Transform;
-
 				Buffer uniformStorageBuffer = material->GetUniformStorageBuffer();
 				vkCmdPushConstants(s_Data->ActiveCommandBuffer, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4), &worldTransform);
 				vkCmdPushConstants(s_Data->ActiveCommandBuffer, layout, VK_SHADER_STAGE_FRAGMENT_BIT, sizeof(glm::mat4), uniformStorageBuffer.Size, uniformStorageBuffer.Data);
-				vkCmdDrawIndexed(s_Data->ActiveCommandBuffer, submesh.IndexCount, 1, submesh.BaseIndex, submesh.BaseVertex, 0);
+				vkCmdDrawIndexed(s_Data->ActiveCommandBuffer, lod.IndexCount, 1, lod.BaseIndex, baseVertex, 0);
 			});
 		}
 	}
 
-	void VulkanRenderer::RenderMeshWithoutMaterial(Ref<Pipeline> pipeline, Ref<Mesh> mesh, const glm::mat4& transform)
+	void VulkanRenderer::RenderMeshWithoutMaterial(Ref<Pipeline> pipeline, Ref<Mesh> mesh, const glm::mat4& transform, const uint8_t* submeshLODs)
 	{
-		Renderer::Submit([pipeline, mesh, transform]() mutable
+		VulkanPipeline* vulkanPipeline = (VulkanPipeline*)FrameAllocator::KeepAlive(pipeline);
+		Mesh* rawMesh = FrameAllocator::KeepAlive(mesh);
+
+		Renderer::Submit([rawMesh]()
 		{
-			auto vulkanMeshVB = mesh->GetVertexBuffer().As<VulkanVertexBuffer>();
-			VkBuffer vbMeshBuffer = vulkanMeshVB->GetVulkanBuffer();
+			VkBuffer vbMeshBuffer = ((VulkanVertexBuffer*)rawMesh->GetVertexBuffer().Raw())->GetVulkanBuffer();
 			VkDeviceSize offsets[1] = { 0 };
 			vkCmdBindVertexBuffers(s_Data->ActiveCommandBuffer, 0, 1, &vbMeshBuffer, offsets);
 
-			auto vulkanMeshIB = Ref<VulkanIndexBuffer>(mesh->GetIndexBuffer());
-			VkBuffer ibBuffer = vulkanMeshIB->GetVulkanBuffer();
+			VkBuffer ibBuffer = ((VulkanIndexBuffer*)rawMesh->GetIndexBuffer().Raw())->GetVulkanBuffer();
 			vkCmdBindIndexBuffer(s_Data->ActiveCommandBuffer, ibBuffer, 0, VK_INDEX_TYPE_UINT32);
 		});
 		
 		auto& submeshes = mesh->GetSubmeshes();
-		for (Submesh& submesh : submeshes)
+		for (size_t i = 0; i < submeshes.size(); i++)
 		{
-			Renderer::Submit([pipeline, submesh, transform]() mutable
+			const Submesh& submesh = submeshes[i];
+			SubmeshLOD lod = submesh.GetLOD(submeshLODs ? submeshLODs[i] : 0);
+			glm::mat4 worldTransform = transform * submesh.Transform * submesh.DequantizeTransform;
+			uint32_t baseVertex = submesh.BaseVertex;
+
+			Renderer::Submit([vulkanPipeline, lod, baseVertex, worldTransform]()
 			{
-				Ref<VulkanPipeline> vulkanPipeline = pipeline.As<VulkanPipeline>();
 				VkPipeline pipeline = vulkanPipeline->GetVulkanPipeline();
 				VkPipelineLayout layout = vulkanPipeline->GetVulkanPipelineLayout();
 				vkCmdBindPipeline(s_Data->ActiveCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
@@ -200,31 +211,27 @@ namespace Hazel {
 				};
 				vkCmdBindDescriptorSets(s_Data->ActiveCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1, &descriptorSet, 0, nullptr);
 
-				glm::mat4 worldTransform = transform * submesh.Transform;
 				vkCmdPushConstants(s_Data->ActiveCommandBuffer, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4), &worldTransform);
-				vkCmdDrawIndexed(s_Data->ActiveCommandBuffer, submesh.IndexCount, 1, submesh.BaseIndex, submesh.BaseVertex, 0);
+				vkCmdDrawIndexed(s_Data->ActiveCommandBuffer, lod.IndexCount, 1, lod.BaseIndex, baseVertex, 0);
 			});
 		}
 	}
 
 	void VulkanRenderer::RenderQuad(Ref<Pipeline> pipeline, Ref<Material> material, const glm::mat4& transform)
 	{
-		Ref<VulkanMaterial> vulkanMaterial = material.As<VulkanMaterial>();
+		VulkanPipeline* vulkanPipeline = (VulkanPipeline*)FrameAllocator::KeepAlive(pipeline);
+		VulkanMaterial* vulkanMaterial = (VulkanMaterial*)FrameAllocator::KeepAlive(material);
 		vulkanMaterial->UpdateForRendering();
 
-		Renderer::Submit([pipeline, vulkanMaterial, transform]() mutable
+		Renderer::Submit([vulkanPipeline, vulkanMaterial, transform]()
 		{
-			Ref<VulkanPipeline> vulkanPipeline = pipeline.As<VulkanPipeline>();
-
 			VkPipelineLayout layout = vulkanPipeline->GetVulkanPipelineLayout();
 
-			auto vulkanMeshVB = s_Data->QuadVertexBuffer.As<VulkanVertexBuffer>();
-			VkBuffer vbMeshBuffer = vulkanMeshVB->GetVulkanBuffer();
+			VkBuffer vbMeshBuffer = ((VulkanVertexBuffer*)s_Data->QuadVertexBuffer.Raw())->GetVulkanBuffer();
 			VkDeviceSize offsets[1] = { 0 };
 			vkCmdBindVertexBuffers(s_Data->ActiveCommandBuffer, 0, 1, &vbMeshBuffer, offsets);
 
-			auto vulkanMeshIB = s_Data->QuadIndexBuffer.As<VulkanIndexBuffer>();
-			VkBuffer ibBuffer = vulkanMeshIB->GetVulkanBuffer();
+			VkBuffer ibBuffer = ((VulkanIndexBuffer*)s_Data->QuadIndexBuffer.Raw())->GetVulkanBuffer();
 			vkCmdBindIndexBuffer(s_Data->ActiveCommandBuffer, ibBuffer, 0, VK_INDEX_TYPE_UINT32);
 
 			VkPipeline pipeline = vulkanPipeline->GetVulkanPipeline();
@@ -243,22 +250,19 @@ namespace Hazel {
 
 	void VulkanRenderer::SubmitFullscreenQuad(Ref<Pipeline> pipeline, Ref<Material> material)
 	{
-		Ref<VulkanMaterial> vulkanMaterial = material.As<VulkanMaterial>();
+		VulkanPipeline* vulkanPipeline = (VulkanPipeline*)FrameAllocator::KeepAlive(pipeline);
+		VulkanMaterial* vulkanMaterial = (VulkanMaterial*)FrameAllocator::KeepAlive(material);
 		vulkanMaterial->UpdateForRendering();
 
-		Renderer::Submit([pipeline, vulkanMaterial]() mutable
+		Renderer::Submit([vulkanPipeline, vulkanMaterial]()
 		{
-			Ref<VulkanPipeline> vulkanPipeline = pipeline.As<VulkanPipeline>();
-
 			VkPipelineLayout layout = vulkanPipeline->GetVulkanPipelineLayout();
 
-			auto vulkanMeshVB = s_Data->QuadVertexBuffer.As<VulkanVertexBuffer>();
-			VkBuffer vbMeshBuffer = vulkanMeshVB->GetVulkanBuffer();
+			VkBuffer vbMeshBuffer = ((VulkanVertexBuffer*)s_Data->QuadVertexBuffer.Raw())->GetVulkanBuffer();
 			VkDeviceSize offsets[1] = { 0 };
 			vkCmdBindVertexBuffers(s_Data->ActiveCommandBuffer, 0, 1, &vbMeshBuffer, offsets);
 
-			auto vulkanMeshIB = s_Data->QuadIndexBuffer.As<VulkanIndexBuffer>();
-			VkBuffer ibBuffer = vulkanMeshIB->GetVulkanBuffer();
+			VkBuffer ibBuffer = ((VulkanIndexBuffer*)s_Data->QuadIndexBuffer.Raw())->GetVulkanBuffer();
 			vkCmdBindIndexBuffer(s_Data->ActiveCommandBuffer, ibBuffer, 0, VK_INDEX_TYPE_UINT32);
 
 			VkPipeline pipeline = vulkanPipeline->GetVulkanPipeline();
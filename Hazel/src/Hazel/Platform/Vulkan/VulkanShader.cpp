@@ -2,6 +2,8 @@
 #include "VulkanShader.h"
 
 #include "Hazel/Renderer/Renderer.h"
+#include "Hazel/Asset/DerivedDataCache.h"
+#include "Hazel/Utilities/VirtualFileSystem.h"
 
 #include "Hazel/Platform/Vulkan/VulkanContext.h"
 #include <shaderc/shaderc.hpp>
@@ -14,19 +16,6 @@ namespace Hazel {
 
 	namespace Utils {
 
-		static const char* GetCacheDirectory()
-		{
-			// TODO: make sure the assets directory is valid
-			return "assets/cache/shader/vulkan";
-		}
-
-		static void CreateCacheDirectoryIfNeeded()
-		{
-			std::string cacheDirectory = GetCacheDirectory();
-			if (!std::filesystem::exists(cacheDirectory))
-				std::filesystem::create_directories(cacheDirectory);
-		}
-
 		static ShaderUniformType SPIRTypeToShaderUniformType(spirv_cross::SPIRType type)
 		{
 			switch (type.basetype)
@@ -75,21 +64,14 @@ namespace Hazel {
 
 	static std::string ReadShaderFromFile(const std::string& filepath)
 	{
-		std::string result;
-		std::ifstream in(filepath, std::ios::in | std::ios::binary);
-		if (in)
-		{
-			in.seekg(0, std::ios::end);
-			result.resize(in.tellg());
-			in.seekg(0, std::ios::beg);
-			in.read(&result[0], result.size());
-		}
-		else
+		FileView file;
+		if (!VirtualFileSystem::ReadFile(filepath, file))
 		{
 			HZ_CORE_ASSERT(false, "Could not load shader!");
+			return std::string();
 		}
-		in.close();
-		return result;
+
+		return std::string(file.GetString());
 	}
 
 	void VulkanShader::Reload(bool forceCompile)
@@ -107,8 +89,6 @@ namespace Hazel {
 			instance->m_Buffers.clear();
 			instance->m_TypeCounts.clear();
 
-			Utils::CreateCacheDirectoryIfNeeded();
-			
 			// Vertex and Fragment for now
 			std::string source = ReadShaderFromFile(instance->m_AssetPath);
 			instance->m_ShaderSource = instance->PreProcess(source);
@@ -564,18 +544,6 @@ namespace Hazel {
 		uniformBuffer.Descriptor.range = uniformBuffer.Size;
 	}
 
-	static const char* VkShaderStageCachedFileExtension(VkShaderStageFlagBits stage)
-	{
-		switch (stage)
-		{
-			case VK_SHADER_STAGE_VERTEX_BIT:    return ".cached_vulkan.vert";
-			case VK_SHADER_STAGE_FRAGMENT_BIT:  return ".cached_vulkan.frag";
-			case VK_SHADER_STAGE_COMPUTE_BIT:   return ".cached_vulkan.comp";
-		}
-		HZ_CORE_ASSERT(false);
-		return "";
-	}
-
 	static shaderc_shader_kind VkShaderStageToShaderC(VkShaderStageFlagBits stage)
 	{
 		switch (stage)
@@ -590,25 +558,22 @@ namespace Hazel {
 
 	void VulkanShader::CompileOrGetVulkanBinary(std::unordered_map<VkShaderStageFlagBits, std::vector<uint32_t>>& outputBinary, bool forceCompile)
 	{
-		std::filesystem::path cacheDirectory = Utils::GetCacheDirectory();
+		const bool optimize = false;
+		const bool generateDebugInfo = true;
+
 		for (auto [stage, source] : m_ShaderSource)
 		{
-			auto extension = VkShaderStageCachedFileExtension(stage);
+			// Everything that goes into the compiler, so editing the shader or changing an option compiles it again
+			DerivedDataKey cacheKey("shader/vulkan");
+			cacheKey.Add(source).Add((uint32_t)stage).Add((uint32_t)shaderc_env_version_vulkan_1_2).Add(optimize).Add(generateDebugInfo);
+
 			if (!forceCompile)
 			{
-				std::filesystem::path p = m_AssetPath;
-				auto path = cacheDirectory / (p.filename().string() + extension);
-				std::string cachedFilePath = path.string();
-
-				FILE* f = fopen(cachedFilePath.c_str(), "rb");
-				if (f)
+				Buffer cachedBinary;
+				if (DerivedDataCache::Get(cacheKey, cachedBinary))
 				{
-					fseek(f, 0, SEEK_END);
-					uint64_t size = ftell(f);
-					fseek(f, 0, SEEK_SET);
-					outputBinary[stage] = std::vector<uint32_t>(size / sizeof(uint32_t));
-					fread(outputBinary[stage].data(), sizeof(uint32_t), outputBinary[stage].size(), f);
-					fclose(f);
+					outputBinary[stage] = std::vector<uint32_t>((uint32_t*)cachedBinary.Data, (uint32_t*)cachedBinary.Data + cachedBinary.Size / sizeof(uint32_t));
+					cachedBinary.Release();
 				}
 			}
 
@@ -619,9 +584,9 @@ namespace Hazel {
 				shaderc::CompileOptions options;
 				options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_2);
 				options.SetWarningsAsErrors();
-				options.SetGenerateDebugInfo();
+				if (generateDebugInfo)
+					options.SetGenerateDebugInfo();
 
-				const bool optimize = false;
 				if (optimize)
 					options.SetOptimizationLevel(shaderc_optimization_level_performance);
 
@@ -636,23 +601,11 @@ namespace Hazel {
 						HZ_CORE_ASSERT(false);
 					}
 
-					const uint8_t* begin = (const uint8_t*)module.cbegin();
-					const uint8_t* end = (const uint8_t*)module.cend();
-					const ptrdiff_t size = end - begin;
-
 					outputBinary[stage] = std::vector<uint32_t>(module.cbegin(), module.cend());
 				}
 
 				// Cache compiled shader
-				{
-					std::filesystem::path p = m_AssetPath;
-					auto path = cacheDirectory / (p.filename().string() + extension);
-					std::string cachedFilePath = path.string();
-
-					FILE* f = fopen(cachedFilePath.c_str(), "wb");
-					fwrite(outputBinary[stage].data(), sizeof(uint32_t), outputBinary[stage].size(), f);
-					fclose(f);
-				}
+				DerivedDataCache::Put(cacheKey, outputBinary[stage].data(), outputBinary[stage].size() * sizeof(uint32_t));
 			}
 		}
 	}
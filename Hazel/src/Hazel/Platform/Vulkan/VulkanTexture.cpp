@@ -4,6 +4,8 @@
 #include "VulkanContext.h"
 #include "stb_image.h"
 
+#include "Hazel/Utilities/VirtualFileSystem.h"
+
 #include "VulkanImage.h"
 
 namespace Hazel {
@@ -74,23 +76,30 @@ namespace Hazel {
 	VulkanTexture2D::VulkanTexture2D(const std::string& path, TextureProperties properties)
 		: m_Path(path), m_Properties(properties)
 	{
-		int width, height, channels;
-		if (stbi_is_hdr(path.c_str()))
+		// Decoded straight from the mapped file (or pak entry)
+		FileView file;
+		VirtualFileSystem::ReadFile(path, file);
+		const stbi_uc* fileData = file.GetData();
+		int fileSize = (int)file.GetSize();
+
+		int width = 0, height = 0, channels;
+		if (stbi_is_hdr_from_memory(fileData, fileSize))
 		{
-			m_ImageData.Data = (byte*)stbi_loadf(path.c_str(), &width, &height, &channels, 4);
+			m_ImageData.Data = (byte*)stbi_loadf_from_memory(fileData, fileSize, &width, &height, &channels, 4);
 			m_ImageData.Size = width * height * 4 * sizeof(float);
 			m_Format = ImageFormat::RGBA32F;
 		}
 		else
 		{
 			//stbi_set_flip_vertically_on_load(1);
-			m_ImageData.Data = stbi_load(path.c_str(), &width, &height, &channels, 4);
+			m_ImageData.Data = stbi_load_from_memory(fileData, fileSize, &width, &height, &channels, 4);
 			m_ImageData.Size = width * height * 4;
 			m_Format = ImageFormat::RGBA;
 		}
 
 		//HZ_CORE_ASSERT(m_ImageData.Data, "Failed to load image!");
-		HZ_CORE_WARN("Failed to load image!");
+		if (!m_ImageData.Data)
+			HZ_CORE_WARN("Failed to load image {0}!", path);
 		m_Width = width;
 		m_Height = height;
 
@@ -37,6 +37,14 @@ namespace Hazel {
 		void GenerateMips();
 
 		virtual uint64_t GetHash() const { return (uint64_t)m_Image; }
+
+		// The decoded pixels stay around for GetWriteableBuffer
+		virtual AssetMemoryUsage GetMemoryUsage() const override
+		{
+			AssetMemoryUsage usage = Texture2D::GetMemoryUsage();
+			usage.CPUBytes = m_ImageData.Size;
+			return usage;
+		}
 	private:
 		std::string m_Path;
 		uint32_t m_Width;
@@ -86,6 +86,55 @@ namespace Hazel {
 		return result == 0;
 	}
 
+	bool FileSystem::MapFile(const std::string& filepath, MappedFile& outFile)
+	{
+		HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping == NULL)
+		{
+			HZ_CORE_ERROR("Failed to map {0}: {1}", filepath, GetLastError());
+			CloseHandle(file);
+			return false;
+		}
+
+		void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (data == nullptr)
+		{
+			HZ_CORE_ERROR("Failed to map {0}: {1}", filepath, GetLastError());
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return false;
+		}
+
+		outFile.Data = (const uint8_t*)data;
+		outFile.Size = (uint64_t)size.QuadPart;
+		outFile.FileHandle = file;
+		outFile.MappingHandle = mapping;
+		return true;
+	}
+
+	void FileSystem::UnmapFile(MappedFile& file)
+	{
+		if (file.Data)
+			UnmapViewOfFile(file.Data);
+		if (file.MappingHandle)
+			CloseHandle(file.MappingHandle);
+		if (file.FileHandle)
+			CloseHandle(file.FileHandle);
+
+		file = MappedFile();
+	}
+
 	void FileSystem::StartWatching()
 	{
 		DWORD threadId;
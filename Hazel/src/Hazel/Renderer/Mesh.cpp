@@ -9,17 +9,25 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/quaternion.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
+#include <glm/gtc/packing.hpp>
 
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 #include <assimp/Importer.hpp>
 #include <assimp/DefaultLogger.hpp>
 #include <assimp/LogStream.hpp>
+#include <assimp/IOStream.hpp>
+#include <assimp/IOSystem.hpp>
 
 #include "imgui/imgui.h"
 
 #include "Hazel/Renderer/Renderer.h"
+#include "Hazel/Renderer/RendererAPI.h"
 #include "Hazel/Renderer/VertexBuffer.h"
+#include "Hazel/Renderer/MeshCooker.h"
+#include "Hazel/Core/JobSystem.h"
+#include "Hazel/Core/Timer.h"
+#include "Hazel/Utilities/VirtualFileSystem.h"
 
 #include <filesystem>
 
@@ -69,19 +77,229 @@ namespace Hazel {
 		}
 	};
 
+	// Lets assimp read the model (and any files it references, e.g. .mtl or .bin) through the VirtualFileSystem
+	class VFSIOStream : public Assimp::IOStream
+	{
+	public:
+		VFSIOStream(FileView&& file)
+			: m_File(std::move(file)) {}
+
+		virtual size_t Read(void* buffer, size_t size, size_t count) override
+		{
+			if (size == 0)
+				return 0;
+
+			size_t available = (size_t)(m_File.GetSize() - m_Position) / size;
+			count = std::min(count, available);
+			memcpy(buffer, m_File.GetData() + m_Position, size * count);
+			m_Position += size * count;
+			return count;
+		}
+
+		virtual size_t Write(const void* buffer, size_t size, size_t count) override { return 0; }
+
+		virtual aiReturn Seek(size_t offset, aiOrigin origin) override
+		{
+			size_t position;
+			switch (origin)
+			{
+				case aiOrigin_SET: position = offset; break;
+				case aiOrigin_CUR: position = m_Position + offset; break;
+				case aiOrigin_END: position = (size_t)m_File.GetSize() - offset; break;
+				default: return aiReturn_FAILURE;
+			}
+
+			if (position > m_File.GetSize())
+				return aiReturn_FAILURE;
+
+			m_Position = position;
+			return aiReturn_SUCCESS;
+		}
+
+		virtual size_t Tell() const override { return m_Position; }
+		virtual size_t FileSize() const override { return (size_t)m_File.GetSize(); }
+		virtual void Flush() override {}
+	private:
+		FileView m_File;
+		size_t m_Position = 0;
+	};
+
+	class VFSIOSystem : public Assimp::IOSystem
+	{
+	public:
+		virtual bool Exists(const char* filepath) const override { return VirtualFileSystem::Exists(filepath); }
+		virtual char getOsSeparator() const override { return '/'; }
+
+		virtual Assimp::IOStream* Open(const char* filepath, const char* mode) override
+		{
+			// Read only
+			if (strchr(mode, 'w') || strchr(mode, 'a'))
+				return nullptr;
+
+			FileView file;
+			if (!VirtualFileSystem::ReadFile(filepath, file))
+				return nullptr;
+
+			std::string normalizedPath = std::filesystem::path(filepath).lexically_normal().generic_string();
+			if (std::find(m_OpenedFiles.begin(), m_OpenedFiles.end(), normalizedPath) == m_OpenedFiles.end())
+				m_OpenedFiles.push_back(normalizedPath);
+
+			return new VFSIOStream(std::move(file));
+		}
+
+		virtual void Close(Assimp::IOStream* file) override { delete file; }
+
+		// Every file the importer read, the source itself and companions like .mtl files or .bin buffers
+		const std::vector<std::string>& GetOpenedFiles() const { return m_OpenedFiles; }
+	private:
+		std::vector<std::string> m_OpenedFiles;
+	};
+
+	static MeshMaterialDescription ReadMaterialDescription(aiMaterial* aiMaterial)
+	{
+		MeshMaterialDescription description;
+		description.Name = aiMaterial->GetName().C_Str();
+
+		aiString aiTexPath;
+		uint32_t textureCount = aiMaterial->GetTextureCount(aiTextureType_DIFFUSE);
+		HZ_MESH_LOG("    TextureCount = {0}", textureCount);
+
+		aiColor3D aiColor;
+		if (aiMaterial->Get(AI_MATKEY_COLOR_DIFFUSE, aiColor) == AI_SUCCESS)
+			description.AlbedoColor = { aiColor.r, aiColor.g, aiColor.b };
+
+		float shininess, metalness;
+		if (aiMaterial->Get(AI_MATKEY_SHININESS, shininess) != aiReturn_SUCCESS)
+			shininess = 80.0f; // Default value
+
+		if (aiMaterial->Get(AI_MATKEY_REFLECTIVITY, metalness) != aiReturn_SUCCESS)
+			metalness = 0.0f;
+
+		description.Roughness = 1.0f - glm::sqrt(shininess / 100.0f);
+		description.Metalness = metalness;
+		HZ_MESH_LOG("    COLOR = {0}, {1}, {2}", aiColor.r, aiColor.g, aiColor.b);
+		HZ_MESH_LOG("    ROUGHNESS = {0}", description.Roughness);
+		HZ_MESH_LOG("    METALNESS = {0}", description.Metalness);
+
+		if (aiMaterial->GetTexture(aiTextureType_DIFFUSE, 0, &aiTexPath) == AI_SUCCESS)
+			description.AlbedoMap = aiTexPath.C_Str();
+
+		if (aiMaterial->GetTexture(aiTextureType_NORMALS, 0, &aiTexPath) == AI_SUCCESS)
+			description.NormalMap = aiTexPath.C_Str();
+
+		if (aiMaterial->GetTexture(aiTextureType_SHININESS, 0, &aiTexPath) == AI_SUCCESS)
+			description.RoughnessMap = aiTexPath.C_Str();
+
+		for (uint32_t p = 0; p < aiMaterial->mNumProperties; p++)
+		{
+			auto prop = aiMaterial->mProperties[p];
+
+#if DEBUG_PRINT_ALL_PROPS
+			HZ_MESH_LOG("Material Property:");
+			HZ_MESH_LOG("  Name = {0}", prop->mKey.data);
+			// HZ_MESH_LOG("  Type = {0}", prop->mType);
+			// HZ_MESH_LOG("  Size = {0}", prop->mDataLength);
+			float data = *(float*)prop->mData;
+			HZ_MESH_LOG("  Value = {0}", data);
+
+			switch (prop->mSemantic)
+			{
+			case aiTextureType_NONE:
+				HZ_MESH_LOG("  Semantic = aiTextureType_NONE");
+				break;
+			case aiTextureType_DIFFUSE:
+				HZ_MESH_LOG("  Semantic = aiTextureType_DIFFUSE");
+				break;
+			case aiTextureType_SPECULAR:
+				HZ_MESH_LOG("  Semantic = aiTextureType_SPECULAR");
+				break;
+			case aiTextureType_AMBIENT:
+				HZ_MESH_LOG("  Semantic = aiTextureType_AMBIENT");
+				break;
+			case aiTextureType_EMISSIVE:
+				HZ_MESH_LOG("  Semantic = aiTextureType_EMISSIVE");
+				break;
+			case aiTextureType_HEIGHT:
+				HZ_MESH_LOG("  Semantic = aiTextureType_HEIGHT");
+				break;
+			case aiTextureType_NORMALS:
+				HZ_MESH_LOG("  Semantic = aiTextureType_NORMALS");
+				break;
+			case aiTextureType_SHININESS:
+				HZ_MESH_LOG("  Semantic = aiTextureType_SHININESS");
+				break;
+			case aiTextureType_OPACITY:
+				HZ_MESH_LOG("  Semantic = aiTextureType_OPACITY");
+				break;
+			case aiTextureType_DISPLACEMENT:
+				HZ_MESH_LOG("  Semantic = aiTextureType_DISPLACEMENT");
+				break;
+			case aiTextureType_LIGHTMAP:
+				HZ_MESH_LOG("  Semantic = aiTextureType_LIGHTMAP");
+				break;
+			case aiTextureType_REFLECTION:
+				HZ_MESH_LOG("  Semantic = aiTextureType_REFLECTION");
+				break;
+			case aiTextureType_UNKNOWN:
+				HZ_MESH_LOG("  Semantic = aiTextureType_UNKNOWN");
+				break;
+			}
+#endif
+
+
+			if (prop->mType == aiPTI_String)
+			{
+				uint32_t strLength = *(uint32_t*)prop->mData;
+				std::string str(prop->mData + 4, strLength);
+
+				std::string key = prop->mKey.data;
+				if (key == "$raw.ReflectionFactor|file")
+				{
+					description.MetalnessMap = str;
+					break;
+				}
+			}
+		}
+
+		return description;
+	}
+
 	Mesh::Mesh(const std::string& filename)
 		: m_FilePath(filename)
 	{
 		LogStream::Initialize();
 
 		HZ_CORE_INFO("Loading mesh: {0}", filename.c_str());
+
+		// Static meshes are cooked on first import, later loads skip assimp entirely
+		std::vector<MeshMaterialDescription> materialDescriptions;
+		m_SourceHash = DerivedDataCache::HashFile(filename);
+		if (MeshCooker::LoadSourceFiles(m_SourceHash, m_SourceFilePaths)
+			&& MeshCooker::Load(MeshCooker::GetCacheKey(m_SourceHash, m_SourceFilePaths), *this, materialDescriptions))
+		{
+			m_IsAnimated = false;
+			m_MeshShader = Renderer::GetShaderLibrary()->Get(m_VertexFormat == MeshVertexFormat::Standard ? "HazelPBR_Static" : "HazelPBR_Static_Compact");
+			CreateMaterials(materialDescriptions);
+			CreateBuffers();
+			return;
+		}
 		
 		m_Importer = std::make_unique<Assimp::Importer>();
+		VFSIOSystem* ioSystem = new VFSIOSystem();
+		m_Importer->SetIOHandler(ioSystem); // Owned by the importer
 
 		const aiScene* scene = m_Importer->ReadFile(filename, s_MeshImportFlags);
 		if (!scene || !scene->HasMeshes())
 			HZ_CORE_ERROR("Failed to load mesh file: {0}", filename);
 
+		std::string sourcePath = std::filesystem::path(filename).lexically_normal().generic_string();
+		m_SourceFilePaths.clear();
+		for (const std::string& filepath : ioSystem->GetOpenedFiles())
+		{
+			if (filepath != sourcePath)
+				m_SourceFilePaths.push_back(filepath);
+		}
+
 		m_Scene = scene;
 
 		m_IsAnimated = scene->mAnimations != nullptr;
@@ -91,6 +309,20 @@ namespace Hazel {
 		uint32_t vertexCount = 0;
 		uint32_t indexCount = 0;
 
+		uint32_t totalVertexCount = 0;
+		uint32_t totalFaceCount = 0;
+		for (size_t m = 0; m < scene->mNumMeshes; m++)
+		{
+			totalVertexCount += scene->mMeshes[m]->mNumVertices;
+			totalFaceCount += scene->mMeshes[m]->mNumFaces;
+		}
+
+		if (m_IsAnimated)
+			m_AnimatedVertices.reserve(totalVertexCount);
+		else
+			m_StaticVertices.reserve(totalVertexCount);
+		m_Indices.reserve(totalFaceCount);
+
 		m_Submeshes.reserve(scene->mNumMeshes);
 		for (size_t m = 0; m < scene->mNumMeshes; m++)
 		{
@@ -115,7 +347,7 @@ namespace Hazel {
 			{
 				for (size_t i = 0; i < mesh->mNumVertices; i++)
 				{
-					AnimatedVertex vertex;
+					AnimatedVertex& vertex = m_AnimatedVertices.emplace_back();
 					vertex.Position = { mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z };
 					vertex.Normal = { mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z };
 
@@ -127,8 +359,6 @@ namespace Hazel {
 
 					if (mesh->HasTextureCoords(0))
 						vertex.Texcoord = { mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y };
-
-					m_AnimatedVertices.push_back(vertex);
 				}
 			}
 			else
@@ -138,7 +368,7 @@ namespace Hazel {
 				aabb.Max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
 				for (size_t i = 0; i < mesh->mNumVertices; i++)
 				{
-					Vertex vertex;
+					Vertex& vertex = m_StaticVertices.emplace_back();
 					vertex.Position = { mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z };
 					vertex.Normal = { mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z };
 					aabb.Min.x = glm::min(vertex.Position.x, aabb.Min.x);
@@ -156,8 +386,6 @@ namespace Hazel {
 
 					if (mesh->HasTextureCoords(0))
 						vertex.Texcoord = { mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y };
-
-					m_StaticVertices.push_back(vertex);
 				}
 			}
 
@@ -167,9 +395,6 @@ namespace Hazel {
 				HZ_CORE_ASSERT(mesh->mFaces[i].mNumIndices == 3, "Must have 3 indices.");
 				Index index = { mesh->mFaces[i].mIndices[0], mesh->mFaces[i].mIndices[1], mesh->mFaces[i].mIndices[2] };
 				m_Indices.push_back(index);
-
-				if (!m_IsAnimated)
-					m_TriangleCache[m].emplace_back(m_StaticVertices[index.V1 + submesh.BaseVertex], m_StaticVertices[index.V2 + submesh.BaseVertex], m_StaticVertices[index.V3 + submesh.BaseVertex]);
 			}
 		}
 
@@ -214,283 +439,489 @@ namespace Hazel {
 				}
 			}
 		}
+		else
+		{
+			if (MeshCooker::GetSettings().OptimizeMeshes)
+				OptimizeSubmeshes();
+			GenerateLODs();
+		}
 
 		// Materials
 		if (scene->HasMaterials())
 		{
 			HZ_MESH_LOG("---- Materials - {0} ----", filename);
 
-			m_Textures.resize(scene->mNumMaterials);
-			m_Materials.resize(scene->mNumMaterials);
+			materialDescriptions.reserve(scene->mNumMaterials);
+			for (uint32_t i = 0; i < scene->mNumMaterials; i++)
+			{
+				HZ_MESH_LOG("  {0} (Index = {1})", scene->mMaterials[i]->GetName().data, i);
+				materialDescriptions.push_back(ReadMaterialDescription(scene->mMaterials[i]));
+			}
 
-			Ref<Texture2D> whiteTexture = Renderer::GetWhiteTexture();
+			HZ_MESH_LOG("------------------------");
+		}
 
-			for (uint32_t i = 0; i < scene->mNumMaterials; i++)
+		// Animated meshes sample their animation from the assimp scene, so only static meshes can drop it
+		if (!m_IsAnimated)
+		{
+			m_VertexFormat = MeshCooker::SelectVertexFormat(*this);
+			if (m_VertexFormat != MeshVertexFormat::Standard)
+				m_MeshShader = Renderer::GetShaderLibrary()->Get("HazelPBR_Static_Compact");
+			MeshCooker::WriteSourceFiles(m_SourceHash, m_SourceFilePaths);
+			MeshCooker::Write(MeshCooker::GetCacheKey(m_SourceHash, m_SourceFilePaths), *this, materialDescriptions);
+
+			m_Importer.reset();
+			m_Scene = nullptr;
+		}
+
+		CreateMaterials(materialDescriptions);
+		CreateBuffers();
+	}
+
+	void Mesh::OptimizeSubmeshes()
+	{
+		Timer timer;
+		float overdrawThreshold = MeshCooker::GetSettings().OverdrawThreshold;
+
+		// Submeshes own disjoint ranges of the vertex and index data, so they're optimized in parallel
+		std::vector<MeshOptimizationStatistics> submeshStatistics(m_Submeshes.size());
+		JobSystem::ParallelFor((uint32_t)m_Submeshes.size(), 1, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t m = begin; m < end; m++)
 			{
-				auto aiMaterial = scene->mMaterials[i];
-				auto aiMaterialName = aiMaterial->GetName();
-
-				auto mi = Material::Create(m_MeshShader, aiMaterialName.data);
-				m_Materials[i] = mi;
-
-				HZ_MESH_LOG("  {0} (Index = {1})", aiMaterialName.data, i);
-				aiString aiTexPath;
-				uint32_t textureCount = aiMaterial->GetTextureCount(aiTextureType_DIFFUSE);
-				HZ_MESH_LOG("    TextureCount = {0}", textureCount);
-				
-				glm::vec3 albedoColor(0.8f);
-				aiColor3D aiColor;
-				if (aiMaterial->Get(AI_MATKEY_COLOR_DIFFUSE, aiColor) == AI_SUCCESS)
-					albedoColor = { aiColor.r, aiColor.g, aiColor.b };
-
-				mi->Set("u_MaterialUniforms.AlbedoColor", albedoColor);
-
-				float shininess, metalness;
-				if (aiMaterial->Get(AI_MATKEY_SHININESS, shininess) != aiReturn_SUCCESS)
-					shininess = 80.0f; // Default value
-
-				if (aiMaterial->Get(AI_MATKEY_REFLECTIVITY, metalness) != aiReturn_SUCCESS)
-					metalness = 0.0f;
-
-				float roughness = 1.0f - glm::sqrt(shininess / 100.0f);
-				HZ_MESH_LOG("    COLOR = {0}, {1}, {2}", aiColor.r, aiColor.g, aiColor.b);
-				HZ_MESH_LOG("    ROUGHNESS = {0}", roughness);
-				HZ_MESH_LOG("    METALNESS = {0}", metalness);
-				bool hasAlbedoMap = aiMaterial->GetTexture(aiTextureType_DIFFUSE, 0, &aiTexPath) == AI_SUCCESS;
-				bool fallback = !hasAlbedoMap;
-				if (hasAlbedoMap)
+				const Submesh& submesh = m_Submeshes[m];
+				uint32_t* indices = &m_Indices[submesh.BaseIndex / 3].V1;
+				Vertex* vertices = &m_StaticVertices[submesh.BaseVertex];
+
+				MeshOptimizationStatistics& statistics = submeshStatistics[m];
+				statistics.Before = MeshOptimizer::AnalyzeVertexCache(indices, submesh.IndexCount, submesh.VertexCount);
+				MeshOptimizer::OptimizeVertexCache(indices, submesh.IndexCount, submesh.VertexCount);
+				MeshOptimizer::OptimizeOverdraw(indices, submesh.IndexCount, vertices, submesh.VertexCount, overdrawThreshold);
+				MeshOptimizer::OptimizeVertexFetch(indices, submesh.IndexCount, vertices, submesh.VertexCount);
+				statistics.After = MeshOptimizer::AnalyzeVertexCache(indices, submesh.IndexCount, submesh.VertexCount);
+			}
+		});
+
+		m_OptimizationStatistics = {};
+		for (const MeshOptimizationStatistics& statistics : submeshStatistics)
+		{
+			m_OptimizationStatistics.Before += statistics.Before;
+			m_OptimizationStatistics.After += statistics.After;
+		}
+
+		const MeshOptimizationStatistics& total = m_OptimizationStatistics;
+		HZ_CORE_INFO("Optimized mesh {0} in {1}ms: ACMR {2:.3f} -> {3:.3f}, ATVR {4:.3f} -> {5:.3f}", m_FilePath, timer.ElapsedMillis(),
+			total.Before.GetACMR(), total.After.GetACMR(), total.Before.GetATVR(), total.After.GetATVR());
+	}
+
+	void Mesh::GenerateLODs()
+	{
+		const MeshCookSettings& settings = MeshCooker::GetSettings();
+		uint32_t lodCount = glm::min(settings.LODCount, Submesh::MaxLODCount);
+		if (lodCount < 2)
+			return;
+
+		// Below this a LOD saves too little to be worth a draw of its own
+		static constexpr uint32_t s_MinLODTriangles = 32;
+		static constexpr float s_MinLODReduction = 0.8f;
+
+		struct GeneratedLOD
+		{
+			std::vector<uint32_t> Indices;
+			float Error;
+		};
+
+		Timer timer;
+		std::vector<std::vector<GeneratedLOD>> submeshLODs(m_Submeshes.size());
+		JobSystem::ParallelFor((uint32_t)m_Submeshes.size(), 1, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t m = begin; m < end; m++)
+			{
+				const Submesh& submesh = m_Submeshes[m];
+				const Vertex* vertices = &m_StaticVertices[submesh.BaseVertex];
+				float maxError = settings.MaxLODError * glm::length(submesh.BoundingBox.Max - submesh.BoundingBox.Min) * 0.5f;
+
+				// Every LOD is simplified from the previous one, their errors add up
+				submeshLODs[m].reserve(lodCount - 1);
+				const uint32_t* previous = &m_Indices[submesh.BaseIndex / 3].V1;
+				uint32_t previousIndexCount = submesh.IndexCount;
+				float previousError = 0.0f;
+				for (uint32_t lod = 1; lod < lodCount && previousIndexCount / 3 > s_MinLODTriangles && previousError < maxError; lod++)
 				{
-					// TODO: Temp - this should be handled by Hazel's filesystem
-					std::filesystem::path path = filename;
-					auto parentPath = path.parent_path();
-					parentPath /= std::string(aiTexPath.data);
-					std::string texturePath = parentPath.string();
-					HZ_MESH_LOG("    Albedo map path = {0}", texturePath);
-					TextureProperties props;
-					props.SRGB = true;
-					auto texture = Texture2D::Create(texturePath, props);
-					if (texture->Loaded())
-					{
-						m_Textures[i] = texture;
-						mi->Set("u_AlbedoTexture", texture);
-					}
-					else
-					{
-						HZ_CORE_ERROR("Could not load texture: {0}", texturePath);
-						fallback = true;
-					}
+					uint32_t targetIndexCount = (uint32_t)(previousIndexCount / 3 * settings.LODReduction) * 3;
+					std::vector<uint32_t> indices(previousIndexCount);
+					float error = 0.0f;
+					uint32_t indexCount = MeshOptimizer::Simplify(indices.data(), previous, previousIndexCount, vertices, submesh.VertexCount, targetIndexCount, maxError - previousError, &error);
+					if (indexCount == 0 || indexCount > previousIndexCount * s_MinLODReduction)
+						break;
+
+					indices.resize(indexCount);
+					MeshOptimizer::OptimizeVertexCache(indices.data(), indexCount, submesh.VertexCount);
+
+					GeneratedLOD& generated = submeshLODs[m].emplace_back();
+					generated.Indices = std::move(indices);
+					generated.Error = previousError + error;
+
+					previous = generated.Indices.data();
+					previousIndexCount = indexCount;
+					previousError = generated.Error;
 				}
+			}
+		});
+
+		// The simplified ranges go after all full detail ones, which keeps the submeshes' own ranges as they were
+		std::array<uint32_t, Submesh::MaxLODCount> triangleCounts{};
+		for (size_t m = 0; m < m_Submeshes.size(); m++)
+		{
+			Submesh& submesh = m_Submeshes[m];
+			triangleCounts[0] += submesh.IndexCount / 3;
+
+			submesh.SimplifiedLODCount = (uint32_t)submeshLODs[m].size();
+			for (uint32_t lod = 0; lod < submesh.SimplifiedLODCount; lod++)
+			{
+				const GeneratedLOD& generated = submeshLODs[m][lod];
+				SubmeshLOD& submeshLOD = submesh.SimplifiedLODs[lod];
+				submeshLOD.BaseIndex = (uint32_t)m_Indices.size() * 3;
+				submeshLOD.IndexCount = (uint32_t)generated.Indices.size();
+				submeshLOD.Error = generated.Error;
+
+				const Index* triangles = (const Index*)generated.Indices.data();
+				m_Indices.insert(m_Indices.end(), triangles, triangles + generated.Indices.size() / 3);
+				triangleCounts[lod + 1] += submeshLOD.IndexCount / 3;
+			}
+
+			// Submeshes that ran out of LODs draw their coarsest one at the remaining levels
+			for (uint32_t lod = submesh.SimplifiedLODCount + 1; lod < lodCount; lod++)
+				triangleCounts[lod] += submesh.GetLOD(submesh.SimplifiedLODCount).IndexCount / 3;
+		}
+
+		std::string triangles = std::to_string(triangleCounts[0]);
+		for (uint32_t lod = 1; lod < lodCount; lod++)
+			triangles += " / " + std::to_string(triangleCounts[lod]);
+		HZ_CORE_INFO("Generated LODs for mesh {0} in {1}ms: {2} triangles", m_FilePath, timer.ElapsedMillis(), triangles);
+	}
+
+	void Mesh::BuildBVHsAsync()
+	{
+		if (m_IsAnimated || m_BVHBuildStarted.exchange(true))
+			return;
 
-				if (fallback)
+		// The destructor waits for this job, so it can't outlive the mesh
+		JobSystem::Submit([this]()
+		{
+			Timer timer;
+			std::vector<SubmeshBVH> bvhs(m_Submeshes.size());
+			JobSystem::ParallelFor((uint32_t)m_Submeshes.size(), 1, [&](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t m = begin; m < end; m++)
 				{
-					HZ_MESH_LOG("    No albedo map");
-					mi->Set("u_AlbedoTexture", whiteTexture);
+					const Submesh& submesh = m_Submeshes[m];
+					bvhs[m].Build(&m_StaticVertices[submesh.BaseVertex], &m_Indices[submesh.BaseIndex / 3], submesh.IndexCount / 3);
 				}
+			});
+
+			size_t bvhBytes = 0;
+			uint64_t triangleCount = 0;
+			for (size_t m = 0; m < bvhs.size(); m++)
+			{
+				bvhBytes += bvhs[m].GetMemoryUsage();
+				triangleCount += m_Submeshes[m].IndexCount / 3;
+			}
+
+			m_SubmeshBVHs = std::move(bvhs);
+			m_BVHsBuilt.store(true, std::memory_order_release);
+
+			HZ_CORE_INFO("Built raycast BVHs for mesh {0} in {1}ms: {2} KB for {3} triangles ({4} KB as a per-triangle vertex cache)", m_FilePath, timer.ElapsedMillis(),
+				bvhBytes / 1024, triangleCount, triangleCount * 3 * sizeof(Vertex) / 1024);
+		}, nullptr, JobPriority::Low);
+	}
+
+	bool Mesh::RaycastSubmesh(uint32_t submeshIndex, const Ray& ray, float& outDistance, float maxDistance)
+	{
+		if (m_IsAnimated)
+			return false;
+
+		if (!m_BVHsBuilt.load(std::memory_order_acquire))
+		{
+			BuildBVHsAsync();
+			JobSystem::WaitUntil([this]() { return m_BVHsBuilt.load(std::memory_order_acquire); });
+		}
+
+		const Submesh& submesh = m_Submeshes[submeshIndex];
+		return m_SubmeshBVHs[submeshIndex].Raycast(ray, &m_StaticVertices[submesh.BaseVertex], &m_Indices[submesh.BaseIndex / 3], outDistance, maxDistance);
+	}
+
+	void Mesh::CreateMaterials(const std::vector<MeshMaterialDescription>& descriptions)
+	{
+		if (descriptions.empty())
+		{
+			auto mi = Material::Create(m_MeshShader, "Hazel-Default");
+			mi->Set("u_MaterialUniforms.AlbedoTexToggle", 0.0f);
+			mi->Set("u_MaterialUniforms.NormalTexToggle", 0.0f);
+			mi->Set("u_MaterialUniforms.MetalnessTexToggle", 0.0f);
+			mi->Set("u_MaterialUniforms.RoughnessTexToggle", 0.0f);
+			mi->Set("u_MaterialUniforms.AlbedoColor", glm::vec3(0.8f, 0.1f, 0.3f));
+			mi->Set("u_MaterialUniforms.Metalness", 0.0f);
+			mi->Set("u_MaterialUniforms.Roughness", 0.8f);
+			m_Materials.push_back(mi);
+			return;
+		}
+
+		m_Textures.resize(descriptions.size());
+		m_Materials.resize(descriptions.size());
+
+		Ref<Texture2D> whiteTexture = Renderer::GetWhiteTexture();
+
+		// TODO: Temp - this should be handled by Hazel's filesystem
+		auto getTexturePath = [this](const std::string& relativePath)
+		{
+			std::filesystem::path path = m_FilePath;
+			auto parentPath = path.parent_path();
+			parentPath /= relativePath;
+			m_TextureFilePaths.push_back(parentPath.string());
+			return parentPath.string();
+		};
 
-				// Normal maps
-				mi->Set("u_MaterialUniforms.UseNormalMap", (uint32_t)false);
-				bool hasNormalMap = aiMaterial->GetTexture(aiTextureType_NORMALS, 0, &aiTexPath) == AI_SUCCESS;
-				fallback = !hasNormalMap;
-				if (hasNormalMap)
+		// Every texture the materials reference is decoded concurrently before the materials are set up
+		std::vector<std::string> texturePaths;
+		std::vector<TextureProperties> textureProperties;
+		auto addTexture = [&](const std::string& relativePath, const TextureProperties& properties)
+		{
+			if (relativePath.empty())
+				return -1;
+
+			texturePaths.push_back(getTexturePath(relativePath));
+			textureProperties.push_back(properties);
+			return (int32_t)texturePaths.size() - 1;
+		};
+
+		struct MaterialTextures
+		{
+			int32_t Albedo, Normal, Roughness, Metalness; // Into textures, -1 if the material has none
+		};
+
+		TextureProperties albedoProperties;
+		albedoProperties.SRGB = true;
+
+		std::vector<MaterialTextures> materialTextures(descriptions.size());
+		for (uint32_t i = 0; i < (uint32_t)descriptions.size(); i++)
+		{
+			const MeshMaterialDescription& description = descriptions[i];
+			materialTextures[i].Albedo = addTexture(description.AlbedoMap, albedoProperties);
+			materialTextures[i].Normal = addTexture(description.NormalMap, TextureProperties());
+			materialTextures[i].Roughness = addTexture(description.RoughnessMap, TextureProperties());
+			materialTextures[i].Metalness = addTexture(description.MetalnessMap, TextureProperties());
+		}
+
+		// Each texture records its uploads into its own queue, the calling thread's queue can't be shared between workers
+		std::vector<Ref<Texture2D>> textures(texturePaths.size());
+		std::vector<RenderCommandQueue> textureCommands(texturePaths.size());
+		auto createTextures = [&](uint32_t begin, uint32_t end)
+		{
+			RenderCommandQueue* previousQueue = Renderer::GetThreadCommandQueue();
+			for (uint32_t t = begin; t < end; t++)
+			{
+				Renderer::SetThreadCommandQueue(&textureCommands[t]);
+				textures[t] = Texture2D::Create(texturePaths[t], textureProperties[t]);
+			}
+			Renderer::SetThreadCommandQueue(previousQueue);
+		};
+
+		// OpenGL textures create their samplers in the constructor, which only works on the thread owning the context
+		if (RendererAPI::Current() == RendererAPIType::Vulkan)
+			JobSystem::ParallelFor((uint32_t)texturePaths.size(), 1, createTextures);
+		else
+			createTextures(0, (uint32_t)texturePaths.size());
+
+		RenderCommandQueue* threadQueue = Renderer::GetThreadCommandQueue();
+		for (RenderCommandQueue& commands : textureCommands)
+		{
+			if (threadQueue)
+				threadQueue->Append(commands);
+			else
+				Renderer::SubmitCommandQueue(commands);
+		}
+
+		for (uint32_t i = 0; i < (uint32_t)descriptions.size(); i++)
+		{
+			const MeshMaterialDescription& description = descriptions[i];
+			const MaterialTextures& indices = materialTextures[i];
+
+			auto mi = Material::Create(m_MeshShader, description.Name);
+			m_Materials[i] = mi;
+
+			mi->Set("u_MaterialUniforms.AlbedoColor", description.AlbedoColor);
+
+			bool fallback = indices.Albedo == -1;
+			if (!fallback)
+			{
+				const std::string& texturePath = texturePaths[indices.Albedo];
+				HZ_MESH_LOG("    Albedo map path = {0}", texturePath);
+				auto& texture = textures[indices.Albedo];
+				if (texture->Loaded())
 				{
-					// TODO: Temp - this should be handled by Hazel's filesystem
-					std::filesystem::path path = filename;
-					auto parentPath = path.parent_path();
-					parentPath /= std::string(aiTexPath.data);
-					std::string texturePath = parentPath.string();
-					HZ_MESH_LOG("    Normal map path = {0}", texturePath);
-					auto texture = Texture2D::Create(texturePath);
-					if (texture->Loaded())
-					{
-						m_Textures.push_back(texture);
-						mi->Set("u_NormalTexture", texture);
-						mi->Set("u_MaterialUniforms.UseNormalMap", true);
-					}
-					else
-					{
-						HZ_CORE_ERROR("    Could not load texture: {0}", texturePath);
-						fallback = true;
-					}
+					m_Textures[i] = texture;
+					mi->Set("u_AlbedoTexture", texture);
 				}
-
-				if (fallback)
+				else
 				{
-					HZ_MESH_LOG("    No normal map");
-					mi->Set("u_NormalTexture", whiteTexture);
+					HZ_CORE_ERROR("Could not load texture: {0}", texturePath);
+					fallback = true;
 				}
+			}
 
-				// Roughness map
-				bool hasRoughnessMap = aiMaterial->GetTexture(aiTextureType_SHININESS, 0, &aiTexPath) == AI_SUCCESS;
-				fallback = !hasRoughnessMap;
-				if (hasRoughnessMap)
+			if (fallback)
+			{
+				HZ_MESH_LOG("    No albedo map");
+				mi->Set("u_AlbedoTexture", whiteTexture);
+			}
+
+			// Normal maps
+			mi->Set("u_MaterialUniforms.UseNormalMap", (uint32_t)false);
+			fallback = indices.Normal == -1;
+			if (!fallback)
+			{
+				const std::string& texturePath = texturePaths[indices.Normal];
+				HZ_MESH_LOG("    Normal map path = {0}", texturePath);
+				auto& texture = textures[indices.Normal];
+				if (texture->Loaded())
 				{
-					// TODO: Temp - this should be handled by Hazel's filesystem
-					std::filesystem::path path = filename;
-					auto parentPath = path.parent_path();
-					parentPath /= std::string(aiTexPath.data);
-					std::string texturePath = parentPath.string();
-					HZ_MESH_LOG("    Roughness map path = {0}", texturePath);
-					auto texture = Texture2D::Create(texturePath);
-					if (texture->Loaded())
-					{
-						m_Textures.push_back(texture);
-						mi->Set("u_RoughnessTexture", texture);
-					}
-					else
-					{
-						HZ_CORE_ERROR("    Could not load texture: {0}", texturePath);
-						fallback = true;
-					}
+					m_Textures.push_back(texture);
+					mi->Set("u_NormalTexture", texture);
+					mi->Set("u_MaterialUniforms.UseNormalMap", true);
 				}
-
-				if (fallback)
+				else
 				{
-					HZ_MESH_LOG("    No roughness map");
-					mi->Set("u_RoughnessTexture", whiteTexture);
-					mi->Set("u_MaterialUniforms.Roughness", roughness);
+					HZ_CORE_ERROR("    Could not load texture: {0}", texturePath);
+					fallback = true;
 				}
+			}
+
+			if (fallback)
+			{
+				HZ_MESH_LOG("    No normal map");
+				mi->Set("u_NormalTexture", whiteTexture);
+			}
 
-#if 0
-				// Metalness map (or is it??)
-				if (aiMaterial->Get("$raw.ReflectionFactor|file", aiPTI_String, 0, aiTexPath) == AI_SUCCESS)
+			// Roughness map
+			fallback = indices.Roughness == -1;
+			if (!fallback)
+			{
+				const std::string& texturePath = texturePaths[indices.Roughness];
+				HZ_MESH_LOG("    Roughness map path = {0}", texturePath);
+				auto& texture = textures[indices.Roughness];
+				if (texture->Loaded())
 				{
-					// TODO: Temp - this should be handled by Hazel's filesystem
-					std::filesystem::path path = filename;
-					auto parentPath = path.parent_path();
-					parentPath /= std::string(aiTexPath.data);
-					std::string texturePath = parentPath.string();
-
-					auto texture = Texture2D::Create(texturePath);
-					if (texture->Loaded())
-					{
-						HZ_MESH_LOG("    Metalness map path = {0}", texturePath);
-						mi->Set("u_MetalnessTexture", texture);
-						mi->Set("u_MetalnessTexToggle", 1.0f);
-					}
-					else
-					{
-						HZ_CORE_ERROR("Could not load texture: {0}", texturePath);
-					}
+					m_Textures.push_back(texture);
+					mi->Set("u_RoughnessTexture", texture);
 				}
 				else
 				{
-					HZ_MESH_LOG("    No metalness texture");
-					mi->Set("u_Metalness", metalness);
+					HZ_CORE_ERROR("    Could not load texture: {0}", texturePath);
+					fallback = true;
 				}
-#endif
-
-				bool metalnessTextureFound = false;
-				for (uint32_t p = 0; p < aiMaterial->mNumProperties; p++)
-				{
-					auto prop = aiMaterial->mProperties[p];
-
-#if DEBUG_PRINT_ALL_PROPS
-					HZ_MESH_LOG("Material Property:");
-					HZ_MESH_LOG("  Name = {0}", prop->mKey.data);
-					// HZ_MESH_LOG("  Type = {0}", prop->mType);
-					// HZ_MESH_LOG("  Size = {0}", prop->mDataLength);
-					float data = *(float*)prop->mData;
-					HZ_MESH_LOG("  Value = {0}", data);
-
-					switch (prop->mSemantic)
-					{
-					case aiTextureType_NONE:
-						HZ_MESH_LOG("  Semantic = aiTextureType_NONE");
-						break;
-					case aiTextureType_DIFFUSE:
-						HZ_MESH_LOG("  Semantic = aiTextureType_DIFFUSE");
-						break;
-					case aiTextureType_SPECULAR:
-						HZ_MESH_LOG("  Semantic = aiTextureType_SPECULAR");
-						break;
-					case aiTextureType_AMBIENT:
-						HZ_MESH_LOG("  Semantic = aiTextureType_AMBIENT");
-						break;
-					case aiTextureType_EMISSIVE:
-						HZ_MESH_LOG("  Semantic = aiTextureType_EMISSIVE");
-						break;
-					case aiTextureType_HEIGHT:
-						HZ_MESH_LOG("  Semantic = aiTextureType_HEIGHT");
-						break;
-					case aiTextureType_NORMALS:
-						HZ_MESH_LOG("  Semantic = aiTextureType_NORMALS");
-						break;
-					case aiTextureType_SHININESS:
-						HZ_MESH_LOG("  Semantic = aiTextureType_SHININESS");
-						break;
-					case aiTextureType_OPACITY:
-						HZ_MESH_LOG("  Semantic = aiTextureType_OPACITY");
-						break;
-					case aiTextureType_DISPLACEMENT:
-						HZ_MESH_LOG("  Semantic = aiTextureType_DISPLACEMENT");
-						break;
-					case aiTextureType_LIGHTMAP:
-						HZ_MESH_LOG("  Semantic = aiTextureType_LIGHTMAP");
-						break;
-					case aiTextureType_REFLECTION:
-						HZ_MESH_LOG("  Semantic = aiTextureType_REFLECTION");
-						break;
-					case aiTextureType_UNKNOWN:
-						HZ_MESH_LOG("  Semantic = aiTextureType_UNKNOWN");
-						break;
-					}
-#endif
+			}
 
-					if (prop->mType == aiPTI_String)
-					{
-						uint32_t strLength = *(uint32_t*)prop->mData;
-						std::string str(prop->mData + 4, strLength);
+			if (fallback)
+			{
+				HZ_MESH_LOG("    No roughness map");
+				mi->Set("u_RoughnessTexture", whiteTexture);
+				mi->Set("u_MaterialUniforms.Roughness", description.Roughness);
+			}
 
-						std::string key = prop->mKey.data;
-						if (key == "$raw.ReflectionFactor|file")
-						{
-							// TODO: Temp - this should be handled by Hazel's filesystem
-							std::filesystem::path path = filename;
-							auto parentPath = path.parent_path();
-							parentPath /= str;
-							std::string texturePath = parentPath.string();
-							HZ_MESH_LOG("    Metalness map path = {0}", texturePath);
-							auto texture = Texture2D::Create(texturePath);
-							if (texture->Loaded())
-							{
-								metalnessTextureFound = true;
-								m_Textures.push_back(texture);
-								mi->Set("u_MetalnessTexture", texture);
-							}
-							else
-							{
-								HZ_CORE_ERROR("    Could not load texture: {0}", texturePath);
-							}
-							break;
-						}
-					}
+			// Metalness map
+			bool metalnessTextureFound = false;
+			if (indices.Metalness != -1)
+			{
+				const std::string& texturePath = texturePaths[indices.Metalness];
+				HZ_MESH_LOG("    Metalness map path = {0}", texturePath);
+				auto& texture = textures[indices.Metalness];
+				if (texture->Loaded())
+				{
+					metalnessTextureFound = true;
+					m_Textures.push_back(texture);
+					mi->Set("u_MetalnessTexture", texture);
 				}
-
-				fallback = !metalnessTextureFound;
-				if (fallback)
+				else
 				{
-					HZ_MESH_LOG("    No metalness map");
-					mi->Set("u_MetalnessTexture", whiteTexture);
-					mi->Set("u_MaterialUniforms.Metalness", metalness);
-
+					HZ_CORE_ERROR("    Could not load texture: {0}", texturePath);
 				}
 			}
-			HZ_MESH_LOG("------------------------");
+
+			fallback = !metalnessTextureFound;
+			if (fallback)
+			{
+				HZ_MESH_LOG("    No metalness map");
+				mi->Set("u_MetalnessTexture", whiteTexture);
+				mi->Set("u_MaterialUniforms.Metalness", description.Metalness);
+			}
 		}
-		else
+	}
+
+	static glm::vec2 OctahedronEncode(const glm::vec3& vector)
+	{
+		float length = glm::abs(vector.x) + glm::abs(vector.y) + glm::abs(vector.z);
+		if (length < 1e-8f)
+			return glm::vec2(0.0f);
+
+		glm::vec3 n = vector / length;
+		if (n.z >= 0.0f)
+			return glm::vec2(n.x, n.y);
+
+		// Lower hemisphere folds over the diagonals
+		return glm::vec2((1.0f - glm::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f), (1.0f - glm::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f));
+	}
+
+	static int16_t PackSnorm16(float value)
+	{
+		return (int16_t)glm::round(glm::clamp(value, -1.0f, 1.0f) * 32767.0f);
+	}
+
+	static void EncodeNormalTangent(const Vertex& vertex, int16_t* outNormalTangent)
+	{
+		glm::vec2 normal = OctahedronEncode(vertex.Normal);
+		glm::vec2 tangent = OctahedronEncode(vertex.Tangent);
+		float handedness = glm::dot(glm::cross(vertex.Normal, vertex.Tangent), vertex.Binormal) < 0.0f ? -1.0f : 1.0f;
+
+		outNormalTangent[0] = PackSnorm16(normal.x);
+		outNormalTangent[1] = PackSnorm16(normal.y);
+		outNormalTangent[2] = PackSnorm16(tangent.x);
+		// Remapped to [0, 1] (never 0) so the handedness can live in its sign
+		outNormalTangent[3] = PackSnorm16(handedness * glm::max(tangent.y * 0.5f + 0.5f, 1.0f / 32767.0f));
+	}
+
+	VertexBufferLayout Mesh::GetStaticVertexLayout(MeshVertexFormat format)
+	{
+		switch (format)
 		{
-			auto mi = Material::Create(m_MeshShader, "Hazel-Default");
-			mi->Set("u_MaterialUniforms.AlbedoTexToggle", 0.0f);
-			mi->Set("u_MaterialUniforms.NormalTexToggle", 0.0f);
-			mi->Set("u_MaterialUniforms.MetalnessTexToggle", 0.0f);
-			mi->Set("u_MaterialUniforms.RoughnessTexToggle", 0.0f);
-			mi->Set("u_MaterialUniforms.AlbedoColor", glm::vec3(0.8f, 0.1f, 0.3f));
-			mi->Set("u_MaterialUniforms.Metalness", 0.0f);
-			mi->Set("u_MaterialUniforms.Roughness", 0.8f);
-			m_Materials.push_back(mi);
+			case MeshVertexFormat::Standard:
+				return {
+					{ ShaderDataType::Float3, "a_Position" },
+					{ ShaderDataType::Float3, "a_Normal" },
+					{ ShaderDataType::Float3, "a_Tangent" },
+					{ ShaderDataType::Float3, "a_Binormal" },
+					{ ShaderDataType::Float2, "a_TexCoord" },
+				};
+			case MeshVertexFormat::Compact:
+				return {
+					{ ShaderDataType::Float3, "a_Position" },
+					{ ShaderDataType::Short4Norm, "a_NormalTangent" },
+					{ ShaderDataType::Half2, "a_TexCoord" },
+				};
+			case MeshVertexFormat::CompactQuantized:
+				return {
+					{ ShaderDataType::Short4Norm, "a_Position" },
+					{ ShaderDataType::Short4Norm, "a_NormalTangent" },
+					{ ShaderDataType::Half2, "a_TexCoord" },
+				};
 		}
 
-		
+		HZ_CORE_ASSERT(false, "Unknown vertex format");
+		return {};
+	}
+
+	void Mesh::CreateBuffers()
+	{
 		if (m_IsAnimated)
 		{
 			m_VertexBuffer = VertexBuffer::Create(m_AnimatedVertices.data(), m_AnimatedVertices.size() * sizeof(AnimatedVertex));
@@ -506,14 +937,59 @@ namespace Hazel {
 		}
 		else
 		{
-			m_VertexBuffer = VertexBuffer::Create(m_StaticVertices.data(), m_StaticVertices.size() * sizeof(Vertex));
-			m_VertexBufferLayout = {
-				{ ShaderDataType::Float3, "a_Position" },
-				{ ShaderDataType::Float3, "a_Normal" },
-				{ ShaderDataType::Float3, "a_Tangent" },
-				{ ShaderDataType::Float3, "a_Binormal" },
-				{ ShaderDataType::Float2, "a_TexCoord" },
-			};
+			m_VertexBufferLayout = GetStaticVertexLayout(m_VertexFormat);
+			switch (m_VertexFormat)
+			{
+				case MeshVertexFormat::Standard:
+				{
+					m_VertexBuffer = VertexBuffer::Create(m_StaticVertices.data(), m_StaticVertices.size() * sizeof(Vertex));
+					break;
+				}
+				case MeshVertexFormat::Compact:
+				{
+					std::vector<CompactVertex> vertices(m_StaticVertices.size());
+					for (size_t i = 0; i < vertices.size(); i++)
+					{
+						const Vertex& vertex = m_StaticVertices[i];
+						vertices[i].Position = vertex.Position;
+						EncodeNormalTangent(vertex, vertices[i].NormalTangent);
+						vertices[i].Texcoord[0] = glm::packHalf1x16(vertex.Texcoord.x);
+						vertices[i].Texcoord[1] = glm::packHalf1x16(vertex.Texcoord.y);
+					}
+					m_VertexBuffer = VertexBuffer::Create(vertices.data(), vertices.size() * sizeof(CompactVertex));
+					break;
+				}
+				case MeshVertexFormat::CompactQuantized:
+				{
+					// Same scale on every axis so the dequantize transform doesn't skew normals
+					std::vector<QuantizedVertex> vertices(m_StaticVertices.size());
+					for (Submesh& submesh : m_Submeshes)
+					{
+						glm::vec3 center = (submesh.BoundingBox.Min + submesh.BoundingBox.Max) * 0.5f;
+						glm::vec3 halfExtents = (submesh.BoundingBox.Max - submesh.BoundingBox.Min) * 0.5f;
+						float scale = glm::max(halfExtents.x, glm::max(halfExtents.y, halfExtents.z));
+						if (scale <= 0.0f)
+							scale = 1.0f;
+
+						submesh.DequantizeTransform = glm::translate(glm::mat4(1.0f), center) * glm::scale(glm::mat4(1.0f), glm::vec3(scale));
+
+						for (uint32_t i = submesh.BaseVertex; i < submesh.BaseVertex + submesh.VertexCount; i++)
+						{
+							const Vertex& vertex = m_StaticVertices[i];
+							glm::vec3 position = (vertex.Position - center) / scale;
+							vertices[i].Position[0] = PackSnorm16(position.x);
+							vertices[i].Position[1] = PackSnorm16(position.y);
+							vertices[i].Position[2] = PackSnorm16(position.z);
+							vertices[i].Position[3] = 0;
+							EncodeNormalTangent(vertex, vertices[i].NormalTangent);
+							vertices[i].Texcoord[0] = glm::packHalf1x16(vertex.Texcoord.x);
+							vertices[i].Texcoord[1] = glm::packHalf1x16(vertex.Texcoord.y);
+						}
+					}
+					m_VertexBuffer = VertexBuffer::Create(vertices.data(), vertices.size() * sizeof(QuantizedVertex));
+					break;
+				}
+			}
 		}
 
 		m_IndexBuffer = IndexBuffer::Create(m_Indices.data(), m_Indices.size() * sizeof(Index));
@@ -531,17 +1007,44 @@ namespace Hazel {
 
 		m_VertexBuffer = VertexBuffer::Create(m_StaticVertices.data(), m_StaticVertices.size() * sizeof(Vertex));
 		m_IndexBuffer = IndexBuffer::Create(m_Indices.data(), m_Indices.size() * sizeof(Index));
-		m_VertexBufferLayout = {
-			{ ShaderDataType::Float3, "a_Position" },
-			{ ShaderDataType::Float3, "a_Normal" },
-			{ ShaderDataType::Float3, "a_Tangent" },
-			{ ShaderDataType::Float3, "a_Binormal" },
-			{ ShaderDataType::Float2, "a_TexCoord" },
-		};
+		m_VertexBufferLayout = GetStaticVertexLayout(MeshVertexFormat::Standard);
 	}
 
 	Mesh::~Mesh()
 	{
+		if (m_BVHBuildStarted)
+			JobSystem::WaitUntil([this]() { return m_BVHsBuilt.load(std::memory_order_acquire); });
+	}
+
+	AssetMemoryUsage Mesh::GetMemoryUsage() const
+	{
+		AssetMemoryUsage usage;
+		usage.CPUBytes += m_StaticVertices.size() * sizeof(Vertex);
+		usage.CPUBytes += m_AnimatedVertices.size() * sizeof(AnimatedVertex);
+		usage.CPUBytes += m_Indices.size() * sizeof(Index);
+		if (m_BVHsBuilt.load(std::memory_order_acquire))
+		{
+			for (const SubmeshBVH& bvh : m_SubmeshBVHs)
+				usage.CPUBytes += bvh.GetMemoryUsage();
+		}
+
+		if (m_VertexBuffer)
+			usage.GPUBytes += m_VertexBuffer->GetSize();
+		if (m_IndexBuffer)
+			usage.GPUBytes += m_IndexBuffer->GetSize();
+
+		// The material textures are loaded by (and only belong to) the mesh
+		for (const Ref<Texture2D>& texture : m_Textures)
+		{
+			if (!texture)
+				continue;
+
+			AssetMemoryUsage textureUsage = texture->GetMemoryUsage();
+			usage.CPUBytes += textureUsage.CPUBytes;
+			usage.GPUBytes += textureUsage.GPUBytes;
+		}
+
+		return usage;
 	}
 
 	void Mesh::OnUpdate(Timestep ts)
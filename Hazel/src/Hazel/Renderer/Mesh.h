@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <atomic>
 #include <glm/glm.hpp>
 
 #include "Hazel/Core/Timestep.h"
@@ -12,6 +13,8 @@
 #include "Hazel/Renderer/VertexBuffer.h"
 #include "Hazel/Renderer/Shader.h"
 #include "Hazel/Renderer/Material.h"
+#include "Hazel/Renderer/MeshOptimizer.h"
+#include "Hazel/Renderer/MeshBVH.h"
 
 #include "Hazel/Core/Math/AABB.h"
 
@@ -66,6 +69,35 @@ namespace Hazel {
 
 	static const int NumAttributes = 5;
 
+	// GPU vertex layout of a static mesh, picked per mesh when it's cooked (see MeshCooker). The CPU side always
+	// keeps full Vertex data for physics and picking.
+	enum class MeshVertexFormat : uint8_t
+	{
+		Standard = 0,     // Vertex, 56 bytes
+		Compact,          // CompactVertex, 24 bytes
+		CompactQuantized, // QuantizedVertex, 20 bytes
+		Count
+	};
+
+	// Normal and tangent are octahedral encoded. The binormal is rebuilt in the shader from the two and the
+	// handedness, which is the sign of the last component (the tangent's second one, remapped to [0, 1]).
+	struct CompactVertex
+	{
+		glm::vec3 Position;
+		int16_t NormalTangent[4]; // snorm16
+		uint16_t Texcoord[2];     // Half floats
+	};
+
+	// CompactVertex with positions relative to the submesh's bounds, Submesh::DequantizeTransform maps them back
+	struct QuantizedVertex
+	{
+		int16_t Position[4]; // snorm16, w is unused
+		int16_t NormalTangent[4];
+		uint16_t Texcoord[2];
+	};
+
+	static_assert(sizeof(CompactVertex) == 24 && sizeof(QuantizedVertex) == 20);
+
 	struct Index
 	{
 		uint32_t V1, V2, V3;
@@ -107,17 +139,18 @@ namespace Hazel {
 		}
 	};
 
-	struct Triangle
+	struct SubmeshLOD
 	{
-		Vertex V0, V1, V2;
-
-		Triangle(const Vertex& v0, const Vertex& v1, const Vertex& v2)
-			: V0(v0), V1(v1), V2(v2) {}
+		uint32_t BaseIndex;
+		uint32_t IndexCount;
+		float Error; // Largest distance from the full detail surface, in the submesh's units
 	};
 
 	class Submesh
 	{
 	public:
+		static constexpr uint32_t MaxLODCount = 4; // Including the full detail geometry
+
 		uint32_t BaseVertex;
 		uint32_t BaseIndex;
 		uint32_t MaterialIndex;
@@ -125,11 +158,23 @@ namespace Hazel {
 		uint32_t VertexCount;
 
 		glm::mat4 Transform{ 1.0f };
+		// Applied before Transform when drawing, scales quantized vertex positions back into the submesh's space
+		glm::mat4 DequantizeTransform{ 1.0f };
 		AABB BoundingBox;
 
+		// Simplified index ranges generated on import, they share the submesh's vertices
+		std::array<SubmeshLOD, MaxLODCount - 1> SimplifiedLODs{};
+		uint32_t SimplifiedLODCount = 0;
+
 		std::string NodeName, MeshName;
+
+		uint32_t GetLODCount() const { return SimplifiedLODCount + 1; }
+		// LOD 0 is the full detail range
+		SubmeshLOD GetLOD(uint32_t lod) const { return lod == 0 ? SubmeshLOD{ BaseIndex, IndexCount, 0.0f } : SimplifiedLODs[lod - 1]; }
 	};
 
+	struct MeshMaterialDescription;
+
 	class Mesh : public Asset
 	{
 	public:
@@ -151,16 +196,38 @@ namespace Hazel {
 		const std::vector<Ref<Material>>& GetMaterials() const { return m_Materials; }
 		const std::vector<Ref<Texture2D>>& GetTextures() const { return m_Textures; }
 		const std::string& GetFilePath() const { return m_FilePath; }
+		// Hash of the source file's contents, 0 for meshes built in code
+		uint64_t GetSourceHash() const { return m_SourceHash; }
+		// Every texture the materials reference, including ones that failed to load
+		const std::vector<std::string>& GetTextureFilePaths() const { return m_TextureFilePaths; }
+		// Files besides the source the importer read, e.g. .mtl files and .bin buffers
+		const std::vector<std::string>& GetSourceFilePaths() const { return m_SourceFilePaths; }
+		bool IsAnimated() const { return m_IsAnimated; }
+
+		// Closest hit nearer than maxDistance of a ray given in the submesh's space (before Submesh::Transform). Static meshes
+		// only, the first raycast waits for the BVHs to be built if BuildBVHsAsync hasn't finished them yet.
+		bool RaycastSubmesh(uint32_t submeshIndex, const Ray& ray, float& outDistance, float maxDistance = std::numeric_limits<float>::max());
+		// Builds the raycast BVHs of all submeshes on a worker
+		void BuildBVHsAsync();
+
+		const Ref<VertexBuffer>& GetVertexBuffer() { return m_VertexBuffer; }
+		const Ref<IndexBuffer>& GetIndexBuffer() { return m_IndexBuffer; }
+		const VertexBufferLayout& GetVertexBufferLayout() const { return m_VertexBufferLayout; }
+		MeshVertexFormat GetVertexFormat() const { return m_VertexFormat; }
+		// Vertex cache efficiency of all submeshes before and after import optimization, zero if it was skipped
+		const MeshOptimizationStatistics& GetOptimizationStatistics() const { return m_OptimizationStatistics; }
 
-		const std::vector<Triangle> GetTriangleCache(uint32_t index) const { return m_TriangleCache.at(index); }
+		static VertexBufferLayout GetStaticVertexLayout(MeshVertexFormat format);
 
-		Ref<VertexBuffer> GetVertexBuffer() { return m_VertexBuffer; }
-		Ref<IndexBuffer> GetIndexBuffer() { return m_IndexBuffer; }
-		const VertexBufferLayout& GetVertexBufferLayout() const { return m_VertexBufferLayout; }
+		virtual AssetMemoryUsage GetMemoryUsage() const override;
 	private:
 		void BoneTransform(float time);
 		void ReadNodeHierarchy(float AnimationTime, const aiNode* pNode, const glm::mat4& ParentTransform);
 		void TraverseNodes(aiNode* node, const glm::mat4& parentTransform = glm::mat4(1.0f), uint32_t level = 0);
+		void OptimizeSubmeshes();
+		void GenerateLODs();
+		void CreateMaterials(const std::vector<MeshMaterialDescription>& descriptions);
+		void CreateBuffers();
 
 		const aiNodeAnim* FindNodeAnim(const aiAnimation* animation, const std::string& nodeName);
 		uint32_t FindPosition(float AnimationTime, const aiNodeAnim* pNodeAnim);
@@ -174,7 +241,7 @@ namespace Hazel {
 		
 		std::unique_ptr<Assimp::Importer> m_Importer;
 
-		glm::mat4 m_InverseTransform;
+		glm::mat4 m_InverseTransform{ 1.0f };
 
 		uint32_t m_BoneCount = 0;
 		std::vector<BoneInfo> m_BoneInfo;
@@ -182,21 +249,27 @@ namespace Hazel {
 		Ref<VertexBuffer> m_VertexBuffer;
 		Ref<IndexBuffer> m_IndexBuffer;
 		VertexBufferLayout m_VertexBufferLayout;
+		MeshVertexFormat m_VertexFormat = MeshVertexFormat::Standard;
+		MeshOptimizationStatistics m_OptimizationStatistics;
 
 		std::vector<Vertex> m_StaticVertices;
 		std::vector<AnimatedVertex> m_AnimatedVertices;
 		std::vector<Index> m_Indices;
 		std::unordered_map<std::string, uint32_t> m_BoneMapping;
 		std::vector<glm::mat4> m_BoneTransforms;
-		const aiScene* m_Scene;
+		const aiScene* m_Scene = nullptr; // Only kept for animated meshes
 
 		// Materials
 		Ref<Shader> m_MeshShader;
 		std::vector<Ref<Texture2D>> m_Textures;
 		std::vector<Ref<Texture2D>> m_NormalMaps;
 		std::vector<Ref<Material>> m_Materials;
+		std::vector<std::string> m_TextureFilePaths;
 
-		std::unordered_map<uint32_t, std::vector<Triangle>> m_TriangleCache;
+		// Raycast acceleration, built on demand
+		std::vector<SubmeshBVH> m_SubmeshBVHs;
+		std::atomic<bool> m_BVHBuildStarted = false;
+		std::atomic<bool> m_BVHsBuilt = false;
 
 		// Animation
 		bool m_IsAnimated = false;
@@ -206,10 +279,13 @@ namespace Hazel {
 		bool m_AnimationPlaying = true;
 
 		std::string m_FilePath;
+		uint64_t m_SourceHash = 0;
+		std::vector<std::string> m_SourceFilePaths;
 
 		friend class Renderer;
 		friend class VulkanRenderer;
 		friend class OpenGLRenderer;
 		friend class SceneHierarchyPanel;
+		friend class MeshCooker;
 	};
 }
@@ -0,0 +1,125 @@
+#include "hzpch.h"
+#include "MeshBVH.h"
+
+#include "Hazel/Renderer/Mesh.h"
+
+namespace Hazel {
+
+	void SubmeshBVH::Build(const Vertex* vertices, const Index* triangles, uint32_t triangleCount)
+	{
+		std::vector<AABB> bounds(triangleCount);
+		for (uint32_t t = 0; t < triangleCount; t++)
+		{
+			const glm::vec3& a = vertices[triangles[t].V1].Position;
+			const glm::vec3& b = vertices[triangles[t].V2].Position;
+			const glm::vec3& c = vertices[triangles[t].V3].Position;
+			bounds[t] = { glm::min(a, glm::min(b, c)), glm::max(a, glm::max(b, c)) };
+		}
+
+		m_BVH.Build(bounds.data(), triangleCount);
+	}
+
+#if HZ_BVH_SSE
+	// Same test as Ray::IntersectsTriangle (back faces are culled), four triangles per iteration
+	static bool IntersectTriangles(const Ray& ray, const Vertex* vertices, const Index* triangles, const uint32_t* primitives, uint32_t count, float& closest)
+	{
+		const __m128 originX = _mm_set1_ps(ray.Origin.x), originY = _mm_set1_ps(ray.Origin.y), originZ = _mm_set1_ps(ray.Origin.z);
+		const __m128 directionX = _mm_set1_ps(ray.Direction.x), directionY = _mm_set1_ps(ray.Direction.y), directionZ = _mm_set1_ps(ray.Direction.z);
+		const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+
+		bool hit = false;
+		for (uint32_t first = 0; first < count; first += 4)
+		{
+			// Gather into x, y and z rows; short groups repeat their last triangle
+			alignas(16) float a[3][4], e1[3][4], e2[3][4];
+			for (uint32_t lane = 0; lane < 4; lane++)
+			{
+				const Index& triangle = triangles[primitives[glm::min(first + lane, count - 1)]];
+				const glm::vec3& p0 = vertices[triangle.V1].Position;
+				glm::vec3 edge1 = vertices[triangle.V2].Position - p0;
+				glm::vec3 edge2 = vertices[triangle.V3].Position - p0;
+				for (int axis = 0; axis < 3; axis++)
+				{
+					a[axis][lane] = p0[axis];
+					e1[axis][lane] = edge1[axis];
+					e2[axis][lane] = edge2[axis];
+				}
+			}
+
+			__m128 e1x = _mm_load_ps(e1[0]), e1y = _mm_load_ps(e1[1]), e1z = _mm_load_ps(e1[2]);
+			__m128 e2x = _mm_load_ps(e2[0]), e2y = _mm_load_ps(e2[1]), e2z = _mm_load_ps(e2[2]);
+
+			// N = E1 x E2
+			__m128 nx = _mm_sub_ps(_mm_mul_ps(e1y, e2z), _mm_mul_ps(e1z, e2y));
+			__m128 ny = _mm_sub_ps(_mm_mul_ps(e1z, e2x), _mm_mul_ps(e1x, e2z));
+			__m128 nz = _mm_sub_ps(_mm_mul_ps(e1x, e2y), _mm_mul_ps(e1y, e2x));
+
+			__m128 det = _mm_sub_ps(zero, _mm_add_ps(_mm_add_ps(_mm_mul_ps(directionX, nx), _mm_mul_ps(directionY, ny)), _mm_mul_ps(directionZ, nz)));
+			__m128 inverseDet = _mm_div_ps(one, det);
+
+			// AO = O - A, DAO = AO x D
+			__m128 aox = _mm_sub_ps(originX, _mm_load_ps(a[0]));
+			__m128 aoy = _mm_sub_ps(originY, _mm_load_ps(a[1]));
+			__m128 aoz = _mm_sub_ps(originZ, _mm_load_ps(a[2]));
+			__m128 daox = _mm_sub_ps(_mm_mul_ps(aoy, directionZ), _mm_mul_ps(aoz, directionY));
+			__m128 daoy = _mm_sub_ps(_mm_mul_ps(aoz, directionX), _mm_mul_ps(aox, directionZ));
+			__m128 daoz = _mm_sub_ps(_mm_mul_ps(aox, directionY), _mm_mul_ps(aoy, directionX));
+
+			__m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, daox), _mm_mul_ps(e2y, daoy)), _mm_mul_ps(e2z, daoz)), inverseDet);
+			__m128 v = _mm_mul_ps(_mm_sub_ps(zero, _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, daox), _mm_mul_ps(e1y, daoy)), _mm_mul_ps(e1z, daoz))), inverseDet);
+			__m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(aox, nx), _mm_mul_ps(aoy, ny)), _mm_mul_ps(aoz, nz)), inverseDet);
+
+			__m128 mask = _mm_and_ps(_mm_cmpge_ps(det, _mm_set1_ps(1e-6f)), _mm_cmpge_ps(t, zero));
+			mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmpge_ps(v, zero)));
+			mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmple_ps(_mm_add_ps(u, v), one), _mm_cmplt_ps(t, _mm_set1_ps(closest))));
+
+			int lanes = _mm_movemask_ps(mask);
+			if (!lanes)
+				continue;
+
+			alignas(16) float distances[4];
+			_mm_store_ps(distances, t);
+			for (uint32_t lane = 0; lane < 4; lane++)
+			{
+				if ((lanes & (1 << lane)) && distances[lane] < closest)
+				{
+					closest = distances[lane];
+					hit = true;
+				}
+			}
+		}
+
+		return hit;
+	}
+#else
+	static bool IntersectTriangles(const Ray& ray, const Vertex* vertices, const Index* triangles, const uint32_t* primitives, uint32_t count, float& closest)
+	{
+		bool hit = false;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const Index& triangle = triangles[primitives[i]];
+			float t;
+			if (ray.IntersectsTriangle(vertices[triangle.V1].Position, vertices[triangle.V2].Position, vertices[triangle.V3].Position, t) && t < closest)
+			{
+				closest = t;
+				hit = true;
+			}
+		}
+		return hit;
+	}
+#endif
+
+	bool SubmeshBVH::Raycast(const Ray& ray, const Vertex* vertices, const Index* triangles, float& outDistance, float maxDistance) const
+	{
+		float closest = maxDistance;
+		bool hit = m_BVH.Raycast(ray, closest, [&](const uint32_t* primitives, uint32_t count, float& closest)
+		{
+			return IntersectTriangles(ray, vertices, triangles, primitives, count, closest);
+		});
+
+		if (hit)
+			outDistance = closest;
+		return hit;
+	}
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <limits>
+
+#include "Hazel/Math/BVH.h"
+
+namespace Hazel {
+
+	struct Vertex;
+	struct Index;
+
+	// Bounding volume hierarchy over one submesh's triangles for ray queries on the CPU. Only the tree is stored,
+	// positions are read from the mesh's vertex and index data while testing, four triangles at a time.
+	class SubmeshBVH
+	{
+	public:
+		// vertices start at the submesh's base vertex, triangles at its first triangle
+		void Build(const Vertex* vertices, const Index* triangles, uint32_t triangleCount);
+
+		// Closest hit along the ray nearer than maxDistance, in the submesh's space. vertices and triangles must be
+		// what the BVH was built from.
+		bool Raycast(const Ray& ray, const Vertex* vertices, const Index* triangles, float& outDistance, float maxDistance = std::numeric_limits<float>::max()) const;
+
+		size_t GetMemoryUsage() const { return m_BVH.GetMemoryUsage(); }
+	private:
+		BVH m_BVH;
+	};
+
+}
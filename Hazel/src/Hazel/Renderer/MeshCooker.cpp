@@ -0,0 +1,388 @@
+#include "hzpch.h"
+#include "MeshCooker.h"
+
+#include "Hazel/Asset/DerivedDataCache.h"
+
+namespace Hazel {
+
+	static constexpr char s_CookedMeshMagic[4] = { 'H', 'M', 'S', 'H' };
+	static constexpr uint32_t s_CookedMeshVersion = 4;
+	static constexpr uint32_t s_SectionAlignment = 16;
+
+	struct CookedMeshHeader
+	{
+		char Magic[4];
+		uint32_t Version;
+		uint32_t VertexStride; // Guards against Vertex changing without a version bump
+		uint32_t VertexCount;
+		uint32_t IndexCount; // In triangles
+		uint32_t SubmeshCount;
+		uint32_t MaterialCount;
+		uint32_t StringsSize;
+		uint32_t VertexFormat; // MeshVertexFormat
+		MeshOptimizationStatistics OptimizationStatistics;
+
+		uint64_t VerticesOffset;
+		uint64_t IndicesOffset;
+		uint64_t SubmeshesOffset;
+		uint64_t MaterialsOffset;
+		uint64_t StringsOffset;
+	};
+
+	// Offset and length into the string blob
+	struct CookedString
+	{
+		uint32_t Offset;
+		uint32_t Length;
+	};
+
+	struct CookedSubmesh
+	{
+		uint32_t BaseVertex;
+		uint32_t BaseIndex;
+		uint32_t MaterialIndex;
+		uint32_t IndexCount;
+		uint32_t VertexCount;
+		glm::mat4 Transform;
+		glm::vec3 BoundsMin;
+		glm::vec3 BoundsMax;
+		uint32_t SimplifiedLODCount;
+		SubmeshLOD SimplifiedLODs[Submesh::MaxLODCount - 1];
+		CookedString NodeName;
+		CookedString MeshName;
+	};
+
+	struct CookedMaterial
+	{
+		glm::vec3 AlbedoColor;
+		float Roughness;
+		float Metalness;
+		CookedString Name;
+		CookedString AlbedoMap;
+		CookedString NormalMap;
+		CookedString RoughnessMap;
+		CookedString MetalnessMap;
+	};
+
+	static uint64_t AlignOffset(uint64_t offset, uint64_t alignment)
+	{
+		return (offset + alignment - 1) & ~(alignment - 1);
+	}
+
+	static CookedString AddString(std::string& strings, const std::string& string)
+	{
+		CookedString result = { (uint32_t)strings.size(), (uint32_t)string.size() };
+		strings += string;
+		return result;
+	}
+
+	static bool ReadString(const char* strings, uint32_t stringsSize, const CookedString& string, std::string& outString)
+	{
+		if ((uint64_t)string.Offset + string.Length > stringsSize)
+			return false;
+
+		outString.assign(strings + string.Offset, string.Length);
+		return true;
+	}
+
+	static DerivedDataKey GetSourceFilesKey(uint64_t sourceHash)
+	{
+		DerivedDataKey key("mesh-sources");
+		key.Add(s_CookedMeshVersion).Add(sourceHash);
+		return key;
+	}
+
+	DerivedDataKey MeshCooker::GetCacheKey(uint64_t sourceHash, const std::vector<std::string>& sourceFilePaths)
+	{
+		DerivedDataKey key("meshes");
+		key.Add(s_CookedMeshVersion).Add((uint32_t)sizeof(Vertex)).Add(sourceHash);
+		key.Add((uint32_t)sourceFilePaths.size());
+		for (const std::string& filepath : sourceFilePaths)
+			key.Add(filepath).AddFile(filepath);
+		key.Add(s_Settings.CompactVertices).Add(s_Settings.MaxQuantizationError).Add(s_Settings.MaxCompactTexcoord);
+		key.Add(s_Settings.OptimizeMeshes).Add(s_Settings.OverdrawThreshold);
+		key.Add(s_Settings.LODCount).Add(s_Settings.LODReduction).Add(s_Settings.MaxLODError);
+		return key;
+	}
+
+	// Stored as a count, then a length and the characters for every path
+	bool MeshCooker::LoadSourceFiles(uint64_t sourceHash, std::vector<std::string>& outFilePaths)
+	{
+		Buffer file;
+		if (!DerivedDataCache::Get(GetSourceFilesKey(sourceHash), file))
+			return false;
+
+		const uint8_t* data = (const uint8_t*)file.Data;
+		uint64_t offset = 0;
+		auto read = [&](void* destination, uint64_t size)
+		{
+			if (offset + size > file.Size)
+				return false;
+
+			memcpy(destination, data + offset, size);
+			offset += size;
+			return true;
+		};
+
+		uint32_t count;
+		bool valid = read(&count, sizeof(count));
+		outFilePaths.clear();
+		for (uint32_t i = 0; valid && i < count; i++)
+		{
+			uint32_t length;
+			valid = read(&length, sizeof(length)) && offset + length <= file.Size;
+			if (valid)
+			{
+				outFilePaths.emplace_back((const char*)data + offset, length);
+				offset += length;
+			}
+		}
+
+		file.Release();
+		if (!valid)
+		{
+			outFilePaths.clear();
+			return false;
+		}
+		return true;
+	}
+
+	void MeshCooker::WriteSourceFiles(uint64_t sourceHash, const std::vector<std::string>& filePaths)
+	{
+		std::vector<uint8_t> data;
+		auto write = [&](const void* source, size_t size) { data.insert(data.end(), (const uint8_t*)source, (const uint8_t*)source + size); };
+
+		uint32_t count = (uint32_t)filePaths.size();
+		write(&count, sizeof(count));
+		for (const std::string& filepath : filePaths)
+		{
+			uint32_t length = (uint32_t)filepath.size();
+			write(&length, sizeof(length));
+			write(filepath.data(), length);
+		}
+
+		DerivedDataCache::Put(GetSourceFilesKey(sourceHash), data.data(), data.size());
+	}
+
+	MeshVertexFormat MeshCooker::SelectVertexFormat(const Mesh& mesh)
+	{
+		if (!s_Settings.CompactVertices || mesh.m_IsAnimated || mesh.m_StaticVertices.empty())
+			return MeshVertexFormat::Standard;
+
+		for (const Vertex& vertex : mesh.m_StaticVertices)
+		{
+			if (glm::abs(vertex.Texcoord.x) > s_Settings.MaxCompactTexcoord || glm::abs(vertex.Texcoord.y) > s_Settings.MaxCompactTexcoord)
+				return MeshVertexFormat::Standard;
+		}
+
+		// Quantization is uniform across the axes (see Mesh::CreateBuffers), the largest extent decides the error
+		for (const Submesh& submesh : mesh.m_Submeshes)
+		{
+			if (submesh.VertexCount == 0)
+				continue;
+
+			glm::vec3 halfExtents = (submesh.BoundingBox.Max - submesh.BoundingBox.Min) * 0.5f;
+			float error = glm::max(halfExtents.x, glm::max(halfExtents.y, halfExtents.z)) / 32767.0f;
+			if (!(error <= s_Settings.MaxQuantizationError))
+				return MeshVertexFormat::Compact;
+		}
+
+		return MeshVertexFormat::CompactQuantized;
+	}
+
+	bool MeshCooker::Load(const DerivedDataKey& key, Mesh& mesh, std::vector<MeshMaterialDescription>& outMaterials)
+	{
+		Buffer file;
+		if (!DerivedDataCache::Get(key, file))
+			return false;
+
+		auto fail = [&](const char* reason)
+		{
+			HZ_CORE_WARN("Ignoring cooked mesh {0}: {1}", mesh.GetFilePath(), reason);
+			file.Release();
+			return false;
+		};
+
+		if (file.Size < sizeof(CookedMeshHeader))
+			return fail("data is truncated");
+
+		const uint8_t* data = (const uint8_t*)file.Data;
+		const CookedMeshHeader& header = *(const CookedMeshHeader*)data;
+		if (memcmp(header.Magic, s_CookedMeshMagic, sizeof(s_CookedMeshMagic)) != 0 || header.Version != s_CookedMeshVersion)
+			return fail("unsupported format version");
+
+		if (header.VertexStride != sizeof(Vertex))
+			return fail("vertex layout changed");
+
+		if (header.VertexFormat >= (uint32_t)MeshVertexFormat::Count)
+			return fail("unknown vertex format");
+
+		auto sectionFits = [&](uint64_t offset, uint64_t size)
+		{
+			return offset <= file.Size && size <= file.Size - offset;
+		};
+
+		if (!sectionFits(header.VerticesOffset, (uint64_t)header.VertexCount * sizeof(Vertex))
+			|| !sectionFits(header.IndicesOffset, (uint64_t)header.IndexCount * sizeof(Index))
+			|| !sectionFits(header.SubmeshesOffset, (uint64_t)header.SubmeshCount * sizeof(CookedSubmesh))
+			|| !sectionFits(header.MaterialsOffset, (uint64_t)header.MaterialCount * sizeof(CookedMaterial))
+			|| !sectionFits(header.StringsOffset, header.StringsSize))
+			return fail("section out of bounds");
+
+		const Vertex* vertices = (const Vertex*)(data + header.VerticesOffset);
+		const Index* indices = (const Index*)(data + header.IndicesOffset);
+		const CookedSubmesh* submeshes = (const CookedSubmesh*)(data + header.SubmeshesOffset);
+		const CookedMaterial* materials = (const CookedMaterial*)(data + header.MaterialsOffset);
+		const char* strings = (const char*)(data + header.StringsOffset);
+
+		// Whole triangles inside the index data, referencing only the submesh's own vertices
+		auto trianglesFit = [&](uint32_t baseIndex, uint32_t indexCount, uint32_t vertexCount)
+		{
+			if (baseIndex % 3 != 0 || indexCount % 3 != 0 || (uint64_t)baseIndex + indexCount > (uint64_t)header.IndexCount * 3)
+				return false;
+
+			for (uint32_t t = baseIndex / 3; t < (baseIndex + indexCount) / 3; t++)
+			{
+				if (indices[t].V1 >= vertexCount || indices[t].V2 >= vertexCount || indices[t].V3 >= vertexCount)
+					return false;
+			}
+			return true;
+		};
+
+		std::vector<Submesh> meshSubmeshes(header.SubmeshCount);
+		for (uint32_t i = 0; i < header.SubmeshCount; i++)
+		{
+			const CookedSubmesh& cooked = submeshes[i];
+			if ((uint64_t)cooked.BaseVertex + cooked.VertexCount > header.VertexCount || !trianglesFit(cooked.BaseIndex, cooked.IndexCount, cooked.VertexCount))
+				return fail("submesh out of bounds");
+			if (cooked.MaterialIndex >= header.MaterialCount)
+				return fail("material index out of bounds");
+
+			Submesh& submesh = meshSubmeshes[i];
+			submesh.BaseVertex = cooked.BaseVertex;
+			submesh.BaseIndex = cooked.BaseIndex;
+			submesh.MaterialIndex = cooked.MaterialIndex;
+			submesh.IndexCount = cooked.IndexCount;
+			submesh.VertexCount = cooked.VertexCount;
+			submesh.Transform = cooked.Transform;
+			submesh.BoundingBox.Min = cooked.BoundsMin;
+			submesh.BoundingBox.Max = cooked.BoundsMax;
+
+			if (cooked.SimplifiedLODCount >= Submesh::MaxLODCount)
+				return fail("too many LODs");
+
+			submesh.SimplifiedLODCount = cooked.SimplifiedLODCount;
+			for (uint32_t lod = 0; lod < cooked.SimplifiedLODCount; lod++)
+			{
+				const SubmeshLOD& cookedLOD = cooked.SimplifiedLODs[lod];
+				if (!trianglesFit(cookedLOD.BaseIndex, cookedLOD.IndexCount, cooked.VertexCount))
+					return fail("LOD out of bounds");
+
+				submesh.SimplifiedLODs[lod] = cookedLOD;
+			}
+
+			if (!ReadString(strings, header.StringsSize, cooked.NodeName, submesh.NodeName) || !ReadString(strings, header.StringsSize, cooked.MeshName, submesh.MeshName))
+				return fail("string out of bounds");
+		}
+
+		std::vector<MeshMaterialDescription> descriptions(header.MaterialCount);
+		for (uint32_t i = 0; i < header.MaterialCount; i++)
+		{
+			const CookedMaterial& cooked = materials[i];
+			MeshMaterialDescription& description = descriptions[i];
+			description.AlbedoColor = cooked.AlbedoColor;
+			description.Roughness = cooked.Roughness;
+			description.Metalness = cooked.Metalness;
+			if (!ReadString(strings, header.StringsSize, cooked.Name, description.Name)
+				|| !ReadString(strings, header.StringsSize, cooked.AlbedoMap, description.AlbedoMap)
+				|| !ReadString(strings, header.StringsSize, cooked.NormalMap, description.NormalMap)
+				|| !ReadString(strings, header.StringsSize, cooked.RoughnessMap, description.RoughnessMap)
+				|| !ReadString(strings, header.StringsSize, cooked.MetalnessMap, description.MetalnessMap))
+				return fail("string out of bounds");
+		}
+
+		// Vertex and index data is stored exactly as it's kept in memory, a straight copy out of the entry
+		mesh.m_StaticVertices.assign(vertices, vertices + header.VertexCount);
+		mesh.m_Indices.assign(indices, indices + header.IndexCount);
+		mesh.m_Submeshes = std::move(meshSubmeshes);
+		mesh.m_VertexFormat = (MeshVertexFormat)header.VertexFormat; // Range checked with the header
+		mesh.m_OptimizationStatistics = header.OptimizationStatistics;
+		outMaterials = std::move(descriptions);
+
+		file.Release();
+		return true;
+	}
+
+	void MeshCooker::Write(const DerivedDataKey& key, const Mesh& mesh, const std::vector<MeshMaterialDescription>& materials)
+	{
+		std::string strings;
+		std::vector<CookedSubmesh> submeshes(mesh.m_Submeshes.size());
+		for (size_t i = 0; i < mesh.m_Submeshes.size(); i++)
+		{
+			const Submesh& submesh = mesh.m_Submeshes[i];
+			CookedSubmesh& cooked = submeshes[i];
+			cooked.BaseVertex = submesh.BaseVertex;
+			cooked.BaseIndex = submesh.BaseIndex;
+			cooked.MaterialIndex = submesh.MaterialIndex;
+			cooked.IndexCount = submesh.IndexCount;
+			cooked.VertexCount = submesh.VertexCount;
+			cooked.Transform = submesh.Transform;
+			cooked.BoundsMin = submesh.BoundingBox.Min;
+			cooked.BoundsMax = submesh.BoundingBox.Max;
+			cooked.SimplifiedLODCount = submesh.SimplifiedLODCount;
+			std::copy(submesh.SimplifiedLODs.begin(), submesh.SimplifiedLODs.end(), cooked.SimplifiedLODs);
+			cooked.NodeName = AddString(strings, submesh.NodeName);
+			cooked.MeshName = AddString(strings, submesh.MeshName);
+		}
+
+		std::vector<CookedMaterial> cookedMaterials(materials.size());
+		for (size_t i = 0; i < materials.size(); i++)
+		{
+			const MeshMaterialDescription& description = materials[i];
+			CookedMaterial& cooked = cookedMaterials[i];
+			cooked.AlbedoColor = description.AlbedoColor;
+			cooked.Roughness = description.Roughness;
+			cooked.Metalness = description.Metalness;
+			cooked.Name = AddString(strings, description.Name);
+			cooked.AlbedoMap = AddString(strings, description.AlbedoMap);
+			cooked.NormalMap = AddString(strings, description.NormalMap);
+			cooked.RoughnessMap = AddString(strings, description.RoughnessMap);
+			cooked.MetalnessMap = AddString(strings, description.MetalnessMap);
+		}
+
+		CookedMeshHeader header = {};
+		memcpy(header.Magic, s_CookedMeshMagic, sizeof(s_CookedMeshMagic));
+		header.Version = s_CookedMeshVersion;
+		header.VertexStride = sizeof(Vertex);
+		header.VertexCount = (uint32_t)mesh.m_StaticVertices.size();
+		header.IndexCount = (uint32_t)mesh.m_Indices.size();
+		header.SubmeshCount = (uint32_t)submeshes.size();
+		header.MaterialCount = (uint32_t)cookedMaterials.size();
+		header.StringsSize = (uint32_t)strings.size();
+		header.VertexFormat = (uint32_t)mesh.m_VertexFormat;
+		header.OptimizationStatistics = mesh.m_OptimizationStatistics;
+
+		header.VerticesOffset = AlignOffset(sizeof(CookedMeshHeader), s_SectionAlignment);
+		header.IndicesOffset = AlignOffset(header.VerticesOffset + header.VertexCount * sizeof(Vertex), s_SectionAlignment);
+		header.SubmeshesOffset = AlignOffset(header.IndicesOffset + header.IndexCount * sizeof(Index), s_SectionAlignment);
+		header.MaterialsOffset = AlignOffset(header.SubmeshesOffset + header.SubmeshCount * sizeof(CookedSubmesh), s_SectionAlignment);
+		header.StringsOffset = AlignOffset(header.MaterialsOffset + header.MaterialCount * sizeof(CookedMaterial), s_SectionAlignment);
+
+		std::vector<uint8_t> buffer(header.StringsOffset + header.StringsSize, 0);
+		memcpy(buffer.data(), &header, sizeof(header));
+		memcpy(buffer.data() + header.VerticesOffset, mesh.m_StaticVertices.data(), header.VertexCount * sizeof(Vertex));
+		memcpy(buffer.data() + header.IndicesOffset, mesh.m_Indices.data(), header.IndexCount * sizeof(Index));
+		memcpy(buffer.data() + header.SubmeshesOffset, submeshes.data(), submeshes.size() * sizeof(CookedSubmesh));
+		memcpy(buffer.data() + header.MaterialsOffset, cookedMaterials.data(), cookedMaterials.size() * sizeof(CookedMaterial));
+		memcpy(buffer.data() + header.StringsOffset, strings.data(), strings.size());
+
+		DerivedDataCache::Put(key, buffer.data(), buffer.size());
+
+		uint32_t stride = Mesh::GetStaticVertexLayout(mesh.m_VertexFormat).GetStride();
+		HZ_CORE_INFO("Cooked mesh {0}: {1} vertices, {2} bytes per vertex on the GPU ({3} KB, {4} KB in the standard format)", mesh.GetFilePath(),
+			header.VertexCount, stride, (uint64_t)header.VertexCount * stride / 1024, (uint64_t)header.VertexCount * sizeof(Vertex) / 1024);
+	}
+
+	MeshCookSettings MeshCooker::s_Settings;
+
+}
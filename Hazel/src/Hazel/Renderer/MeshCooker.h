@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Hazel/Renderer/Mesh.h"
+#include "Hazel/Asset/DerivedDataCache.h"
+
+namespace Hazel {
+
+	// Everything needed to recreate a mesh material without going through assimp again
+	struct MeshMaterialDescription
+	{
+		std::string Name;
+		glm::vec3 AlbedoColor{ 0.8f };
+		float Roughness = 0.8f;
+		float Metalness = 0.0f;
+
+		// Relative to the mesh's directory, empty if the material has no such map
+		std::string AlbedoMap;
+		std::string NormalMap;
+		std::string RoughnessMap;
+		std::string MetalnessMap;
+	};
+
+	struct MeshCookSettings
+	{
+		// Static meshes are given a compact GPU vertex format when it keeps enough precision
+		bool CompactVertices = true;
+		// Largest error quantizing positions to 16 bits against the submesh bounds may introduce, in the
+		// submesh's units. Meshes with submeshes too large for it keep float positions.
+		float MaxQuantizationError = 0.0005f;
+		// Half float texcoords lose a bit of precision with every power of two, meshes with texcoords outside
+		// of [-MaxCompactTexcoord, MaxCompactTexcoord] keep the standard format
+		float MaxCompactTexcoord = 4.0f;
+
+		// Reorder each submesh's triangles and vertices for the vertex cache, overdraw and vertex fetch
+		bool OptimizeMeshes = true;
+		// How much worse than the vertex cache optimal order the overdraw pass may make a submesh (1.05 = 5% more misses)
+		float OverdrawThreshold = 1.05f;
+
+		// Simplified LODs per submesh of static meshes, each aiming for LODReduction times the previous one's triangles.
+		// Simplification stops at MaxLODError, relative to the submesh's bounding radius.
+		uint32_t LODCount = Submesh::MaxLODCount; // Including the full detail geometry, 1 disables LODs
+		float LODReduction = 0.5f;
+		float MaxLODError = 0.05f;
+	};
+
+	// Reads and writes the cooked form of static meshes: the (optimized) vertex and index data including LODs,
+	// the GPU vertex format picked for the mesh and its vertex cache statistics, plus submeshes and material
+	// descriptions. Stored in the DerivedDataCache, keyed by a hash of the contents of the source file and every
+	// companion file the importer read, so editing any of them simply produces a new entry.
+	class MeshCooker
+	{
+	public:
+		static DerivedDataKey GetCacheKey(uint64_t sourceHash, const std::vector<std::string>& sourceFilePaths);
+
+		// The companion files of a source are only known after importing it, so they're recorded under the source's
+		// hash when cooking and read back before building the key of a later load
+		static bool LoadSourceFiles(uint64_t sourceHash, std::vector<std::string>& outFilePaths);
+		static void WriteSourceFiles(uint64_t sourceHash, const std::vector<std::string>& filePaths);
+
+		// Changing the settings cooks meshes again the next time they are loaded
+		static void SetSettings(const MeshCookSettings& settings) { s_Settings = settings; }
+		static const MeshCookSettings& GetSettings() { return s_Settings; }
+
+		// The most compact vertex format that stays within the settings' precision limits
+		static MeshVertexFormat SelectVertexFormat(const Mesh& mesh);
+
+		static bool Load(const DerivedDataKey& key, Mesh& mesh, std::vector<MeshMaterialDescription>& outMaterials);
+		static void Write(const DerivedDataKey& key, const Mesh& mesh, const std::vector<MeshMaterialDescription>& materials);
+	private:
+		static MeshCookSettings s_Settings;
+	};
+
+}
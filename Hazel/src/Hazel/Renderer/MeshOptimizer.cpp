@@ -0,0 +1,707 @@
+#include "hzpch.h"
+#include "MeshOptimizer.h"
+
+#include "Hazel/Renderer/Mesh.h"
+
+namespace Hazel {
+
+	// Forsyth's scoring model: an LRU cache larger than the real one, favouring vertices used recently
+	// and vertices with few triangles left (so they are finished off instead of left behind)
+	static constexpr uint32_t s_ScoringCacheSize = 32;
+	static constexpr float s_CacheDecayPower = 1.5f;
+	static constexpr float s_LastTriangleScore = 0.75f;
+	static constexpr float s_ValenceBoostScale = 2.0f;
+	static constexpr float s_ValenceBoostPower = 0.5f;
+
+	static float GetVertexScore(int32_t cachePosition, uint32_t liveTriangles)
+	{
+		if (liveTriangles == 0)
+			return -1.0f;
+
+		float score = 0.0f;
+		if (cachePosition >= 0)
+		{
+			// The last triangle's vertices get a fixed score, so the next triangle isn't biased towards one of them
+			if (cachePosition < 3)
+				score = s_LastTriangleScore;
+			else
+				score = glm::pow(1.0f - (float)(cachePosition - 3) / (s_ScoringCacheSize - 3), s_CacheDecayPower);
+		}
+
+		return score + s_ValenceBoostScale * glm::pow((float)liveTriangles, -s_ValenceBoostPower);
+	}
+
+	void MeshOptimizer::OptimizeVertexCache(uint32_t* indices, uint32_t indexCount, uint32_t vertexCount)
+	{
+		uint32_t triangleCount = indexCount / 3;
+		if (triangleCount < 2)
+			return;
+
+		// Triangles still to be emitted per vertex, as ranges of one shared array
+		std::vector<uint32_t> liveTriangles(vertexCount, 0);
+		for (uint32_t i = 0; i < triangleCount * 3; i++)
+		{
+			HZ_CORE_ASSERT(indices[i] < vertexCount);
+			liveTriangles[indices[i]]++;
+		}
+
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+		for (uint32_t v = 0; v < vertexCount; v++)
+			adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+
+		std::vector<uint32_t> adjacency(triangleCount * 3);
+		{
+			std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (uint32_t t = 0; t < triangleCount; t++)
+			{
+				for (uint32_t k = 0; k < 3; k++)
+					adjacency[fill[indices[t * 3 + k]]++] = t;
+			}
+		}
+
+		std::vector<int32_t> cachePositions(vertexCount, -1);
+		std::vector<float> vertexScores(vertexCount);
+		for (uint32_t v = 0; v < vertexCount; v++)
+			vertexScores[v] = GetVertexScore(-1, liveTriangles[v]);
+
+		std::vector<float> triangleScores(triangleCount);
+		std::vector<bool> emitted(triangleCount, false);
+
+		uint32_t bestTriangle = 0;
+		float bestScore = -FLT_MAX;
+		for (uint32_t t = 0; t < triangleCount; t++)
+		{
+			const uint32_t* triangle = indices + t * 3;
+			triangleScores[t] = vertexScores[triangle[0]] + vertexScores[triangle[1]] + vertexScores[triangle[2]];
+			if (triangleScores[t] > bestScore)
+			{
+				bestScore = triangleScores[t];
+				bestTriangle = t;
+			}
+		}
+
+		std::vector<uint32_t> output(triangleCount * 3);
+		std::array<uint32_t, s_ScoringCacheSize + 3> cache;
+		std::array<uint32_t, s_ScoringCacheSize + 3> newCache;
+		uint32_t cacheCount = 0;
+		uint32_t nextInputTriangle = 0;
+
+		for (uint32_t outputTriangle = 0; outputTriangle < triangleCount; outputTriangle++)
+		{
+			// Nothing in the cache has triangles left, carry on in input order
+			if (bestTriangle == UINT32_MAX)
+			{
+				while (emitted[nextInputTriangle])
+					nextInputTriangle++;
+				bestTriangle = nextInputTriangle;
+			}
+
+			const uint32_t* triangle = indices + bestTriangle * 3;
+			memcpy(&output[outputTriangle * 3], triangle, 3 * sizeof(uint32_t));
+			emitted[bestTriangle] = true;
+
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				uint32_t vertex = triangle[k];
+				uint32_t* begin = adjacency.data() + adjacencyOffsets[vertex];
+				uint32_t* end = begin + liveTriangles[vertex];
+				uint32_t* it = std::find(begin, end, bestTriangle);
+				HZ_CORE_ASSERT(it != end);
+				std::swap(*it, *(end - 1));
+				liveTriangles[vertex]--;
+			}
+
+			// The triangle's vertices move to the front, everything else shifts back
+			uint32_t newCacheCount = 0;
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				if (std::find(newCache.begin(), newCache.begin() + newCacheCount, triangle[k]) == newCache.begin() + newCacheCount)
+					newCache[newCacheCount++] = triangle[k];
+			}
+
+			for (uint32_t i = 0; i < cacheCount; i++)
+			{
+				uint32_t vertex = cache[i];
+				if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+					newCache[newCacheCount++] = vertex;
+			}
+
+			for (uint32_t i = 0; i < newCacheCount; i++)
+			{
+				uint32_t vertex = newCache[i];
+				cachePositions[vertex] = i < s_ScoringCacheSize ? (int32_t)i : -1;
+				vertexScores[vertex] = GetVertexScore(cachePositions[vertex], liveTriangles[vertex]);
+			}
+
+			// Only triangles around the cache changed score, the next one is picked from those
+			bestTriangle = UINT32_MAX;
+			bestScore = -FLT_MAX;
+			for (uint32_t i = 0; i < newCacheCount; i++)
+			{
+				uint32_t vertex = newCache[i];
+				const uint32_t* live = adjacency.data() + adjacencyOffsets[vertex];
+				for (uint32_t j = 0; j < liveTriangles[vertex]; j++)
+				{
+					uint32_t t = live[j];
+					const uint32_t* candidate = indices + t * 3;
+					triangleScores[t] = vertexScores[candidate[0]] + vertexScores[candidate[1]] + vertexScores[candidate[2]];
+					if (triangleScores[t] > bestScore)
+					{
+						bestScore = triangleScores[t];
+						bestTriangle = t;
+					}
+				}
+			}
+
+			cacheCount = glm::min(newCacheCount, s_ScoringCacheSize);
+			std::copy(newCache.begin(), newCache.begin() + cacheCount, cache.begin());
+		}
+
+		memcpy(indices, output.data(), output.size() * sizeof(uint32_t));
+	}
+
+	// FIFO cache simulation; a vertex is in the cache if it was transformed less than cacheSize misses ago.
+	// Bumping the timestamp by more than cacheSize flushes the cache.
+	struct FIFOCacheSimulation
+	{
+		std::vector<uint32_t> Timestamps;
+		uint32_t Timestamp;
+		uint32_t Size;
+
+		FIFOCacheSimulation(uint32_t vertexCount, uint32_t cacheSize)
+			: Timestamps(vertexCount, 0), Timestamp(cacheSize + 1), Size(cacheSize) {}
+
+		void Flush() { Timestamp += Size + 1; }
+
+		uint32_t Access(const uint32_t* triangle)
+		{
+			uint32_t misses = 0;
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				uint32_t vertex = triangle[k];
+				if (Timestamp - Timestamps[vertex] > Size)
+				{
+					Timestamps[vertex] = Timestamp++;
+					misses++;
+				}
+			}
+			return misses;
+		}
+	};
+
+	void MeshOptimizer::OptimizeOverdraw(uint32_t* indices, uint32_t indexCount, const Vertex* vertices, uint32_t vertexCount, float threshold)
+	{
+		uint32_t triangleCount = indexCount / 3;
+		if (triangleCount < 2)
+			return;
+
+		// Hard boundaries: wherever every vertex of a triangle misses, the cache starts over anyway
+		std::vector<uint32_t> hardClusters;
+		{
+			FIFOCacheSimulation cache(vertexCount, CacheSize);
+			for (uint32_t t = 0; t < triangleCount; t++)
+			{
+				if (cache.Access(indices + t * 3) == 3 || t == 0)
+					hardClusters.push_back(t);
+			}
+		}
+		hardClusters.push_back(triangleCount);
+
+		// Soft boundaries: split hard clusters further wherever the part so far is within threshold of the whole
+		// cluster's cache efficiency, so reordering the parts costs little
+		std::vector<uint32_t> clusters;
+		FIFOCacheSimulation cache(vertexCount, CacheSize);
+		for (size_t c = 0; c + 1 < hardClusters.size(); c++)
+		{
+			uint32_t start = hardClusters[c];
+			uint32_t end = hardClusters[c + 1];
+
+			cache.Flush();
+			uint32_t clusterMisses = 0;
+			for (uint32_t t = start; t < end; t++)
+				clusterMisses += cache.Access(indices + t * 3);
+
+			float clusterThreshold = threshold * (float)clusterMisses / (float)(end - start);
+
+			cache.Flush();
+			clusters.push_back(start);
+			uint32_t softStart = start;
+			uint32_t softMisses = 0;
+			for (uint32_t t = start; t < end; t++)
+			{
+				softMisses += cache.Access(indices + t * 3);
+				if (t + 1 < end && (float)softMisses <= clusterThreshold * (float)(t + 1 - softStart))
+				{
+					clusters.push_back(t + 1);
+					softStart = t + 1;
+					softMisses = 0;
+					cache.Flush();
+				}
+			}
+		}
+		clusters.push_back(triangleCount);
+
+		uint32_t clusterCount = (uint32_t)clusters.size() - 1;
+		if (clusterCount < 2)
+			return;
+
+		glm::vec3 meshCentroid(0.0f);
+		for (uint32_t v = 0; v < vertexCount; v++)
+			meshCentroid += vertices[v].Position;
+		meshCentroid /= (float)vertexCount;
+
+		// Clusters facing away from the mesh's center are drawn first, they are the most likely to occlude the rest
+		std::vector<float> sortKeys(clusterCount);
+		for (uint32_t c = 0; c < clusterCount; c++)
+		{
+			glm::vec3 centroid(0.0f);
+			glm::vec3 normal(0.0f);
+			float area = 0.0f;
+			for (uint32_t t = clusters[c]; t < clusters[c + 1]; t++)
+			{
+				const glm::vec3& p0 = vertices[indices[t * 3 + 0]].Position;
+				const glm::vec3& p1 = vertices[indices[t * 3 + 1]].Position;
+				const glm::vec3& p2 = vertices[indices[t * 3 + 2]].Position;
+
+				glm::vec3 triangleNormal = glm::cross(p1 - p0, p2 - p0);
+				float triangleArea = glm::length(triangleNormal);
+				centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+				normal += triangleNormal;
+				area += triangleArea;
+			}
+
+			float normalLength = glm::length(normal);
+			if (area > 0.0f)
+				centroid /= area;
+			if (normalLength > 0.0f)
+				normal /= normalLength;
+
+			sortKeys[c] = glm::dot(centroid - meshCentroid, normal);
+		}
+
+		std::vector<uint32_t> order(clusterCount);
+		for (uint32_t c = 0; c < clusterCount; c++)
+			order[c] = c;
+		std::stable_sort(order.begin(), order.end(), [&sortKeys](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+		std::vector<uint32_t> output;
+		output.reserve(triangleCount * 3);
+		for (uint32_t c : order)
+			output.insert(output.end(), indices + clusters[c] * 3, indices + clusters[c + 1] * 3);
+
+		memcpy(indices, output.data(), output.size() * sizeof(uint32_t));
+	}
+
+	void MeshOptimizer::OptimizeVertexFetch(uint32_t* indices, uint32_t indexCount, Vertex* vertices, uint32_t vertexCount)
+	{
+		std::vector<uint32_t> remap(vertexCount, UINT32_MAX);
+		uint32_t nextVertex = 0;
+		for (uint32_t i = 0; i < indexCount; i++)
+		{
+			uint32_t& index = indices[i];
+			HZ_CORE_ASSERT(index < vertexCount);
+			if (remap[index] == UINT32_MAX)
+				remap[index] = nextVertex++;
+			index = remap[index];
+		}
+
+		for (uint32_t v = 0; v < vertexCount; v++)
+		{
+			if (remap[v] == UINT32_MAX)
+				remap[v] = nextVertex++;
+		}
+
+		std::vector<Vertex> reordered(vertexCount);
+		for (uint32_t v = 0; v < vertexCount; v++)
+			reordered[remap[v]] = vertices[v];
+
+		std::copy(reordered.begin(), reordered.end(), vertices);
+	}
+
+	// Sum of squared distances to a set of planes, weighted by the area (or length) they were taken from
+	struct Quadric
+	{
+		float A00 = 0.0f, A11 = 0.0f, A22 = 0.0f;
+		float A10 = 0.0f, A20 = 0.0f, A21 = 0.0f;
+		float B0 = 0.0f, B1 = 0.0f, B2 = 0.0f;
+		float C = 0.0f;
+		float Weight = 0.0f;
+
+		Quadric() = default;
+
+		// Plane dot(normal, p) + distance = 0
+		Quadric(const glm::vec3& normal, float distance, float weight)
+		{
+			A00 = weight * normal.x * normal.x;
+			A11 = weight * normal.y * normal.y;
+			A22 = weight * normal.z * normal.z;
+			A10 = weight * normal.y * normal.x;
+			A20 = weight * normal.z * normal.x;
+			A21 = weight * normal.z * normal.y;
+			B0 = weight * normal.x * distance;
+			B1 = weight * normal.y * distance;
+			B2 = weight * normal.z * distance;
+			C = weight * distance * distance;
+			Weight = weight;
+		}
+
+		Quadric& operator+=(const Quadric& other)
+		{
+			A00 += other.A00; A11 += other.A11; A22 += other.A22;
+			A10 += other.A10; A20 += other.A20; A21 += other.A21;
+			B0 += other.B0; B1 += other.B1; B2 += other.B2;
+			C += other.C;
+			Weight += other.Weight;
+			return *this;
+		}
+
+		// Weighted mean squared distance of p to the planes
+		float GetError(const glm::vec3& p) const
+		{
+			float rx = 2.0f * (B0 + A10 * p.y) + A00 * p.x;
+			float ry = 2.0f * (B1 + A21 * p.z) + A11 * p.y;
+			float rz = 2.0f * (B2 + A20 * p.x) + A22 * p.z;
+			float r = C + rx * p.x + ry * p.y + rz * p.z;
+			return Weight > 0.0f ? glm::abs(r) / Weight : 0.0f;
+		}
+	};
+
+	struct PositionHash
+	{
+		size_t operator()(const glm::vec3& position) const
+		{
+			uint32_t bits[3];
+			memcpy(bits, &position, sizeof(bits));
+			return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+		}
+	};
+
+	enum class SimplifyVertexKind : uint8_t
+	{
+		Manifold, // Collapses onto any neighbour
+		Border,   // On an open border, only collapses along it
+		Locked    // Seams, corners and non-manifold vertices stay
+	};
+
+	// Open borders are weighted heavier than surfaces so silhouettes of open meshes keep their shape
+	static constexpr float s_BorderWeight = 10.0f;
+
+	uint32_t MeshOptimizer::Simplify(uint32_t* destination, const uint32_t* indices, uint32_t indexCount, const Vertex* vertices, uint32_t vertexCount,
+		uint32_t targetIndexCount, float targetError, float* outError)
+	{
+		HZ_CORE_ASSERT(indexCount % 3 == 0);
+		if (outError)
+			*outError = 0.0f;
+
+		if (destination != indices)
+			memcpy(destination, indices, indexCount * sizeof(uint32_t));
+
+		// Work in the unit cube, so the error limit and flip tests don't depend on the mesh's scale
+		glm::vec3 min(FLT_MAX), max(-FLT_MAX);
+		for (uint32_t v = 0; v < vertexCount; v++)
+		{
+			min = glm::min(min, vertices[v].Position);
+			max = glm::max(max, vertices[v].Position);
+		}
+		glm::vec3 size = max - min;
+		float extent = glm::max(size.x, glm::max(size.y, size.z));
+		if (!(extent > 0.0f))
+			extent = 1.0f;
+
+		std::vector<glm::vec3> positions(vertexCount);
+		for (uint32_t v = 0; v < vertexCount; v++)
+			positions[v] = (vertices[v].Position - min) / extent;
+
+		// Vertices split for normals or texcoords share a position, the topology is built on one of them
+		std::vector<uint32_t> canonical(vertexCount);
+		std::vector<uint32_t> wedgeCount(vertexCount, 0);
+		{
+			for (uint32_t v = 0; v < vertexCount; v++)
+				canonical[v] = v;
+
+			std::vector<bool> referenced(vertexCount, false);
+			for (uint32_t i = 0; i < indexCount; i++)
+			{
+				HZ_CORE_ASSERT(destination[i] < vertexCount);
+				referenced[destination[i]] = true;
+			}
+
+			std::unordered_map<glm::vec3, uint32_t, PositionHash> firstVertex;
+			firstVertex.reserve(vertexCount);
+			for (uint32_t v = 0; v < vertexCount; v++)
+			{
+				if (!referenced[v])
+					continue;
+
+				auto [it, inserted] = firstVertex.emplace(vertices[v].Position, v);
+				canonical[v] = it->second;
+				wedgeCount[it->second]++;
+			}
+		}
+
+		// Degenerate triangles don't contribute anything
+		uint32_t triangleCount = 0;
+		for (uint32_t t = 0; t < indexCount / 3; t++)
+		{
+			uint32_t c0 = canonical[destination[t * 3 + 0]], c1 = canonical[destination[t * 3 + 1]], c2 = canonical[destination[t * 3 + 2]];
+			if (c0 != c1 && c1 != c2 && c0 != c2)
+			{
+				memmove(destination + triangleCount * 3, destination + t * 3, 3 * sizeof(uint32_t));
+				triangleCount++;
+			}
+		}
+		indexCount = triangleCount * 3;
+
+		// Vertex -> triangles, rebuilt every pass
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+		std::vector<uint32_t> adjacency;
+		auto buildAdjacency = [&]()
+		{
+			std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+			for (uint32_t i = 0; i < indexCount; i++)
+				adjacencyOffsets[canonical[destination[i]] + 1]++;
+			for (uint32_t v = 0; v < vertexCount; v++)
+				adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+
+			adjacency.resize(indexCount);
+			std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (uint32_t i = 0; i < indexCount; i++)
+				adjacency[fill[canonical[destination[i]]]++] = i / 3;
+		};
+
+		// An edge is open if no triangle uses it the other way around
+		buildAdjacency();
+		auto hasEdge = [&](uint32_t from, uint32_t to)
+		{
+			for (uint32_t a = adjacencyOffsets[from]; a < adjacencyOffsets[from + 1]; a++)
+			{
+				const uint32_t* triangle = destination + adjacency[a] * 3;
+				for (uint32_t k = 0; k < 3; k++)
+				{
+					if (canonical[triangle[k]] == from && canonical[triangle[(k + 1) % 3]] == to)
+						return true;
+				}
+			}
+			return false;
+		};
+
+		std::vector<Quadric> quadrics(vertexCount);
+		std::vector<uint32_t> openOutgoing(vertexCount, 0), openIncoming(vertexCount, 0);
+		std::vector<uint32_t> borderNext(vertexCount, UINT32_MAX), borderPrevious(vertexCount, UINT32_MAX);
+		for (uint32_t t = 0; t < triangleCount; t++)
+		{
+			const uint32_t* triangle = destination + t * 3;
+			const glm::vec3& p0 = positions[triangle[0]];
+			glm::vec3 normal = glm::cross(positions[triangle[1]] - p0, positions[triangle[2]] - p0);
+			float area = glm::length(normal);
+			if (area > 0.0f)
+				normal /= area;
+
+			Quadric quadric(normal, -glm::dot(normal, p0), area);
+			for (uint32_t k = 0; k < 3; k++)
+				quadrics[canonical[triangle[k]]] += quadric;
+
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				uint32_t from = canonical[triangle[k]], to = canonical[triangle[(k + 1) % 3]];
+				if (hasEdge(to, from))
+					continue;
+
+				openOutgoing[from]++;
+				openIncoming[to]++;
+				borderNext[from] = to;
+				borderPrevious[to] = from;
+
+				// Plane through the edge, perpendicular to the triangle
+				glm::vec3 edge = positions[to] - positions[from];
+				float length = glm::length(edge);
+				glm::vec3 edgeNormal = glm::cross(edge, normal);
+				float edgeNormalLength = glm::length(edgeNormal);
+				if (edgeNormalLength > 0.0f)
+				{
+					edgeNormal /= edgeNormalLength;
+					Quadric borderQuadric(edgeNormal, -glm::dot(edgeNormal, positions[from]), length * length * s_BorderWeight);
+					quadrics[from] += borderQuadric;
+					quadrics[to] += borderQuadric;
+				}
+			}
+		}
+
+		std::vector<SimplifyVertexKind> kinds(vertexCount, SimplifyVertexKind::Locked);
+		for (uint32_t v = 0; v < vertexCount; v++)
+		{
+			if (canonical[v] != v || wedgeCount[v] != 1)
+				continue;
+
+			if (openOutgoing[v] == 0 && openIncoming[v] == 0)
+				kinds[v] = SimplifyVertexKind::Manifold;
+			else if (openOutgoing[v] == 1 && openIncoming[v] == 1)
+				kinds[v] = SimplifyVertexKind::Border;
+		}
+
+		struct Collapse
+		{
+			uint32_t Source; // Canonical vertex that is removed, it has a single wedge
+			uint32_t Target; // Vertex (wedge) it is replaced with
+			float Error;
+		};
+		std::vector<Collapse> collapses;
+		std::vector<bool> locked(vertexCount);
+		std::vector<bool> removed(vertexCount, false);
+		std::vector<uint32_t> remap(vertexCount);
+
+		// Moving source onto target must not turn any of its remaining triangles around
+		auto hasTriangleFlips = [&](uint32_t source, uint32_t target)
+		{
+			uint32_t targetCanonical = canonical[target];
+			for (uint32_t a = adjacencyOffsets[source]; a < adjacencyOffsets[source + 1]; a++)
+			{
+				const uint32_t* triangle = destination + adjacency[a] * 3;
+				if (canonical[triangle[0]] == targetCanonical || canonical[triangle[1]] == targetCanonical || canonical[triangle[2]] == targetCanonical)
+					continue;
+
+				glm::vec3 p[3] = { positions[triangle[0]], positions[triangle[1]], positions[triangle[2]] };
+				glm::vec3 oldNormal = glm::cross(p[1] - p[0], p[2] - p[0]);
+				for (uint32_t k = 0; k < 3; k++)
+				{
+					if (canonical[triangle[k]] == source)
+						p[k] = positions[target];
+				}
+				glm::vec3 newNormal = glm::cross(p[1] - p[0], p[2] - p[0]);
+
+				// Turning more than ~75 degrees counts, a few of those in a row would flip it too
+				if (glm::dot(oldNormal, newNormal) <= 0.25f * glm::length(oldNormal) * glm::length(newNormal))
+					return true;
+			}
+			return false;
+		};
+
+		float errorLimit = (targetError / extent) * (targetError / extent);
+		float maxError = 0.0f;
+		while (indexCount > targetIndexCount)
+		{
+			// Each pass collapses the cheapest edges whose neighbourhoods don't overlap, then rebuilds
+			buildAdjacency();
+
+			collapses.clear();
+			auto addCollapse = [&](uint32_t source, uint32_t target)
+			{
+				uint32_t targetCanonical = canonical[target];
+				if (kinds[source] == SimplifyVertexKind::Locked)
+					return;
+				if (kinds[source] == SimplifyVertexKind::Border && borderNext[source] != targetCanonical && borderPrevious[source] != targetCanonical)
+					return;
+
+				collapses.push_back({ source, target, quadrics[source].GetError(positions[target]) });
+			};
+
+			for (uint32_t i = 0; i < indexCount; i += 3)
+			{
+				for (uint32_t k = 0; k < 3; k++)
+				{
+					uint32_t i0 = destination[i + k], i1 = destination[i + (k + 1) % 3];
+					addCollapse(canonical[i0], i1);
+					addCollapse(canonical[i1], i0);
+				}
+			}
+
+			if (collapses.empty())
+				break;
+
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.Error < b.Error; });
+
+			std::fill(locked.begin(), locked.end(), false);
+			for (uint32_t v = 0; v < vertexCount; v++)
+				remap[v] = v;
+
+			uint32_t trianglesToRemove = (indexCount - targetIndexCount + 2) / 3;
+			uint32_t trianglesRemoved = 0;
+			uint32_t collapseCount = 0;
+			for (const Collapse& collapse : collapses)
+			{
+				if (collapse.Error > errorLimit || trianglesRemoved >= trianglesToRemove)
+					break;
+
+				uint32_t source = collapse.Source;
+				uint32_t targetCanonical = canonical[collapse.Target];
+				if (locked[source] || removed[targetCanonical] || hasTriangleFlips(source, collapse.Target))
+					continue;
+
+				// The source's triangles change, none of their vertices may collapse again this pass
+				for (uint32_t a = adjacencyOffsets[source]; a < adjacencyOffsets[source + 1]; a++)
+				{
+					const uint32_t* triangle = destination + adjacency[a] * 3;
+					bool collapsesAway = false;
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						locked[canonical[triangle[k]]] = true;
+						collapsesAway |= canonical[triangle[k]] == targetCanonical;
+					}
+					trianglesRemoved += collapsesAway;
+				}
+
+				if (kinds[source] == SimplifyVertexKind::Border)
+				{
+					uint32_t previous = borderPrevious[source], next = borderNext[source];
+					borderNext[previous] = next;
+					borderPrevious[next] = previous;
+				}
+
+				quadrics[targetCanonical] += quadrics[source];
+				remap[source] = collapse.Target;
+				removed[source] = true;
+				maxError = glm::max(maxError, collapse.Error);
+				collapseCount++;
+			}
+
+			if (collapseCount == 0)
+				break;
+
+			triangleCount = 0;
+			for (uint32_t i = 0; i < indexCount; i += 3)
+			{
+				uint32_t i0 = remap[destination[i + 0]], i1 = remap[destination[i + 1]], i2 = remap[destination[i + 2]];
+				uint32_t c0 = canonical[i0], c1 = canonical[i1], c2 = canonical[i2];
+				if (c0 == c1 || c1 == c2 || c0 == c2)
+					continue;
+
+				destination[triangleCount * 3 + 0] = i0;
+				destination[triangleCount * 3 + 1] = i1;
+				destination[triangleCount * 3 + 2] = i2;
+				triangleCount++;
+			}
+			indexCount = triangleCount * 3;
+		}
+
+		if (outError)
+			*outError = glm::sqrt(maxError) * extent;
+
+		return indexCount;
+	}
+
+	VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(const uint32_t* indices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize)
+	{
+		VertexCacheStatistics statistics;
+		statistics.TriangleCount = indexCount / 3;
+
+		FIFOCacheSimulation cache(vertexCount, cacheSize);
+		std::vector<bool> referenced(vertexCount, false);
+		for (uint32_t t = 0; t < statistics.TriangleCount; t++)
+		{
+			const uint32_t* triangle = indices + t * 3;
+			statistics.TransformedVertices += cache.Access(triangle);
+
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				if (!referenced[triangle[k]])
+				{
+					referenced[triangle[k]] = true;
+					statistics.VertexCount++;
+				}
+			}
+		}
+
+		return statistics;
+	}
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+namespace Hazel {
+
+	struct Vertex;
+
+	// Post-transform vertex cache behaviour of an index buffer, measured with a FIFO cache simulation
+	struct VertexCacheStatistics
+	{
+		uint32_t TransformedVertices = 0; // Cache misses
+		uint32_t TriangleCount = 0;
+		uint32_t VertexCount = 0;         // Referenced vertices
+
+		float GetACMR() const { return TriangleCount ? (float)TransformedVertices / TriangleCount : 0.0f; } // Average cache miss ratio, 0.5 at best
+		float GetATVR() const { return VertexCount ? (float)TransformedVertices / VertexCount : 0.0f; }     // Average transformed vertex ratio, 1.0 at best
+
+		VertexCacheStatistics& operator+=(const VertexCacheStatistics& other)
+		{
+			TransformedVertices += other.TransformedVertices;
+			TriangleCount += other.TriangleCount;
+			VertexCount += other.VertexCount;
+			return *this;
+		}
+	};
+
+	struct MeshOptimizationStatistics
+	{
+		VertexCacheStatistics Before; // As imported
+		VertexCacheStatistics After;
+	};
+
+	// Import-time reordering of triangles and vertices so the GPU transforms and fetches fewer vertices
+	// and shades fewer hidden pixels. Works on one submesh at a time: indices are relative to its first vertex.
+	class MeshOptimizer
+	{
+	public:
+		static constexpr uint32_t CacheSize = 16;
+
+		// Reorders triangles for the post-transform vertex cache (Tom Forsyth's linear-speed algorithm)
+		static void OptimizeVertexCache(uint32_t* indices, uint32_t indexCount, uint32_t vertexCount);
+
+		// Reorders clusters of the (already cache optimized) triangles so outward facing ones come first, as
+		// long as that costs less than threshold times the cluster's cache misses
+		static void OptimizeOverdraw(uint32_t* indices, uint32_t indexCount, const Vertex* vertices, uint32_t vertexCount, float threshold = 1.05f);
+
+		// Reorders vertices into the order the indices first reference them and remaps the indices.
+		// Unreferenced vertices are moved to the end.
+		static void OptimizeVertexFetch(uint32_t* indices, uint32_t indexCount, Vertex* vertices, uint32_t vertexCount);
+
+		// Quadric error metric simplification: collapses edges onto existing vertices until indexCount reaches
+		// targetIndexCount or the next collapse would move the surface further than targetError (in the vertices'
+		// units). Vertices on texture/normal seams and non-manifold vertices are kept, open borders only collapse
+		// along themselves. Writes the remaining triangles to destination (which may be indices, and needs room
+		// for indexCount entries) and returns their index count. outError receives the largest error introduced.
+		static uint32_t Simplify(uint32_t* destination, const uint32_t* indices, uint32_t indexCount, const Vertex* vertices, uint32_t vertexCount,
+			uint32_t targetIndexCount, float targetError, float* outError = nullptr);
+
+		static VertexCacheStatistics AnalyzeVertexCache(const uint32_t* indices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize = CacheSize);
+	};
+
+}
@@ -1,57 +1,165 @@
 #include "hzpch.h"
 #include "RenderCommandQueue.h"
 
+#include <mutex>
+#include <new>
+
 #define HZ_RENDER_TRACE(...) HZ_CORE_TRACE(__VA_ARGS__)
 
 namespace Hazel {
 
+	struct RenderCommandHeader
+	{
+		RenderCommandQueue::RenderCommandFn Func;
+		uint32_t PayloadOffset; // From the start of the header
+		uint32_t EndOffset;     // From the start of the header to the end of the payload
+	};
+
+	static uint32_t AlignOffset(uint32_t offset, uint32_t alignment)
+	{
+		return (offset + alignment - 1) & ~(alignment - 1);
+	}
+
+	// Chunks of the default size, shared by every queue (including per-thread ones)
+	struct RenderCommandChunkPool
+	{
+		std::mutex Mutex;
+		std::vector<uint8_t*> Chunks;
+
+		~RenderCommandChunkPool()
+		{
+			for (uint8_t* chunk : Chunks)
+				::operator delete(chunk, std::align_val_t(RenderCommandQueue::MaxAlignment));
+		}
+	};
+	static RenderCommandChunkPool s_ChunkPool;
+
 	RenderCommandQueue::RenderCommandQueue()
 	{
-		m_CommandBuffer = new uint8_t[10 * 1024 * 1024]; // 10mb buffer
-		m_CommandBufferPtr = m_CommandBuffer;
-		memset(m_CommandBuffer, 0, 10 * 1024 * 1024);
 	}
 
 	RenderCommandQueue::~RenderCommandQueue()
 	{
-		delete[] m_CommandBuffer;
+		for (Chunk& chunk : m_Chunks)
+			ReleaseChunk(chunk);
+	}
+
+	RenderCommandQueue::Chunk RenderCommandQueue::AcquireChunk(uint32_t minimumSize)
+	{
+		Chunk chunk;
+		if (minimumSize <= ChunkSize)
+		{
+			chunk.Capacity = ChunkSize;
+
+			std::lock_guard<std::mutex> lock(s_ChunkPool.Mutex);
+			if (!s_ChunkPool.Chunks.empty())
+			{
+				chunk.Data = s_ChunkPool.Chunks.back();
+				s_ChunkPool.Chunks.pop_back();
+				return chunk;
+			}
+		}
+		else
+		{
+			chunk.Capacity = AlignOffset(minimumSize, MaxAlignment);
+		}
+
+		chunk.Data = (uint8_t*)::operator new(chunk.Capacity, std::align_val_t(MaxAlignment));
+		return chunk;
+	}
+
+	void RenderCommandQueue::ReleaseChunk(Chunk chunk)
+	{
+		// Oversized chunks are one-offs, only keep the default size around
+		if (chunk.Capacity != ChunkSize)
+		{
+			::operator delete(chunk.Data, std::align_val_t(MaxAlignment));
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(s_ChunkPool.Mutex);
+		s_ChunkPool.Chunks.push_back(chunk.Data);
 	}
 
-	void* RenderCommandQueue::Allocate(RenderCommandFn fn, uint32_t size)
+	void* RenderCommandQueue::Allocate(RenderCommandFn fn, uint32_t size, uint32_t alignment)
 	{
-		// TODO: alignment
-		*(RenderCommandFn*)m_CommandBufferPtr = fn;
-		m_CommandBufferPtr += sizeof(RenderCommandFn);
+		HZ_CORE_ASSERT(alignment <= MaxAlignment && (alignment & (alignment - 1)) == 0, "Unsupported render command alignment!");
 
-		*(uint32_t*)m_CommandBufferPtr = size;
-		m_CommandBufferPtr += sizeof(uint32_t);
+		uint32_t headerOffset = 0, payloadOffset = 0;
+		if (!m_Chunks.empty())
+		{
+			const Chunk& chunk = m_Chunks.back();
+			headerOffset = AlignOffset(chunk.Used, alignof(RenderCommandHeader));
+			payloadOffset = AlignOffset(headerOffset + sizeof(RenderCommandHeader), alignment);
+		}
+
+		if (m_Chunks.empty() || payloadOffset + size > m_Chunks.back().Capacity)
+		{
+			m_Chunks.push_back(AcquireChunk(AlignOffset(sizeof(RenderCommandHeader), alignment) + size));
+			headerOffset = 0;
+			payloadOffset = AlignOffset(sizeof(RenderCommandHeader), alignment);
+		}
 
-		void* memory = m_CommandBufferPtr;
-		m_CommandBufferPtr += size;
+		Chunk& chunk = m_Chunks.back();
+		RenderCommandHeader* header = (RenderCommandHeader*)(chunk.Data + headerOffset);
+		header->Func = fn;
+		header->PayloadOffset = payloadOffset - headerOffset;
+		header->EndOffset = payloadOffset + size - headerOffset;
+		chunk.Used = payloadOffset + size;
 
 		m_CommandCount++;
-		return memory;
+		return chunk.Data + payloadOffset;
 	}
 
-	void RenderCommandQueue::Execute()
+	void RenderCommandQueue::Append(RenderCommandQueue& other)
 	{
-		//HZ_RENDER_TRACE("RenderCommandQueue::Execute -- {0} commands, {1} bytes", m_CommandCount, (m_CommandBufferPtr - m_CommandBuffer));
+		HZ_CORE_ASSERT(&other != this);
+
+		// Whatever is left in this queue's last chunk stays unused, so the order of commands is preserved
+		for (Chunk& chunk : other.m_Chunks)
+			m_Chunks.push_back(chunk);
+
+		m_CommandCount += other.m_CommandCount;
+		other.m_Chunks.clear();
+		other.m_CommandCount = 0;
+	}
 
-		byte* buffer = m_CommandBuffer;
+	void RenderCommandQueue::Execute()
+	{
+		//HZ_RENDER_TRACE("RenderCommandQueue::Execute -- {0} commands, {1} chunks", m_CommandCount, m_Chunks.size());
 
-		for (uint32_t i = 0; i < m_CommandCount; i++)
+		// Indices only: commands may append to the queue and reallocate m_Chunks while it executes
+		for (size_t i = 0; i < m_Chunks.size(); i++)
 		{
-			RenderCommandFn function = *(RenderCommandFn*)buffer;
-			buffer += sizeof(RenderCommandFn);
+			uint32_t offset = 0;
+			while (offset < m_Chunks[i].Used)
+			{
+				RenderCommandHeader* header = (RenderCommandHeader*)(m_Chunks[i].Data + offset);
+				uint32_t endOffset = header->EndOffset;
+				header->Func((uint8_t*)header + header->PayloadOffset);
+				offset = AlignOffset(offset + endOffset, alignof(RenderCommandHeader));
+			}
+		}
 
-			uint32_t size = *(uint32_t*)buffer;
-			buffer += sizeof(uint32_t);
-			function(buffer);
-			buffer += size;
+		// Keep one chunk for the next frame, the rest go back to the pool for any queue to use
+		for (size_t i = 1; i < m_Chunks.size(); i++)
+			ReleaseChunk(m_Chunks[i]);
+
+		if (!m_Chunks.empty())
+		{
+			if (m_Chunks[0].Capacity == ChunkSize)
+			{
+				m_Chunks.resize(1);
+				m_Chunks[0].Used = 0;
+			}
+			else
+			{
+				ReleaseChunk(m_Chunks[0]);
+				m_Chunks.clear();
+			}
 		}
 
-		m_CommandBufferPtr = m_CommandBuffer;
 		m_CommandCount = 0;
 	}
 
-}
\ No newline at end of file
+}
@@ -4,23 +4,45 @@
 
 namespace Hazel {
 
+	// Linear command arena made of fixed size chunks. Chunks are taken from a shared pool as the queue
+	// grows and handed back once the queue has been executed, so memory is reused between frames.
 	class RenderCommandQueue
 	{
 	public:
 		typedef void(*RenderCommandFn)(void*);
 
+		static constexpr uint32_t ChunkSize = 1024 * 1024;
+		static constexpr uint32_t MaxAlignment = 64;
+
 		RenderCommandQueue();
 		~RenderCommandQueue();
 
-		void* Allocate(RenderCommandFn func, uint32_t size);
+		RenderCommandQueue(const RenderCommandQueue&) = delete;
+		RenderCommandQueue& operator=(const RenderCommandQueue&) = delete;
+
+		void* Allocate(RenderCommandFn func, uint32_t size, uint32_t alignment = alignof(std::max_align_t));
 
+		// Moves every command of other to the end of this queue, leaving other empty
+		void Append(RenderCommandQueue& other);
+
+		// Commands may submit more commands to this queue while it executes, they run in the same pass
 		void Execute();
+
+		uint32_t GetCommandCount() const { return m_CommandCount; }
+		bool IsEmpty() const { return m_CommandCount == 0; }
 	private:
-		uint8_t* m_CommandBuffer;
-		uint8_t* m_CommandBufferPtr;
+		struct Chunk
+		{
+			uint8_t* Data = nullptr;
+			uint32_t Capacity = 0;
+			uint32_t Used = 0;
+		};
+
+		static Chunk AcquireChunk(uint32_t minimumSize);
+		static void ReleaseChunk(Chunk chunk);
+	private:
+		std::vector<Chunk> m_Chunks; // In execution order, the last one is being recorded into
 		uint32_t m_CommandCount = 0;
 	};
 
-
-
-}
\ No newline at end of file
+}
@@ -0,0 +1,142 @@
+#include "hzpch.h"
+#include "RenderThread.h"
+
+#include "Renderer.h"
+
+#include "Hazel/Core/Timer.h"
+
+namespace Hazel {
+
+	RenderThread::RenderThread(ThreadingPolicy policy, uint32_t frameLatency)
+		: m_Policy(policy), m_FrameLatency(frameLatency)
+	{
+		// Kept as a raw pointer so the render thread never touches the context's refcount, the window owns it
+		m_Context = Renderer::GetContext().Raw();
+
+		// The main thread records into one queue while up to frameLatency others wait for or are being executed
+		uint32_t queueCount = policy == ThreadingPolicy::MultiThreaded ? frameLatency + 1 : 1;
+		for (uint32_t i = 0; i < queueCount; i++)
+			m_Queues.push_back(std::make_unique<RenderCommandQueue>());
+		m_Present.resize(queueCount, false);
+	}
+
+	RenderThread::~RenderThread()
+	{
+		Terminate();
+	}
+
+	void RenderThread::Run()
+	{
+		if (m_Policy != ThreadingPolicy::MultiThreaded || IsRunning())
+			return;
+
+		m_Running = true;
+		m_Thread = std::thread(&RenderThread::ThreadLoop, this);
+		HZ_CORE_INFO("Render thread started ({0} frame latency)", m_FrameLatency);
+	}
+
+	void RenderThread::Terminate()
+	{
+		if (!IsRunning())
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Running = false;
+		}
+		m_Condition.notify_all();
+		m_Thread.join();
+	}
+
+	void RenderThread::Kick(bool present)
+	{
+		uint32_t queueIndex = m_SubmitQueueIndex;
+		m_SubmitQueueIndex = (m_SubmitQueueIndex + 1) % (uint32_t)m_Queues.size();
+
+		if (!IsRunning())
+		{
+			ExecuteQueue(queueIndex, present);
+			return;
+		}
+
+		Timer timer;
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Present[queueIndex] = present;
+			m_KickedCount++;
+			m_Condition.notify_all();
+
+			// The next submit queue was last kicked frameLatency + 1 queues ago, wait until it has been executed
+			m_Condition.wait(lock, [this]() { return m_ExecutedCount + m_FrameLatency >= m_KickedCount; });
+		}
+		m_WaitMillis = timer.ElapsedMillis();
+	}
+
+	void RenderThread::BlockUntilRenderComplete()
+	{
+		if (!IsRunning())
+			return;
+
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Condition.wait(lock, [this]() { return m_ExecutedCount == m_KickedCount; });
+	}
+
+	bool RenderThread::IsRenderThread() const
+	{
+		if (!IsRunning())
+			return true;
+
+		return std::this_thread::get_id() == m_Thread.get_id();
+	}
+
+	void RenderThread::ThreadLoop()
+	{
+		while (true)
+		{
+			uint32_t queueIndex;
+			bool present;
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_Condition.wait(lock, [this]() { return m_ExecutedCount < m_KickedCount || !m_Running; });
+
+				// Anything kicked before Terminate is still executed
+				if (m_ExecutedCount == m_KickedCount)
+					break;
+
+				queueIndex = (uint32_t)(m_ExecutedCount % m_Queues.size());
+				present = m_Present[queueIndex];
+			}
+
+			ExecuteQueue(queueIndex, present);
+
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_ExecutedCount++;
+			}
+			m_Condition.notify_all();
+		}
+	}
+
+	void RenderThread::ExecuteQueue(uint32_t queueIndex, bool present)
+	{
+		// Commands that submit more commands append them to the queue being executed,
+		// not to the one the main thread is recording into
+		RenderCommandQueue* previousQueue = Renderer::GetThreadCommandQueue();
+		Renderer::SetThreadCommandQueue(m_Queues[queueIndex].get());
+
+		Timer timer;
+		if (present)
+			m_Context->BeginFrame();
+
+		m_Queues[queueIndex]->Execute();
+
+		if (present)
+		{
+			m_Context->SwapBuffers();
+			m_ExecuteMillis = timer.ElapsedMillis();
+		}
+
+		Renderer::SetThreadCommandQueue(previousQueue);
+	}
+
+}
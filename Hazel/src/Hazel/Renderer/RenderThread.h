@@ -0,0 +1,77 @@
+#pragma once
+
+#include "RenderCommandQueue.h"
+#include "RendererContext.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace Hazel {
+
+	enum class ThreadingPolicy
+	{
+		// Render commands are executed on the main thread at the end of every frame
+		SingleThreaded = 0,
+		// A render thread executes frame N's commands while the main thread records frame N + 1
+		MultiThreaded
+	};
+
+	// Owns one render command queue per frame that can be in flight. The main thread records into the
+	// submit queue and kicks it at the end of the frame; the render thread executes kicked queues in order.
+	class RenderThread
+	{
+	public:
+		// frameLatency is how many kicked frames the main thread may run ahead of the render thread
+		RenderThread(ThreadingPolicy policy, uint32_t frameLatency = 1);
+		~RenderThread();
+
+		void Run();
+		void Terminate();
+
+		RenderCommandQueue& GetSubmitQueue() { return *m_Queues[m_SubmitQueueIndex]; }
+		uint32_t GetSubmitQueueIndex() const { return m_SubmitQueueIndex; }
+		uint32_t GetQueueCount() const { return (uint32_t)m_Queues.size(); }
+
+		// Hands the commands recorded so far over to the render thread, optionally wrapped in the render
+		// context's BeginFrame / SwapBuffers. Returns once the next submit queue is free to record into.
+		void Kick(bool present);
+
+		// Blocks until every kicked queue has been executed
+		void BlockUntilRenderComplete();
+
+		bool IsRunning() const { return m_Thread.joinable(); }
+		bool IsRenderThread() const;
+		ThreadingPolicy GetPolicy() const { return m_Policy; }
+		uint32_t GetFrameLatency() const { return m_FrameLatency; }
+
+		// Time the main thread spent waiting in Kick, and the render thread spent executing the last presented frame
+		float GetWaitMillis() const { return m_WaitMillis; }
+		float GetExecuteMillis() const { return m_ExecuteMillis; }
+	private:
+		void ThreadLoop();
+		void ExecuteQueue(uint32_t queueIndex, bool present);
+	private:
+		ThreadingPolicy m_Policy;
+		uint32_t m_FrameLatency;
+		RendererContext* m_Context = nullptr;
+
+		std::vector<std::unique_ptr<RenderCommandQueue>> m_Queues;
+		std::vector<bool> m_Present;
+		uint32_t m_SubmitQueueIndex = 0;
+
+		std::thread m_Thread;
+		std::mutex m_Mutex;
+		std::condition_variable m_Condition;
+		bool m_Running = false;
+
+		// Frame fences. Queues are kicked and executed in order, so kicked queue N always lives at index N % queue count.
+		uint64_t m_KickedCount = 0;
+		uint64_t m_ExecutedCount = 0;
+
+		std::atomic<float> m_WaitMillis = 0.0f;
+		std::atomic<float> m_ExecuteMillis = 0.0f;
+	};
+
+}
@@ -5,6 +5,8 @@
 
 #include <glad/glad.h>
 
+#include <mutex>
+
 #include "RendererAPI.h"
 #include "SceneRenderer.h"
 #include "Renderer2D.h"
@@ -23,32 +25,47 @@ namespace Hazel {
 		std::vector<Ref<Pipeline>> Pipelines;
 		std::vector<Ref<Material>> Materials;
 	};
-	static std::unordered_map<size_t, ShaderDependencies> s_ShaderDependencies;
+
+	// Materials are also created by asset loads on worker threads
+	static struct
+	{
+		std::unordered_map<size_t, ShaderDependencies> Map;
+		std::mutex Mutex;
+	} s_ShaderDependencies;
 
 	void Renderer::RegisterShaderDependency(Ref<Shader> shader, Ref<Pipeline> pipeline)
 	{
-		s_ShaderDependencies[shader->GetHash()].Pipelines.push_back(pipeline);
+		std::lock_guard<std::mutex> lock(s_ShaderDependencies.Mutex);
+		s_ShaderDependencies.Map[shader->GetHash()].Pipelines.push_back(pipeline);
 	}
 	
 	void Renderer::RegisterShaderDependency(Ref<Shader> shader, Ref<Material> material)
 	{
-		s_ShaderDependencies[shader->GetHash()].Materials.push_back(material);
+		std::lock_guard<std::mutex> lock(s_ShaderDependencies.Mutex);
+		s_ShaderDependencies.Map[shader->GetHash()].Materials.push_back(material);
 	}
 
 	void Renderer::OnShaderReloaded(size_t hash)
 	{
-		if (s_ShaderDependencies.find(hash) != s_ShaderDependencies.end())
+		// Invalidated outside the lock, invalidation may create pipelines that register themselves
+		ShaderDependencies dependencies;
 		{
-			auto& dependencies = s_ShaderDependencies.at(hash);
-			for (auto& pipeline : dependencies.Pipelines)
-			{
-				pipeline->Invalidate();
-			}
-
-			for (auto& material : dependencies.Materials)
-			{
-				material->Invalidate();
-			}
+			std::lock_guard<std::mutex> lock(s_ShaderDependencies.Mutex);
+			auto it = s_ShaderDependencies.Map.find(hash);
+			if (it == s_ShaderDependencies.Map.end())
+				return;
+
+			dependencies = it->second;
+		}
+
+		for (auto& pipeline : dependencies.Pipelines)
+		{
+			pipeline->Invalidate();
+		}
+
+		for (auto& material : dependencies.Materials)
+		{
+			material->Invalidate();
 		}
 	}
 
@@ -70,7 +87,8 @@ namespace Hazel {
 	};
 
 	static RendererData* s_Data = nullptr;
-	static RenderCommandQueue* s_CommandQueue = nullptr;
+	static RenderThread* s_RenderThread = nullptr;
+	static thread_local RenderCommandQueue* s_ThreadCommandQueue = nullptr;
 
 	static RendererAPI* InitRendererAPI()
 	{
@@ -83,10 +101,19 @@ namespace Hazel {
 		return nullptr;
 	}
 	
-	void Renderer::Init()
+	void Renderer::Init(const RendererConfig& config)
 	{
 		s_Data = new RendererData();
-		s_CommandQueue = new RenderCommandQueue();
+		s_Data->Config = config;
+
+		// The OpenGL context and ImGui's OpenGL backend are tied to the main thread
+		if (RendererAPI::Current() == RendererAPIType::OpenGL && config.Threading == ThreadingPolicy::MultiThreaded)
+		{
+			HZ_CORE_WARN("The render thread is not supported with OpenGL, falling back to single threaded rendering");
+			s_Data->Config.Threading = ThreadingPolicy::SingleThreaded;
+		}
+
+		s_RenderThread = new RenderThread(s_Data->Config.Threading, s_Data->Config.FrameLatency);
 		s_RendererAPI = InitRendererAPI();
 
 		s_Data->m_ShaderLibrary = Ref<ShaderLibrary>::Create();
@@ -100,10 +127,12 @@ namespace Hazel {
 		Renderer::GetShaderLibrary()->Load("assets/shaders/Grid.glsl");
 		Renderer::GetShaderLibrary()->Load("assets/shaders/SceneComposite.glsl");
 		Renderer::GetShaderLibrary()->Load("assets/shaders/HazelPBR_Static.glsl");
+		Renderer::GetShaderLibrary()->Load("assets/shaders/HazelPBR_Static_Compact.glsl");
 		//Renderer::GetShaderLibrary()->Load("assets/shaders/HazelPBR_Anim.glsl");
 		//Renderer::GetShaderLibrary()->Load("assets/shaders/Outline.glsl");
 		Renderer::GetShaderLibrary()->Load("assets/shaders/Skybox.glsl");
 		Renderer::GetShaderLibrary()->Load("assets/shaders/ShadowMap.glsl");
+		Renderer::GetShaderLibrary()->Load("assets/shaders/ShadowMap_Compact.glsl");
 
 		// Compile shaders
 		Renderer::WaitAndRender();
@@ -122,12 +151,19 @@ namespace Hazel {
 
 	void Renderer::Shutdown()
 	{
-		s_ShaderDependencies.clear();
+		{
+			std::lock_guard<std::mutex> lock(s_ShaderDependencies.Mutex);
+			s_ShaderDependencies.Map.clear();
+		}
 		SceneRenderer::Shutdown();
 		s_RendererAPI->Shutdown();
 
+		// Anything released during shutdown may still submit commands
+		WaitAndRender();
+		s_RenderThread->Terminate();
+
 		delete s_Data;
-		delete s_CommandQueue;
+		delete s_RenderThread;
 	}
 
 	RendererCapabilities& Renderer::GetCapabilities()
@@ -142,7 +178,33 @@ namespace Hazel {
 
 	void Renderer::WaitAndRender()
 	{
-		s_CommandQueue->Execute();
+		s_RenderThread->Kick(false);
+		s_RenderThread->BlockUntilRenderComplete();
+	}
+
+	void Renderer::StartRenderThread()
+	{
+		s_RenderThread->Run();
+	}
+
+	RenderThread& Renderer::GetRenderThread()
+	{
+		return *s_RenderThread;
+	}
+
+	void Renderer::SetThreadCommandQueue(RenderCommandQueue* queue)
+	{
+		s_ThreadCommandQueue = queue;
+	}
+
+	RenderCommandQueue* Renderer::GetThreadCommandQueue()
+	{
+		return s_ThreadCommandQueue;
+	}
+
+	void Renderer::SubmitCommandQueue(RenderCommandQueue& queue)
+	{
+		s_RenderThread->GetSubmitQueue().Append(queue);
 	}
 
 	void Renderer::BeginRenderPass(Ref<RenderPass> renderPass, bool clear)
@@ -182,14 +244,14 @@ namespace Hazel {
 		return s_RendererAPI->CreatePreethamSky(turbidity, azimuth, inclination);
 	}
 
-	void Renderer::RenderMesh(Ref<Pipeline> pipeline, Ref<Mesh> mesh, const glm::mat4& transform)
+	void Renderer::RenderMesh(Ref<Pipeline> pipeline, Ref<Mesh> mesh, const glm::mat4& transform, const uint8_t* submeshLODs)
 	{
-		s_RendererAPI->RenderMesh(pipeline, mesh, transform);
+		s_RendererAPI->RenderMesh(pipeline, mesh, transform, submeshLODs);
 	}
 
-	void Renderer::RenderMeshWithoutMaterial(Ref<Pipeline> pipeline, Ref<Mesh> mesh, const glm::mat4& transform)
+	void Renderer::RenderMeshWithoutMaterial(Ref<Pipeline> pipeline, Ref<Mesh> mesh, const glm::mat4& transform, const uint8_t* submeshLODs)
 	{
-		s_RendererAPI->RenderMeshWithoutMaterial(pipeline, mesh, transform);
+		s_RendererAPI->RenderMeshWithoutMaterial(pipeline, mesh, transform, submeshLODs);
 	}
 
 	void Renderer::RenderQuad(Ref<Pipeline> pipeline, Ref<Material> material, const glm::mat4& transform)
@@ -310,7 +372,10 @@ namespace Hazel {
 
 	RenderCommandQueue& Renderer::GetRenderCommandQueue()
 	{
-		return *s_CommandQueue;
+		if (s_ThreadCommandQueue)
+			return *s_ThreadCommandQueue;
+
+		return s_RenderThread->GetSubmitQueue();
 	}
 
 	RendererConfig& Renderer::GetConfig()
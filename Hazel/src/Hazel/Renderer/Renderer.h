@@ -2,6 +2,7 @@
 
 #include "RendererContext.h"
 #include "RenderCommandQueue.h"
+#include "RenderThread.h"
 #include "RenderPass.h"
 #include "Mesh.h"
 
@@ -23,6 +24,10 @@ namespace Hazel {
 		// Tiering settings
 		uint32_t EnvironmentMapResolution = 1024;
 		uint32_t IrradianceMapComputeSamples = 512;
+
+		// Threading settings (OpenGL is always single threaded)
+		ThreadingPolicy Threading = ThreadingPolicy::SingleThreaded;
+		uint32_t FrameLatency = 1;
 	};
 
 	class Renderer
@@ -35,7 +40,7 @@ namespace Hazel {
 			return Application::Get().GetWindow().GetRenderContext();
 		}
 
-		static void Init();
+		static void Init(const RendererConfig& config = RendererConfig());
 		static void Shutdown();
 
 		static RendererCapabilities& GetCapabilities();
@@ -54,7 +59,7 @@ namespace Hazel {
 				// static_assert(std::is_trivially_destructible_v<FuncT>, "FuncT must be trivially destructible");
 				pFunc->~FuncT();
 			};
-			auto storageBuffer = GetRenderCommandQueue().Allocate(renderCmd, sizeof(func));
+			auto storageBuffer = GetRenderCommandQueue().Allocate(renderCmd, sizeof(func), alignof(FuncT));
 			new (storageBuffer) FuncT(std::forward<FuncT>(func));
 		}
 
@@ -63,8 +68,21 @@ namespace Hazel {
 			return s_Instance->m_CommandQueue.Allocate(fn, size);
 		}*/
 
+		// Executes everything submitted so far and waits for it to finish
 		static void WaitAndRender();
 
+		// Starts the render thread if the config asks for one. Until then, queues are executed on the main thread.
+		static void StartRenderThread();
+		static RenderThread& GetRenderThread();
+
+		// Makes Submit on the calling thread record into queue instead of the frame's queue (nullptr to reset),
+		// so jobs can record render commands in parallel. The queues are then merged with SubmitCommandQueue.
+		static void SetThreadCommandQueue(RenderCommandQueue* queue);
+		static RenderCommandQueue* GetThreadCommandQueue();
+
+		// Appends every command recorded into queue to the frame. Call it in a fixed order for deterministic results.
+		static void SubmitCommandQueue(RenderCommandQueue& queue);
+
 		// ~Actual~ Renderer here... TODO: remove confusion later
 		static void BeginRenderPass(Ref<RenderPass> renderPass, bool clear = true);
 		static void EndRenderPass();
@@ -76,8 +94,9 @@ namespace Hazel {
 		static std::pair<Ref<TextureCube>, Ref<TextureCube>> CreateEnvironmentMap(const std::string& filepath);
 		static Ref<TextureCube> CreatePreethamSky(float turbidity, float azimuth, float inclination);
 
-		static void RenderMesh(Ref<Pipeline> pipeline, Ref<Mesh> mesh, const glm::mat4& transform);
-		static void RenderMeshWithoutMaterial(Ref<Pipeline> pipeline, Ref<Mesh> mesh, const glm::mat4& transform);
+		// submeshLODs holds the LOD to draw for each submesh, null draws them all at full detail
+		static void RenderMesh(Ref<Pipeline> pipeline, Ref<Mesh> mesh, const glm::mat4& transform, const uint8_t* submeshLODs = nullptr);
+		static void RenderMeshWithoutMaterial(Ref<Pipeline> pipeline, Ref<Mesh> mesh, const glm::mat4& transform, const uint8_t* submeshLODs = nullptr);
 		static void RenderQuad(Ref<Pipeline> pipeline, Ref<Material> material, const glm::mat4& transform);
 		static void SubmitFullscreenQuad(Ref<Pipeline> pipeline, Ref<Material> material);
 
@@ -13,6 +13,21 @@ namespace Hazel {
 		Environment() = default;
 		Environment(const Ref<TextureCube>& radianceMap, const Ref<TextureCube>& irradianceMap)
 			: RadianceMap(radianceMap), IrradianceMap(irradianceMap) {}
+
+		virtual AssetMemoryUsage GetMemoryUsage() const override
+		{
+			AssetMemoryUsage usage;
+			for (const Ref<TextureCube>& map : { RadianceMap, IrradianceMap })
+			{
+				if (!map)
+					continue;
+
+				AssetMemoryUsage mapUsage = map->GetMemoryUsage();
+				usage.CPUBytes += mapUsage.CPUBytes;
+				usage.GPUBytes += mapUsage.GPUBytes;
+			}
+			return usage;
+		}
 	};
 
 
@@ -10,6 +10,9 @@
 
 #include "Renderer2D.h"
 
+#include "Hazel/Core/FrameAllocator.h"
+#include "Hazel/Core/Timer.h"
+
 #include "Hazel/Platform/Vulkan/VulkanRenderer.h"
 #include "Hazel/Platform/Vulkan/VulkanFramebuffer.h"
 #include "Hazel/Platform/Vulkan/VulkanShader.h"
@@ -33,6 +36,11 @@ namespace Hazel {
 			float SceneEnvironmentIntensity;
 			LightEnvironment SceneLightEnvironment;
 			Light ActiveLight;
+
+			// LOD selection
+			glm::vec3 CameraPosition;
+			float PixelsPerUnit; // At a distance of 1 for perspective cameras
+			bool OrthographicCamera;
 		} SceneData;
 
 		Ref<Texture2D> BRDFLUT;
@@ -75,16 +83,22 @@ namespace Hazel {
 		Ref<Pipeline> SkyboxPipeline;
 		Ref<Material> SkyboxMaterial;
 
+		// Per MeshVertexFormat, the Standard entries are GeometryPipeline and ShadowPassPipeline
+		std::array<Ref<Pipeline>, (size_t)MeshVertexFormat::Count> GeometryPipelines;
+		std::array<Ref<Pipeline>, (size_t)MeshVertexFormat::Count> ShadowPassPipelines;
+
+		// Only lives for the frame it was submitted in, the scene keeps the mesh and material alive until then
 		struct DrawCommand
 		{
-			Ref<Mesh> Mesh;
-			Ref<Material> Material;
+			Mesh* Mesh;
+			Material* Material;
 			glm::mat4 Transform;
+			const uint8_t* SubmeshLODs; // Per submesh, null draws full detail
 		};
-		std::vector<DrawCommand> DrawList;
-		std::vector<DrawCommand> SelectedMeshDrawList;
-		std::vector<DrawCommand> ColliderDrawList;
-		std::vector<DrawCommand> ShadowPassDrawList;
+		FrameVector<DrawCommand> DrawList;
+		FrameVector<DrawCommand> SelectedMeshDrawList;
+		FrameVector<DrawCommand> ColliderDrawList;
+		FrameVector<DrawCommand> ShadowPassDrawList;
 
 		// Grid
 		Ref<Pipeline> GridPipeline;
@@ -94,6 +108,9 @@ namespace Hazel {
 		Ref<Material> ColliderMaterial;
 
 		SceneRendererOptions Options;
+		SceneRendererStatistics Statistics, LastStatistics;
+		Timer SubmissionTimer;
+		float AverageSubmissionTime = 0.0f; // Smoothed over roughly the last hundred frames
 
 		uint32_t ViewportWidth = 0, ViewportHeight = 0;
 		bool NeedsResize = false;
@@ -179,15 +196,19 @@ namespace Hazel {
 			PipelineSpecification pipelineSpec;
 			pipelineSpec.DebugName = "ShadowPass";
 			pipelineSpec.Shader = shadowPassShader;
-			pipelineSpec.Layout = {
-				{ ShaderDataType::Float3, "a_Position" },
-				{ ShaderDataType::Float3, "a_Normal" },
-				{ ShaderDataType::Float3, "a_Tangent" },
-				{ ShaderDataType::Float3, "a_Binormal" },
-				{ ShaderDataType::Float2, "a_TexCoord" }
-			};
+			pipelineSpec.Layout = Mesh::GetStaticVertexLayout(MeshVertexFormat::Standard);
 			pipelineSpec.RenderPass = s_Data->ShadowMapRenderPass[0];
 			s_Data->ShadowPassPipeline = Pipeline::Create(pipelineSpec);
+			s_Data->ShadowPassPipelines[(size_t)MeshVertexFormat::Standard] = s_Data->ShadowPassPipeline;
+
+			// The compact formats only differ in how positions are stored, they share a shader
+			pipelineSpec.Shader = Renderer::GetShaderLibrary()->Get("ShadowMap_Compact");
+			for (MeshVertexFormat format : { MeshVertexFormat::Compact, MeshVertexFormat::CompactQuantized })
+			{
+				pipelineSpec.DebugName = format == MeshVertexFormat::Compact ? "ShadowPass-Compact" : "ShadowPass-Quantized";
+				pipelineSpec.Layout = Mesh::GetStaticVertexLayout(format);
+				s_Data->ShadowPassPipelines[(size_t)format] = Pipeline::Create(pipelineSpec);
+			}
 		}
 		
 		// Geometry
@@ -202,13 +223,7 @@ namespace Hazel {
 			Ref<Framebuffer> framebuffer = Framebuffer::Create(geoFramebufferSpec);
 
 			PipelineSpecification pipelineSpecification;
-			pipelineSpecification.Layout = {
-				{ ShaderDataType::Float3, "a_Position" },
-				{ ShaderDataType::Float3, "a_Normal" },
-				{ ShaderDataType::Float3, "a_Tangent" },
-				{ ShaderDataType::Float3, "a_Binormal" },
-				{ ShaderDataType::Float2, "a_TexCoord" },
-			};
+			pipelineSpecification.Layout = Mesh::GetStaticVertexLayout(MeshVertexFormat::Standard);
 			pipelineSpecification.Shader = Renderer::GetShaderLibrary()->Get("HazelPBR_Static");
 
 			RenderPassSpecification renderPassSpec;
@@ -217,6 +232,15 @@ namespace Hazel {
 			pipelineSpecification.RenderPass = RenderPass::Create(renderPassSpec);
 			pipelineSpecification.DebugName = "PBR-Static";
 			s_Data->GeometryPipeline = Pipeline::Create(pipelineSpecification);
+			s_Data->GeometryPipelines[(size_t)MeshVertexFormat::Standard] = s_Data->GeometryPipeline;
+
+			pipelineSpecification.Shader = Renderer::GetShaderLibrary()->Get("HazelPBR_Static_Compact");
+			for (MeshVertexFormat format : { MeshVertexFormat::Compact, MeshVertexFormat::CompactQuantized })
+			{
+				pipelineSpecification.DebugName = format == MeshVertexFormat::Compact ? "PBR-Static-Compact" : "PBR-Static-Quantized";
+				pipelineSpecification.Layout = Mesh::GetStaticVertexLayout(format);
+				s_Data->GeometryPipelines[(size_t)format] = Pipeline::Create(pipelineSpecification);
+			}
 		}
 
 		// Composite
@@ -468,6 +492,7 @@ namespace Hazel {
 		HZ_CORE_ASSERT(!s_Data->ActiveScene, "");
 
 		s_Data->ActiveScene = scene;
+		s_Data->SubmissionTimer.Reset();
 
 		s_Data->SceneData.SceneCamera = camera;
 		s_Data->SceneData.SceneEnvironment = scene->m_Environment;
@@ -477,6 +502,11 @@ namespace Hazel {
 		s_Data->SceneData.SkyboxLod = scene->m_SkyboxLod;
 		s_Data->SceneData.ActiveLight = scene->m_Light;
 
+		const glm::mat4& projection = camera.Camera.GetProjectionMatrix();
+		s_Data->SceneData.CameraPosition = glm::inverse(camera.ViewMatrix)[3];
+		s_Data->SceneData.PixelsPerUnit = projection[1][1] * 0.5f * (float)s_Data->ViewportHeight;
+		s_Data->SceneData.OrthographicCamera = projection[3][3] == 1.0f;
+
 		if (s_Data->NeedsResize)
 		{
 			s_Data->GeometryPipeline->GetSpecification().RenderPass->GetSpecification().TargetFramebuffer->Resize(s_Data->ViewportWidth, s_Data->ViewportHeight);
@@ -488,7 +518,7 @@ namespace Hazel {
 
 		auto& sceneCamera = s_Data->SceneData.SceneCamera;
 		auto viewProjection = sceneCamera.Camera.GetProjectionMatrix() * s_Data->SceneData.SceneCamera.ViewMatrix;
-		glm::vec3 cameraPosition = glm::inverse(sceneCamera.ViewMatrix)[3];
+		glm::vec3 cameraPosition = s_Data->SceneData.CameraPosition;
 
 		// TODO: handle uniform buffers better
 		const DirectionalLight& directionalLight = s_Data->SceneData.SceneLightEnvironment.DirectionalLights[0];
@@ -617,38 +647,99 @@ namespace Hazel {
 		FlushDrawList();
 	}
 
+	const uint8_t* SceneRenderer::SelectLODs(MeshComponent& meshComponent, const glm::mat4& transform)
+	{
+		const std::vector<Submesh>& submeshes = meshComponent.Mesh->GetSubmeshes();
+		std::vector<uint8_t>& previousLODs = meshComponent.SubmeshLODs;
+		if (previousLODs.size() != submeshes.size())
+			previousLODs.assign(submeshes.size(), 0);
+
+		const SceneRendererOptions& options = s_Data->Options;
+		const auto& sceneData = s_Data->SceneData;
+
+		uint8_t* lods = FrameAllocator::AllocateArray<uint8_t>(submeshes.size());
+		for (size_t i = 0; i < submeshes.size(); i++)
+		{
+			const Submesh& submesh = submeshes[i];
+			uint32_t lodCount = options.EnableLOD ? submesh.GetLODCount() : 1;
+			uint32_t lod = glm::min<uint32_t>(previousLODs[i], lodCount - 1);
+			if (lodCount > 1)
+			{
+				glm::mat4 submeshTransform = transform * submesh.Transform;
+				glm::vec3 center = submeshTransform * glm::vec4((submesh.BoundingBox.Min + submesh.BoundingBox.Max) * 0.5f, 1.0f);
+				float scale = glm::max(glm::length(glm::vec3(submeshTransform[0])), glm::max(glm::length(glm::vec3(submeshTransform[1])), glm::length(glm::vec3(submeshTransform[2]))));
+				float radius = glm::length(submesh.BoundingBox.Max - submesh.BoundingBox.Min) * 0.5f * scale;
+				float distance = sceneData.OrthographicCamera ? 1.0f : glm::distance(center, sceneData.CameraPosition);
+
+				if (!sceneData.OrthographicCamera && distance <= radius)
+				{
+					lod = 0;
+				}
+				else
+				{
+					// LOD errors are in the submesh's units, on screen they shrink with its projected size
+					float pixelsPerUnit = sceneData.PixelsPerUnit * scale / distance;
+					auto getScreenError = [&](uint32_t level) { return submesh.GetLOD(level).Error * pixelsPerUnit; };
+
+					while (lod > 0 && getScreenError(lod) > options.LODErrorThreshold)
+						lod--;
+					while (lod + 1 < lodCount && getScreenError(lod + 1) <= options.LODErrorThreshold * (1.0f - options.LODHysteresis))
+						lod++;
+				}
+			}
+
+			lods[i] = previousLODs[i] = (uint8_t)lod;
+		}
+
+		return lods;
+	}
+
+	void SceneRenderer::SubmitMesh(MeshComponent& meshComponent, const glm::mat4& transform, Ref<Material> overrideMaterial)
+	{
+		const uint8_t* lods = SelectLODs(meshComponent, transform);
+		s_Data->DrawList.push_back({ meshComponent.Mesh.Raw(), overrideMaterial.Raw(), transform, lods });
+		s_Data->ShadowPassDrawList.push_back({ meshComponent.Mesh.Raw(), overrideMaterial.Raw(), transform, lods });
+	}
+
 	void SceneRenderer::SubmitMesh(Ref<Mesh> mesh, const glm::mat4& transform, Ref<Material> overrideMaterial)
 	{
 		// TODO: Culling, sorting, etc.
-		s_Data->DrawList.push_back({ mesh, overrideMaterial, transform });
-		s_Data->ShadowPassDrawList.push_back({ mesh, overrideMaterial, transform });
+		s_Data->DrawList.push_back({ mesh.Raw(), overrideMaterial.Raw(), transform });
+		s_Data->ShadowPassDrawList.push_back({ mesh.Raw(), overrideMaterial.Raw(), transform });
+	}
+
+	void SceneRenderer::SubmitSelectedMesh(MeshComponent& meshComponent, const glm::mat4& transform)
+	{
+		const uint8_t* lods = SelectLODs(meshComponent, transform);
+		s_Data->SelectedMeshDrawList.push_back({ meshComponent.Mesh.Raw(), nullptr, transform, lods });
+		s_Data->ShadowPassDrawList.push_back({ meshComponent.Mesh.Raw(), nullptr, transform, lods });
 	}
 
 	void SceneRenderer::SubmitSelectedMesh(Ref<Mesh> mesh, const glm::mat4& transform)
 	{
-		s_Data->SelectedMeshDrawList.push_back({ mesh, nullptr, transform });
-		s_Data->ShadowPassDrawList.push_back({ mesh, nullptr, transform });
+		s_Data->SelectedMeshDrawList.push_back({ mesh.Raw(), nullptr, transform });
+		s_Data->ShadowPassDrawList.push_back({ mesh.Raw(), nullptr, transform });
 	}
 
 	void SceneRenderer::SubmitColliderMesh(const BoxColliderComponent& component, const glm::mat4& parentTransform)
 	{
-		s_Data->ColliderDrawList.push_back({ component.DebugMesh, nullptr, glm::translate(parentTransform, component.Offset) });
+		s_Data->ColliderDrawList.push_back({ component.DebugMesh.Raw(), nullptr, glm::translate(parentTransform, component.Offset) });
 	}
 
 	void SceneRenderer::SubmitColliderMesh(const SphereColliderComponent& component, const glm::mat4& parentTransform)
 	{
-		s_Data->ColliderDrawList.push_back({ component.DebugMesh, nullptr, parentTransform });
+		s_Data->ColliderDrawList.push_back({ component.DebugMesh.Raw(), nullptr, parentTransform });
 	}
 
 	void SceneRenderer::SubmitColliderMesh(const CapsuleColliderComponent& component, const glm::mat4& parentTransform)
 	{
-		s_Data->ColliderDrawList.push_back({ component.DebugMesh, nullptr, parentTransform });
+		s_Data->ColliderDrawList.push_back({ component.DebugMesh.Raw(), nullptr, parentTransform });
 	}
 
 	void SceneRenderer::SubmitColliderMesh(const MeshColliderComponent& component, const glm::mat4& parentTransform)
 	{
-		for (auto debugMesh : component.ProcessedMeshes)
-			s_Data->ColliderDrawList.push_back({ debugMesh, nullptr, parentTransform });
+		for (const auto& debugMesh : component.ProcessedMeshes)
+			s_Data->ColliderDrawList.push_back({ debugMesh.Raw(), nullptr, parentTransform });
 	}
 
 	std::pair<Ref<TextureCube>, Ref<TextureCube>> SceneRenderer::CreateEnvironmentMap(const std::string& filepath)
@@ -656,6 +747,24 @@ namespace Hazel {
 		return Renderer::CreateEnvironmentMap(filepath);
 	}
 
+	static uint32_t GetTriangleCount(const SceneRendererData::DrawCommand& dc, bool fullDetail = false)
+	{
+		uint32_t triangles = 0;
+		const std::vector<Submesh>& submeshes = dc.Mesh->GetSubmeshes();
+		for (size_t i = 0; i < submeshes.size(); i++)
+			triangles += submeshes[i].GetLOD(dc.SubmeshLODs && !fullDetail ? dc.SubmeshLODs[i] : 0).IndexCount / 3;
+		return triangles;
+	}
+
+	static void AddGeometryStatistics(SceneRendererStatistics& statistics, const SceneRendererData::DrawCommand& dc)
+	{
+		statistics.MeshDraws++;
+		statistics.Triangles += GetTriangleCount(dc);
+		statistics.FullDetailTriangles += GetTriangleCount(dc, true);
+		for (size_t i = 0; i < dc.Mesh->GetSubmeshes().size(); i++)
+			statistics.SubmeshesPerLOD[dc.SubmeshLODs ? dc.SubmeshLODs[i] : 0]++;
+	}
+
 	void SceneRenderer::ShadowMapPass()
 	{
 		auto& directionalLights = s_Data->SceneData.SceneLightEnvironment.DirectionalLights;
@@ -680,7 +789,8 @@ namespace Hazel {
 			// Render entities
 			for (auto& dc : s_Data->ShadowPassDrawList)
 			{
-				Renderer::RenderMeshWithoutMaterial(s_Data->ShadowPassPipeline, dc.Mesh, dc.Transform);
+				Renderer::RenderMeshWithoutMaterial(s_Data->ShadowPassPipelines[(size_t)dc.Mesh->GetVertexFormat()], dc.Mesh, dc.Transform, dc.SubmeshLODs);
+				s_Data->Statistics.ShadowPassTriangles += GetTriangleCount(dc);
 			}
 
 			Renderer::EndRenderPass();
@@ -699,10 +809,16 @@ namespace Hazel {
 
 		// Render entities
 		for (auto& dc : s_Data->DrawList)
-			Renderer::RenderMesh(s_Data->GeometryPipeline, dc.Mesh, dc.Transform);
+		{
+			Renderer::RenderMesh(s_Data->GeometryPipelines[(size_t)dc.Mesh->GetVertexFormat()], dc.Mesh, dc.Transform, dc.SubmeshLODs);
+			AddGeometryStatistics(s_Data->Statistics, dc);
+		}
 
 		for (auto& dc : s_Data->SelectedMeshDrawList)
-			Renderer::RenderMesh(s_Data->GeometryPipeline, dc.Mesh, dc.Transform);
+		{
+			Renderer::RenderMesh(s_Data->GeometryPipelines[(size_t)dc.Mesh->GetVertexFormat()], dc.Mesh, dc.Transform, dc.SubmeshLODs);
+			AddGeometryStatistics(s_Data->Statistics, dc);
+		}
 
 		// Grid
 		if (GetOptions().ShowGrid)
@@ -802,10 +918,17 @@ namespace Hazel {
 		CompositePass();
 		//	BloomBlurPass();
 
-		s_Data->DrawList.clear();
-		s_Data->SelectedMeshDrawList.clear();
-		s_Data->ShadowPassDrawList.clear();
-		s_Data->ColliderDrawList.clear();
+		s_Data->Statistics.SubmissionTime = s_Data->SubmissionTimer.ElapsedMillis();
+		s_Data->AverageSubmissionTime += (s_Data->Statistics.SubmissionTime - s_Data->AverageSubmissionTime) * 0.01f;
+
+		s_Data->LastStatistics = s_Data->Statistics;
+		s_Data->Statistics = {};
+
+		// Not cleared: their storage belongs to this frame's arena, which is recycled a few frames from now
+		s_Data->DrawList = {};
+		s_Data->SelectedMeshDrawList = {};
+		s_Data->ShadowPassDrawList = {};
+		s_Data->ColliderDrawList = {};
 		s_Data->SceneData = {};
 	}
 
@@ -824,6 +947,11 @@ namespace Hazel {
 		return s_Data->Options;
 	}
 
+	const SceneRendererStatistics& SceneRenderer::GetStatistics()
+	{
+		return s_Data->LastStatistics;
+	}
+
 	void SceneRenderer::OnImGuiRender()
 	{
 		ImGui::Begin("Scene Renderer");
@@ -844,6 +972,32 @@ namespace Hazel {
 			ImGui::TreePop();
 		}
 
+		if (UI::BeginTreeNode("Performance"))
+		{
+			// Compare builds with HZ_ATOMIC_REFCOUNT 1 and 0 (the latter only with a SingleThreaded render thread)
+			ImGui::Text("Refcounts: %s", HZ_ATOMIC_REFCOUNT ? "atomic" : "plain");
+			ImGui::Text("Submission: %.3fms (%.3fms average)", s_Data->LastStatistics.SubmissionTime, s_Data->AverageSubmissionTime);
+			UI::EndTreeNode();
+		}
+
+		if (UI::BeginTreeNode("Level of Detail"))
+		{
+			SceneRendererOptions& options = s_Data->Options;
+			UI::BeginPropertyGrid();
+			UI::Property("Enable LOD", options.EnableLOD);
+			UI::Property("Error Threshold (px)", options.LODErrorThreshold, 0.05f, 0.0f, FLT_MAX);
+			UI::Property("Hysteresis", options.LODHysteresis, 0.01f, 0.0f, 1.0f);
+			UI::EndPropertyGrid();
+
+			const SceneRendererStatistics& statistics = s_Data->LastStatistics;
+			ImGui::Text("Mesh draws: %u", statistics.MeshDraws);
+			ImGui::Text("Triangles: %u (%u at full detail)", statistics.Triangles, statistics.FullDetailTriangles);
+			ImGui::Text("Shadow pass triangles: %u", statistics.ShadowPassTriangles);
+			for (uint32_t lod = 0; lod < Submesh::MaxLODCount; lod++)
+				ImGui::Text("LOD %u: %u submeshes", lod, statistics.SubmeshesPerLOD[lod]);
+			UI::EndTreeNode();
+		}
+
 		if (UI::BeginTreeNode("Shadows"))
 		{
 			UI::BeginPropertyGrid();
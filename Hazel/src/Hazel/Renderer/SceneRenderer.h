@@ -11,6 +11,26 @@ namespace Hazel {
 	{
 		bool ShowGrid = true;
 		bool ShowBoundingBoxes = false;
+
+		bool EnableLOD = true;
+		// Largest error on screen, in pixels, a mesh LOD may introduce
+		float LODErrorThreshold = 1.0f;
+		// Switching to a coarser LOD needs its error to be this fraction below the threshold, so LODs don't flicker
+		// back and forth around it
+		float LODHysteresis = 0.25f;
+	};
+
+	// Geometry submitted by the last scene rendered
+	struct SceneRendererStatistics
+	{
+		uint32_t MeshDraws = 0;
+		uint32_t Triangles = 0;
+		uint32_t FullDetailTriangles = 0; // What the same draws would have cost without LODs
+		uint32_t ShadowPassTriangles = 0;
+		std::array<uint32_t, Submesh::MaxLODCount> SubmeshesPerLOD{};
+
+		// Main thread time from BeginScene until the passes are recorded, mostly Ref copies into render commands
+		float SubmissionTime = 0.0f;
 	};
 
 	struct SceneRendererCamera
@@ -32,7 +52,10 @@ namespace Hazel {
 		static void BeginScene(const Scene* scene, const SceneRendererCamera& camera);
 		static void EndScene();
 
+		// Meshes submitted through their component are drawn at a LOD picked from their size on screen
+		static void SubmitMesh(MeshComponent& meshComponent, const glm::mat4& transform = glm::mat4(1.0f), Ref<Material> overrideMaterial = nullptr);
 		static void SubmitMesh(Ref<Mesh> mesh, const glm::mat4& transform = glm::mat4(1.0f), Ref<Material> overrideMaterial = nullptr);
+		static void SubmitSelectedMesh(MeshComponent& meshComponent, const glm::mat4& transform = glm::mat4(1.0f));
 		static void SubmitSelectedMesh(Ref<Mesh> mesh, const glm::mat4& transform = glm::mat4(1.0f));
 		static void SubmitColliderMesh(const BoxColliderComponent& component, const glm::mat4& parentTransform = glm::mat4(1.0F));
 		static void SubmitColliderMesh(const SphereColliderComponent& component, const glm::mat4& parentTransform = glm::mat4(1.0F));
@@ -45,9 +68,12 @@ namespace Hazel {
 		static Ref<Image2D> GetFinalPassImage();
 
 		static SceneRendererOptions& GetOptions();
+		static const SceneRendererStatistics& GetStatistics();
 
 		static void OnImGuiRender();
 	private:
+		static const uint8_t* SelectLODs(MeshComponent& meshComponent, const glm::mat4& transform);
+
 		static void FlushDrawList();
 		static void ShadowMapPass();
 		static void GeometryPass();
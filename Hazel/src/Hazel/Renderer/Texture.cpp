@@ -33,6 +33,24 @@ namespace Hazel {
 		return nullptr;
 	}
 
+	AssetMemoryUsage Texture::GetMemoryUsage() const
+	{
+		AssetMemoryUsage usage;
+		ImageFormat format = GetFormat();
+		uint32_t width = GetWidth(), height = GetHeight();
+		if (format == ImageFormat::None || width == 0 || height == 0)
+			return usage;
+
+		uint32_t mipCount = std::max(GetMipLevelCount(), 1u);
+		for (uint32_t mip = 0; mip < mipCount; mip++)
+			usage.GPUBytes += Utils::GetImageMemorySize(format, std::max(width >> mip, 1u), std::max(height >> mip, 1u));
+
+		if (GetType() == TextureType::TextureCube)
+			usage.GPUBytes *= 6;
+
+		return usage;
+	}
+
 	Ref<TextureCube> TextureCube::Create(ImageFormat format, uint32_t width, uint32_t height, const void* data, TextureProperties properties)
 	{
 		switch (RendererAPI::Current())
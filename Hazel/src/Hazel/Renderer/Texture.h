@@ -22,6 +22,9 @@ namespace Hazel {
 		virtual uint64_t GetHash() const = 0;
 
 		virtual TextureType GetType() const = 0;
+
+		// GPU size of every mip (and face), platform textures add any pixel data they keep on the CPU
+		virtual AssetMemoryUsage GetMemoryUsage() const override;
 	};
 
 	class Texture2D : public Texture
@@ -7,7 +7,9 @@ namespace Hazel {
 
 	enum class ShaderDataType
 	{
-		None = 0, Float, Float2, Float3, Float4, Mat3, Mat4, Int, Int2, Int3, Int4, Bool
+		None = 0, Float, Float2, Float3, Float4, Mat3, Mat4, Int, Int2, Int3, Int4, Bool,
+		Half2,     // 16-bit floats
+		Short4Norm // 16-bit signed integers, read as floats in [-1, 1]
 	};
 
 	static uint32_t ShaderDataTypeSize(ShaderDataType type)
@@ -25,6 +27,8 @@ namespace Hazel {
 			case ShaderDataType::Int3:     return 4 * 3;
 			case ShaderDataType::Int4:     return 4 * 4;
 			case ShaderDataType::Bool:     return 1;
+			case ShaderDataType::Half2:    return 2 * 2;
+			case ShaderDataType::Short4Norm: return 2 * 4;
 		}
 
 		HZ_CORE_ASSERT(false, "Unknown ShaderDataType!");
@@ -61,6 +65,8 @@ namespace Hazel {
 				case ShaderDataType::Int3:    return 3;
 				case ShaderDataType::Int4:    return 4;
 				case ShaderDataType::Bool:    return 1;
+				case ShaderDataType::Half2:   return 2;
+				case ShaderDataType::Short4Norm: return 4;
 			}
 
 			HZ_CORE_ASSERT(false, "Unknown ShaderDataType!");
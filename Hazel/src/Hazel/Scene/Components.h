@@ -49,10 +49,6 @@ namespace Hazel {
 		glm::vec3 Rotation = { 0.0f, 0.0f, 0.0f };
 		glm::vec3 Scale = { 1.0f, 1.0f, 1.0f };
 
-		glm::vec3 Up = { 0.0F, 1.0F, 0.0F };
-		glm::vec3 Right = { 1.0F, 0.0F, 0.0F };
-		glm::vec3 Forward = { 0.0F, 0.0F, -1.0F };
-
 		TransformComponent() = default;
 		TransformComponent(const TransformComponent& other) = default;
 		TransformComponent(const glm::vec3& translation)
@@ -66,10 +62,36 @@ namespace Hazel {
 		}
 	};
 
+	// Cached world-space transform, maintained by Scene::UpdateWorldTransforms.
+	// Not serialized or copied; a fresh component starts dirty and is rebuilt on the next update.
+	struct WorldTransformComponent
+	{
+		glm::mat4 Transform = glm::mat4(1.0f);
+		glm::mat4 LocalTransform = glm::mat4(1.0f);
+
+		glm::vec3 Up = { 0.0F, 1.0F, 0.0F };
+		glm::vec3 Right = { 1.0F, 0.0F, 0.0F };
+		glm::vec3 Forward = { 0.0F, 0.0F, -1.0F };
+
+		// Local state the cached transform was built from, used to detect changes
+		glm::vec3 LocalTranslation = { 0.0f, 0.0f, 0.0f };
+		glm::vec3 LocalRotation = { 0.0f, 0.0f, 0.0f };
+		glm::vec3 LocalScale = { 1.0f, 1.0f, 1.0f };
+		UUID ParentHandle = 0;
+
+		bool Dirty = true;
+
+		WorldTransformComponent() = default;
+		WorldTransformComponent(const WorldTransformComponent& other) = default;
+	};
+
 	struct MeshComponent
 	{
 		Ref<Hazel::Mesh> Mesh;
 
+		// LOD each submesh was drawn with last frame, SceneRenderer only changes it past a hysteresis band
+		std::vector<uint8_t> SubmeshLODs;
+
 		MeshComponent() = default;
 		MeshComponent(const MeshComponent& other) = default;
 		MeshComponent(const Ref<Hazel::Mesh>& mesh)
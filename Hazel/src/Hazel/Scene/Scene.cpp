@@ -11,6 +11,7 @@
 #include "Hazel/Renderer/Renderer2D.h"
 #include "Hazel/Physics/Physics.h"
 #include "Hazel/Physics/PhysicsActor.h"
+#include "Hazel/Physics/PXPhysicsWrappers.h"
 
 #include "Hazel/Math/Math.h"
 #include "Hazel/Renderer/Renderer.h"
@@ -127,11 +128,67 @@ namespace Hazel {
 		ScriptEngine::OnScriptComponentDestroyed(sceneID, entityID);
 	}
 
+	static void OnTagComponentConstruct(entt::registry& registry, entt::entity entity)
+	{
+		auto sceneView = registry.view<SceneComponent>();
+		UUID sceneID = registry.get<SceneComponent>(sceneView.front()).SceneID;
+
+		Scene* scene = s_ActiveScenes[sceneID];
+		const auto& tag = registry.get<TagComponent>(entity).Tag;
+		scene->m_TagIndex.emplace(Scene::GetTagHash(tag), entity);
+	}
+
+	static void RemoveFromTagIndex(std::unordered_multimap<uint64_t, entt::entity>& tagIndex, uint64_t tagHash, entt::entity entity)
+	{
+		auto [begin, end] = tagIndex.equal_range(tagHash);
+		for (auto it = begin; it != end; ++it)
+		{
+			if (it->second == entity)
+			{
+				tagIndex.erase(it);
+				return;
+			}
+		}
+	}
+
+	static void OnTagComponentDestroy(entt::registry& registry, entt::entity entity)
+	{
+		auto sceneView = registry.view<SceneComponent>();
+		UUID sceneID = registry.get<SceneComponent>(sceneView.front()).SceneID;
+
+		Scene* scene = s_ActiveScenes[sceneID];
+		const auto& tag = registry.get<TagComponent>(entity).Tag;
+		RemoveFromTagIndex(scene->m_TagIndex, Scene::GetTagHash(tag), entity);
+	}
+
+	// replace/emplace_or_replace/patch; the old tag is gone by now, so the entity's entry is found by scanning
+	static void OnTagComponentUpdate(entt::registry& registry, entt::entity entity)
+	{
+		auto sceneView = registry.view<SceneComponent>();
+		UUID sceneID = registry.get<SceneComponent>(sceneView.front()).SceneID;
+
+		Scene* scene = s_ActiveScenes[sceneID];
+		for (auto it = scene->m_TagIndex.begin(); it != scene->m_TagIndex.end(); ++it)
+		{
+			if (it->second == entity)
+			{
+				scene->m_TagIndex.erase(it);
+				break;
+			}
+		}
+
+		const auto& tag = registry.get<TagComponent>(entity).Tag;
+		scene->m_TagIndex.emplace(Scene::GetTagHash(tag), entity);
+	}
+
 	Scene::Scene(const std::string& debugName, bool isEditorScene)
 		: m_DebugName(debugName)
 	{
 		m_Registry.on_construct<ScriptComponent>().connect<&OnScriptComponentConstruct>();
 		m_Registry.on_destroy<ScriptComponent>().connect<&OnScriptComponentDestroy>();
+		m_Registry.on_construct<TagComponent>().connect<&OnTagComponentConstruct>();
+		m_Registry.on_destroy<TagComponent>().connect<&OnTagComponentDestroy>();
+		m_Registry.on_update<TagComponent>().connect<&OnTagComponentUpdate>();
 
 		m_SceneEntity = m_Registry.create();
 		m_Registry.emplace<SceneComponent>(m_SceneEntity, m_SceneID);
@@ -145,12 +202,14 @@ namespace Hazel {
 		if (!isEditorScene)
 			Physics::CreateScene();
 
+		RegisterSystems();
 		Init();
 	}
 
 	Scene::~Scene()
 	{
 		m_Registry.on_destroy<ScriptComponent>().disconnect();
+		m_Registry.on_destroy<TagComponent>().disconnect();
 
 		m_Registry.clear();
 		s_ActiveScenes.erase(m_SceneID);
@@ -164,33 +223,35 @@ namespace Hazel {
 		m_SkyboxMaterial->SetFlag(MaterialFlag::DepthTest, false);
 	}
 
-	// Merge OnUpdate/Render into one function?
-	void Scene::OnUpdate(Timestep ts)
+	void Scene::RegisterSystems()
 	{
-		// Box2D physics
-		auto sceneView = m_Registry.view<Box2DWorldComponent>();
-		auto& box2DWorld = m_Registry.get<Box2DWorldComponent>(sceneView.front()).World;
-		int32_t velocityIterations = 6;
-		int32_t positionIterations = 2;
-		box2DWorld->Step(ts, velocityIterations, positionIterations);
-
+		// Systems that reach Mono (scripts, contact callbacks) stay on the main thread and are exclusive.
+		// Add order is execution order for systems that conflict.
+		m_SystemScheduler.AddSystem("Box2D Step", SystemAccess::All(), [this](Timestep ts)
 		{
-			auto view = m_Registry.view<RigidBody2DComponent>();
+			auto sceneView = m_Registry.view<Box2DWorldComponent>();
+			auto& box2DWorld = m_Registry.get<Box2DWorldComponent>(sceneView.front()).World;
+			int32_t velocityIterations = 6;
+			int32_t positionIterations = 2;
+			box2DWorld->Step(ts, velocityIterations, positionIterations);
+		}, true);
+
+		m_SystemScheduler.AddSystem("RigidBody2D Write-back", SystemAccess().Read<RigidBody2DComponent, Box2DWorldComponent>().Write<TransformComponent>(), [this](Timestep ts)
+		{
+			auto view = m_Registry.view<RigidBody2DComponent, TransformComponent>();
 			for (auto entity : view)
 			{
-				Entity e = { entity, this };
-				auto& rb2d = e.GetComponent<RigidBody2DComponent>();
+				auto [rb2d, transform] = view.get<RigidBody2DComponent, TransformComponent>(entity);
 				b2Body* body = static_cast<b2Body*>(rb2d.RuntimeBody);
 
 				auto& position = body->GetPosition();
-				auto& transform = e.GetComponent<TransformComponent>();
 				transform.Translation.x = position.x;
 				transform.Translation.y = position.y;
 				transform.Rotation.z = body->GetAngle();
 			}
-		}
+		});
 
-		// Update all entities
+		m_SystemScheduler.AddSystem("Scripts", SystemAccess::All(), [this](Timestep ts)
 		{
 			auto view = m_Registry.view<ScriptComponent>();
 			for (auto entity : view)
@@ -199,27 +260,42 @@ namespace Hazel {
 				if (ScriptEngine::ModuleExists(e.GetComponent<ScriptComponent>().ModuleName))
 					ScriptEngine::OnUpdateEntity(e, ts);
 			}
-		}
+		}, true);
 
+		m_SystemScheduler.AddSystem("Mesh Animation", SystemAccess().Write<MeshComponent>(), [this](Timestep ts)
 		{
-			auto view = m_Registry.view<TransformComponent>();
+			auto view = m_Registry.view<MeshComponent>();
 			for (auto entity : view)
 			{
-				auto& transformComponent = view.get(entity);
-				glm::mat4 transform = GetTransformRelativeToParent(Entity(entity, this));
-				glm::vec3 translation;
-				glm::vec3 rotation;
-				glm::vec3 scale;
-				Math::DecomposeTransform(transform, translation, rotation, scale);
-
-				glm::quat rotationQuat = glm::quat(rotation);
-				transformComponent.Up = glm::normalize(glm::rotate(rotationQuat, glm::vec3(0.0f, 1.0f, 0.0f)));
-				transformComponent.Right = glm::normalize(glm::rotate(rotationQuat, glm::vec3(1.0f, 0.0f, 0.0f)));
-				transformComponent.Forward = glm::normalize(glm::rotate(rotationQuat, glm::vec3(0.0f, 0.0f, -1.0f)));
+				auto& meshComponent = view.get(entity);
+				if (meshComponent.Mesh && meshComponent.Mesh->Type == AssetType::Mesh)
+					meshComponent.Mesh->OnUpdate(ts);
 			}
-		}
+		});
+
+		// Static PhysX actors are synchronized from the world transform cache
+		m_SystemScheduler.AddSystem("World Transforms", SystemAccess().Read<TransformComponent, RelationshipComponent>().Write<WorldTransformComponent>(), [this](Timestep ts)
+		{
+			UpdateWorldTransforms();
+		});
 
-		Physics::Simulate(ts);
+		m_SystemScheduler.AddSystem("PhysX Simulate", SystemAccess::All(), [](Timestep ts)
+		{
+			Physics::Simulate(ts);
+		}, true);
+
+		// Creating a pool mutates the registry, so make sure worker systems never have to
+		m_Registry.prepare<RigidBody2DComponent>();
+		m_Registry.prepare<TransformComponent>();
+		m_Registry.prepare<RelationshipComponent>();
+		m_Registry.prepare<WorldTransformComponent>();
+		m_Registry.prepare<MeshComponent>();
+	}
+
+	// Merge OnUpdate/Render into one function?
+	void Scene::OnUpdate(Timestep ts)
+	{
+		m_SystemScheduler.Run(ts);
 	}
 
 	void Scene::OnRenderRuntime(Timestep ts)
@@ -231,7 +307,10 @@ namespace Hazel {
 		if (!cameraEntity)
 			return;
 
-		glm::mat4 cameraViewMatrix = glm::inverse(GetTransformRelativeToParent(cameraEntity));
+		// Picks up anything physics wrote back this frame; unchanged subtrees are skipped
+		UpdateWorldTransforms();
+
+		glm::mat4 cameraViewMatrix = glm::inverse(GetWorldTransform(cameraEntity));
 		HZ_CORE_ASSERT(cameraEntity, "Scene does not contain any cameras!");
 		SceneCamera& camera = cameraEntity.GetComponent<CameraComponent>();
 		camera.SetViewportSize(m_ViewportWidth, m_ViewportHeight);
@@ -278,8 +357,7 @@ namespace Hazel {
 			auto [transformComponent, meshComponent] = group.get<TransformComponent, MeshComponent>(entity);
 			if (meshComponent.Mesh && meshComponent.Mesh->Type == AssetType::Mesh)
 			{
-				meshComponent.Mesh->OnUpdate(ts);
-				glm::mat4 transform = GetTransformRelativeToParent(Entity(entity, this));
+				const glm::mat4& transform = GetWorldTransform(Entity(entity, this));
 
 				// TODO: Should we render (logically)
 				SceneRenderer::SubmitMesh(meshComponent, transform);
@@ -313,6 +391,8 @@ namespace Hazel {
 		// RENDER 3D SCENE
 		/////////////////////////////////////////////////////////////////////
 
+		UpdateWorldTransforms();
+
 		{
 			m_LightEnvironment = LightEnvironment();
 			auto lights = m_Registry.group<DirectionalLightComponent>(entt::get<TransformComponent>);
@@ -362,8 +442,7 @@ namespace Hazel {
 			{
 				meshComponent.Mesh->OnUpdate(ts);
 
-				// TODO(Peter): Is this any good?
-				glm::mat4 transform = GetTransformRelativeToParent(Entity{ entity, this });
+				const glm::mat4& transform = GetWorldTransform(Entity{ entity, this });
 
 				// TODO: Should we render (logically)
 				if (m_SelectedEntity == entity)
@@ -378,7 +457,7 @@ namespace Hazel {
 			for (auto entity : view)
 			{
 				Entity e = { entity, this };
-				glm::mat4 transform = GetTransformRelativeToParent(e);
+				const glm::mat4& transform = GetWorldTransform(e);
 				auto& collider = e.GetComponent<BoxColliderComponent>();
 
 				if (m_SelectedEntity == entity)
@@ -391,7 +470,7 @@ namespace Hazel {
 			for (auto entity : view)
 			{
 				Entity e = { entity, this };
-				glm::mat4 transform = GetTransformRelativeToParent(e);
+				const glm::mat4& transform = GetWorldTransform(e);
 				auto& collider = e.GetComponent<SphereColliderComponent>();
 
 				if (m_SelectedEntity == entity)
@@ -404,7 +483,7 @@ namespace Hazel {
 			for (auto entity : view)
 			{
 				Entity e = { entity, this };
-				glm::mat4 transform = GetTransformRelativeToParent(e);
+				const glm::mat4& transform = GetWorldTransform(e);
 				auto& collider = e.GetComponent<CapsuleColliderComponent>();
 
 				if (m_SelectedEntity == entity)
@@ -417,7 +496,7 @@ namespace Hazel {
 			for (auto entity : view)
 			{
 				Entity e = { entity, this };
-				glm::mat4 transform = GetTransformRelativeToParent(e);
+				const glm::mat4& transform = GetWorldTransform(e);
 				auto& collider = e.GetComponent<MeshColliderComponent>();
 
 				if (m_SelectedEntity == entity)
@@ -567,6 +646,8 @@ namespace Hazel {
 			}
 		}
 
+		UpdateWorldTransforms();
+
 		{
 			auto view = m_Registry.view<RigidBodyComponent>();
 			for (auto entity : view)
@@ -619,6 +700,7 @@ namespace Hazel {
 		idComponent.ID = {};
 
 		entity.AddComponent<TransformComponent>();
+		entity.AddComponent<WorldTransformComponent>();
 		if (!name.empty())
 			entity.AddComponent<TagComponent>(name);
 
@@ -635,6 +717,7 @@ namespace Hazel {
 		idComponent.ID = uuid;
 
 		entity.AddComponent<TransformComponent>();
+		entity.AddComponent<WorldTransformComponent>();
 		if (!name.empty())
 			entity.AddComponent<TagComponent>(name);
 
@@ -650,6 +733,7 @@ namespace Hazel {
 		if (entity.HasComponent<ScriptComponent>())
 			ScriptEngine::OnScriptComponentDestroyed(m_SceneID, entity.GetUUID());
 
+		m_EntityIDMap.erase(entity.GetUUID());
 		m_Registry.destroy(entity.m_EntityHandle);
 	}
 
@@ -704,27 +788,50 @@ namespace Hazel {
 
 	Entity Scene::FindEntityByTag(const std::string& tag)
 	{
-		// TODO: If this becomes used often, consider indexing by tag
-		auto view = m_Registry.view<TagComponent>();
-		for (auto entity : view)
+		auto [begin, end] = m_TagIndex.equal_range(GetTagHash(tag));
+		for (auto it = begin; it != end; ++it)
 		{
-			const auto& canditate = view.get<TagComponent>(entity).Tag;
+			// Compare the actual string to rule out hash collisions
+			const auto& canditate = m_Registry.get<TagComponent>(it->second).Tag;
 			if (canditate == tag)
-				return Entity(entity, this);
+				return Entity(it->second, this);
 		}
 
 		return Entity{};
 	}
 
+	Entity Scene::FindEntityByTagHash(uint64_t tagHash)
+	{
+		auto it = m_TagIndex.find(tagHash);
+		if (it != m_TagIndex.end())
+			return Entity(it->second, this);
+
+		return Entity{};
+	}
+
+	uint64_t Scene::GetTagHash(const std::string& tag)
+	{
+		return std::hash<std::string>()(tag);
+	}
+
+	void Scene::SetEntityTag(Entity entity, const std::string& tag)
+	{
+		auto& tagComponent = entity.GetComponent<TagComponent>();
+		if (tagComponent.Tag == tag)
+			return;
+
+		RemoveFromTagIndex(m_TagIndex, GetTagHash(tagComponent.Tag), entity);
+		tagComponent.Tag = tag;
+		m_TagIndex.emplace(GetTagHash(tag), entity);
+	}
+
 	Entity Scene::FindEntityByUUID(UUID id)
 	{
-		auto view = m_Registry.view<IDComponent>();
-		for (auto entity : view)
-		{
-			auto& idComponent = m_Registry.get<IDComponent>(entity);
-			if (idComponent.ID == id)
-				return Entity(entity, this);
-		}
+		// m_EntityIDMap is kept in sync by CreateEntity/CreateEntityWithID/DestroyEntity,
+		// so this is a single hash lookup instead of a walk over every IDComponent
+		auto it = m_EntityIDMap.find(id);
+		if (it != m_EntityIDMap.end())
+			return it->second;
 
 		return Entity{};
 	}
@@ -740,6 +847,230 @@ namespace Hazel {
 		return transform * entity.Transform().GetTransform();
 	}
 
+	void Scene::UpdateWorldTransforms()
+	{
+		// Gather every entity whose local TRS changed and compose their local matrices in one batch
+		m_TransformPool.Clear();
+		m_TransformPoolEntities.clear();
+
+		auto transforms = m_Registry.view<TransformComponent, WorldTransformComponent>();
+		for (auto entity : transforms)
+		{
+			auto [transform, worldTransform] = transforms.get<TransformComponent, WorldTransformComponent>(entity);
+			if (!worldTransform.Dirty
+				&& worldTransform.LocalTranslation == transform.Translation
+				&& worldTransform.LocalRotation == transform.Rotation
+				&& worldTransform.LocalScale == transform.Scale)
+				continue;
+
+			worldTransform.LocalTranslation = transform.Translation;
+			worldTransform.LocalRotation = transform.Rotation;
+			worldTransform.LocalScale = transform.Scale;
+			worldTransform.Dirty = true;
+
+			m_TransformPool.Add(transform.Translation, transform.Rotation, transform.Scale);
+			m_TransformPoolEntities.push_back(entity);
+		}
+
+		m_ComposedTransforms.resize(m_TransformPool.Size());
+		m_TransformPool.ComposeTransforms(m_ComposedTransforms.data());
+		for (size_t i = 0; i < m_TransformPoolEntities.size(); i++)
+			m_Registry.get<WorldTransformComponent>(m_TransformPoolEntities[i]).LocalTransform = m_ComposedTransforms[i];
+
+		// Then propagate down the hierarchy from the roots; entities whose parent no longer exists are treated as roots
+		auto view = m_Registry.view<RelationshipComponent, WorldTransformComponent>();
+		for (auto entity : view)
+		{
+			UUID parentHandle = view.get<RelationshipComponent>(entity).ParentHandle;
+			if (parentHandle != 0 && m_EntityIDMap.find(parentHandle) != m_EntityIDMap.end())
+				continue;
+
+			UpdateWorldTransform(entity, nullptr, false);
+		}
+	}
+
+	void Scene::UpdateWorldTransform(entt::entity entity, const glm::mat4* parentTransform, bool parentChanged)
+	{
+		auto [relationship, worldTransform] = m_Registry.get<RelationshipComponent, WorldTransformComponent>(entity);
+
+		bool changed = parentChanged || worldTransform.Dirty || worldTransform.ParentHandle != relationship.ParentHandle;
+		if (changed)
+		{
+			worldTransform.Transform = parentTransform ? *parentTransform * worldTransform.LocalTransform : worldTransform.LocalTransform;
+			worldTransform.ParentHandle = relationship.ParentHandle;
+			worldTransform.Dirty = false;
+
+			// The basis vectors of the world matrix are the rotated axes (scaled, hence the normalize)
+			worldTransform.Right = glm::normalize(glm::vec3(worldTransform.Transform[0]));
+			worldTransform.Up = glm::normalize(glm::vec3(worldTransform.Transform[1]));
+			worldTransform.Forward = -glm::normalize(glm::vec3(worldTransform.Transform[2]));
+
+			m_RaycastBVHDirty = true;
+		}
+
+		for (UUID child : relationship.Children)
+		{
+			auto it = m_EntityIDMap.find(child);
+			if (it != m_EntityIDMap.end())
+				UpdateWorldTransform(it->second, &worldTransform.Transform, changed);
+		}
+	}
+
+	const glm::mat4& Scene::GetWorldTransform(Entity entity)
+	{
+		return m_Registry.get<WorldTransformComponent>(entity).Transform;
+	}
+
+	// Animated meshes have no static vertices to test against
+	static bool IsRaycastable(const Ref<Mesh>& mesh)
+	{
+		return mesh && mesh->Type != AssetType::Missing && !mesh->IsAnimated();
+	}
+
+	// Box around a transformed box: each basis vector adds its smaller and larger product with the old extents (Arvo)
+	static AABB TransformBounds(const glm::mat4& transform, const AABB& bounds)
+	{
+		glm::vec3 min(transform[3]), max(transform[3]);
+		for (int axis = 0; axis < 3; axis++)
+		{
+			glm::vec3 a = glm::vec3(transform[axis]) * bounds.Min[axis];
+			glm::vec3 b = glm::vec3(transform[axis]) * bounds.Max[axis];
+			min += glm::min(a, b);
+			max += glm::max(a, b);
+		}
+		return { min, max };
+	}
+
+	static Ray TransformRay(const glm::mat4& transform, const Ray& ray)
+	{
+		// The direction isn't normalized, so distances along the ray are the same in every space
+		return { glm::inverse(transform) * glm::vec4(ray.Origin, 1.0f), glm::inverse(glm::mat3(transform)) * ray.Direction };
+	}
+
+	void Scene::UpdateRaycastBVH()
+	{
+		// Meshes can be swapped on their components without the scene hearing about it, so compare against the entity list
+		auto view = m_Registry.view<MeshComponent>();
+		if (!m_RaycastBVHDirty)
+		{
+			size_t index = 0;
+			for (auto entity : view)
+			{
+				const auto& mesh = view.get<MeshComponent>(entity).Mesh;
+				if (!IsRaycastable(mesh) || mesh->GetSubmeshes().empty())
+					continue;
+
+				if (index >= m_RaycastEntities.size() || m_RaycastEntities[index].Entity != entity || m_RaycastEntities[index].Mesh != mesh.Raw())
+				{
+					m_RaycastBVHDirty = true;
+					break;
+				}
+				index++;
+			}
+
+			if (!m_RaycastBVHDirty && index == m_RaycastEntities.size())
+				return;
+		}
+
+		m_RaycastEntities.clear();
+		std::vector<AABB> bounds;
+		for (auto entity : view)
+		{
+			auto& mesh = view.get<MeshComponent>(entity).Mesh;
+			if (!IsRaycastable(mesh) || mesh->GetSubmeshes().empty())
+				continue;
+
+			const glm::mat4& transform = m_Registry.get<WorldTransformComponent>(entity).Transform;
+			AABB entityBounds = { glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX) };
+			for (const Submesh& submesh : mesh->GetSubmeshes())
+			{
+				AABB submeshBounds = TransformBounds(transform * submesh.Transform, submesh.BoundingBox);
+				entityBounds.Min = glm::min(entityBounds.Min, submeshBounds.Min);
+				entityBounds.Max = glm::max(entityBounds.Max, submeshBounds.Max);
+			}
+			m_RaycastEntities.push_back({ entity, mesh.Raw() });
+			bounds.push_back(entityBounds);
+		}
+
+		m_RaycastBVH.Build(bounds.data(), (uint32_t)bounds.size());
+		m_RaycastBVHDirty = false;
+	}
+
+	bool Scene::Raycast(const Ray& ray, MeshRaycastHit& outHit)
+	{
+		UpdateWorldTransforms();
+		UpdateRaycastBVH();
+
+		float closest = std::numeric_limits<float>::max();
+		return m_RaycastBVH.Raycast(ray, closest, [&](const uint32_t* primitives, uint32_t count, float& closest)
+		{
+			bool hit = false;
+			for (uint32_t i = 0; i < count; i++)
+			{
+				const RaycastEntity& candidate = m_RaycastEntities[primitives[i]];
+				const glm::mat4& transform = m_Registry.get<WorldTransformComponent>(candidate.Entity).Transform;
+				const auto& submeshes = candidate.Mesh->GetSubmeshes();
+				for (uint32_t s = 0; s < submeshes.size(); s++)
+				{
+					Ray submeshRay = TransformRay(transform * submeshes[s].Transform, ray);
+					float t;
+					if (!submeshRay.IntersectsAABB(submeshes[s].BoundingBox, t) || t > closest)
+						continue;
+
+					if (candidate.Mesh->RaycastSubmesh(s, submeshRay, t, closest))
+					{
+						closest = t;
+						outHit = { candidate.Entity, s, t };
+						hit = true;
+					}
+				}
+			}
+			return hit;
+		});
+	}
+
+	bool Scene::RaycastBruteForce(const Ray& ray, MeshRaycastHit& outHit)
+	{
+		UpdateWorldTransforms();
+
+		float closest = std::numeric_limits<float>::max();
+		bool hit = false;
+		auto view = m_Registry.view<MeshComponent>();
+		for (auto entity : view)
+		{
+			const auto& mesh = view.get<MeshComponent>(entity).Mesh;
+			if (!IsRaycastable(mesh))
+				continue;
+
+			const glm::mat4& transform = m_Registry.get<WorldTransformComponent>(entity).Transform;
+			const auto& vertices = mesh->GetStaticVertices();
+			const auto& indices = mesh->GetIndices();
+			const auto& submeshes = mesh->GetSubmeshes();
+			for (uint32_t s = 0; s < submeshes.size(); s++)
+			{
+				const Submesh& submesh = submeshes[s];
+				Ray submeshRay = TransformRay(transform * submesh.Transform, ray);
+				float t;
+				if (!submeshRay.IntersectsAABB(submesh.BoundingBox, t))
+					continue;
+
+				for (uint32_t i = submesh.BaseIndex / 3; i < (submesh.BaseIndex + submesh.IndexCount) / 3; i++)
+				{
+					const glm::vec3& a = vertices[submesh.BaseVertex + indices[i].V1].Position;
+					const glm::vec3& b = vertices[submesh.BaseVertex + indices[i].V2].Position;
+					const glm::vec3& c = vertices[submesh.BaseVertex + indices[i].V3].Position;
+					if (submeshRay.IntersectsTriangle(a, b, c, t) && t < closest)
+					{
+						closest = t;
+						outHit = { entity, s, t };
+						hit = true;
+					}
+				}
+			}
+		}
+		return hit;
+	}
+
 	// Copy to runtime
 	void Scene::CopyTo(Ref<Scene>& target)
 	{
@@ -794,6 +1125,90 @@ namespace Hazel {
 		return {};
 	}
 
+	void Scene::OnAssetReloaded(const Ref<Asset>& asset)
+	{
+		for (auto& [sceneID, scene] : s_ActiveScenes)
+			scene->ReplaceAsset(asset);
+	}
+
+	void Scene::ReplaceAsset(const Ref<Asset>& asset)
+	{
+		auto matches = [&asset](const auto& reference) { return reference && reference->Handle == asset->Handle; };
+
+		switch (asset->Type)
+		{
+			case AssetType::Mesh:
+			{
+				Ref<Mesh> mesh = asset.As<Mesh>();
+				for (auto entity : m_Registry.view<MeshComponent>())
+				{
+					auto& mc = m_Registry.get<MeshComponent>(entity);
+					if (matches(mc.Mesh))
+						mc.Mesh = mesh;
+				}
+
+				// Only colliders built from this mesh are cooked again
+				for (auto entity : m_Registry.view<MeshColliderComponent>())
+				{
+					auto& mcc = m_Registry.get<MeshColliderComponent>(entity);
+					if (!matches(mcc.CollisionMesh))
+						continue;
+
+					mcc.CollisionMesh = mesh;
+					const glm::vec3& scale = m_Registry.get<TransformComponent>(entity).Scale;
+					std::vector<physx::PxShape*> shapes = mcc.IsConvex ? PXPhysicsWrappers::CreateConvexMesh(mcc, scale) : PXPhysicsWrappers::CreateTriangleMesh(mcc, scale);
+					for (physx::PxShape* shape : shapes)
+						shape->release();
+				}
+				break;
+			}
+			case AssetType::Texture:
+			{
+				Ref<Texture2D> texture = asset.As<Texture2D>();
+				for (auto entity : m_Registry.view<SpriteRendererComponent>())
+				{
+					auto& src = m_Registry.get<SpriteRendererComponent>(entity);
+					if (matches(src.Texture))
+						src.Texture = texture;
+				}
+				break;
+			}
+			case AssetType::EnvMap:
+			{
+				Ref<Environment> environment = asset.As<Environment>();
+				for (auto entity : m_Registry.view<SkyLightComponent>())
+				{
+					auto& slc = m_Registry.get<SkyLightComponent>(entity);
+					if (matches(slc.SceneEnvironment))
+						slc.SceneEnvironment = environment;
+				}
+
+				if (matches(m_Environment))
+					m_Environment = environment;
+				break;
+			}
+			case AssetType::PhysicsMat:
+			{
+				Ref<PhysicsMaterial> material = asset.As<PhysicsMaterial>();
+				auto replaceMaterial = [&](auto view)
+				{
+					for (auto entity : view)
+					{
+						auto& collider = view.get(entity);
+						if (matches(collider.Material))
+							collider.Material = material;
+					}
+				};
+
+				replaceMaterial(m_Registry.view<BoxColliderComponent>());
+				replaceMaterial(m_Registry.view<SphereColliderComponent>());
+				replaceMaterial(m_Registry.view<CapsuleColliderComponent>());
+				replaceMaterial(m_Registry.view<MeshColliderComponent>());
+				break;
+			}
+		}
+	}
+
 	float Scene::GetPhysics2DGravity() const
 	{
 		return m_Registry.get<Box2DWorldComponent>(m_SceneEntity).World->GetGravity().y;
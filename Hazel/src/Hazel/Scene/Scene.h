@@ -8,6 +8,9 @@
 #include "Hazel/Renderer/Material.h"
 #include "Hazel/Renderer/SceneEnvironment.h"
 
+#include "Hazel/Math/TransformPool.h"
+#include "Hazel/Math/BVH.h"
+#include "Hazel/Scene/SystemScheduler.h"
 
 #include "entt/entt.hpp"
 
@@ -39,7 +42,15 @@ namespace Hazel {
 		DirectionalLight DirectionalLights[4];
 	};
 
+	struct MeshRaycastHit
+	{
+		entt::entity Entity = entt::null;
+		uint32_t SubmeshIndex = 0;
+		float Distance = 0.0f; // In multiples of the ray's direction
+	};
+
 	class Entity;
+	class Mesh;
 	using EntityMap = std::unordered_map<UUID, Entity>;
 
 	class Scene : public RefCounted
@@ -85,10 +96,23 @@ namespace Hazel {
 		}
 
 		Entity FindEntityByTag(const std::string& tag);
+		Entity FindEntityByTagHash(uint64_t tagHash);
+		static uint64_t GetTagHash(const std::string& tag);
+		void SetEntityTag(Entity entity, const std::string& tag);
 		Entity FindEntityByUUID(UUID id);
 
 		glm::mat4 GetTransformRelativeToParent(Entity entity);
 
+		// Rebuilds cached world transforms parent-before-child, only for subtrees whose local transform changed
+		void UpdateWorldTransforms();
+		const glm::mat4& GetWorldTransform(Entity entity);
+
+		// Closest static mesh hit by a world space ray. Entities are found through a BVH over their world bounds,
+		// which is rebuilt when a transform or mesh changes, then only their submeshes' BVHs are traversed.
+		bool Raycast(const Ray& ray, MeshRaycastHit& outHit);
+		// Same result as Raycast by testing every triangle behind every submesh box the ray hits
+		bool RaycastBruteForce(const Ray& ray, MeshRaycastHit& outHit);
+
 		const EntityMap& GetEntityMap() const { return m_EntityIDMap; }
 		void CopyTo(Ref<Scene>& target);
 
@@ -96,11 +120,21 @@ namespace Hazel {
 
 		static Ref<Scene> GetScene(UUID uuid);
 
+		// Swaps a reimported asset into every active scene, see AssetManager::AddAssetReloadCallback
+		static void OnAssetReloaded(const Ref<Asset>& asset);
+
+		SystemScheduler& GetSystemScheduler() { return m_SystemScheduler; }
+
 		float GetPhysics2DGravity() const;
 		void SetPhysics2DGravity(float gravity);
 
 		// Editor-specific
 		void SetSelectedEntity(entt::entity entity) { m_SelectedEntity = entity; }
+	private:
+		void RegisterSystems();
+		void UpdateWorldTransform(entt::entity entity, const glm::mat4* parentTransform, bool parentChanged);
+		void UpdateRaycastBVH();
+		void ReplaceAsset(const Ref<Asset>& asset);
 	private:
 		UUID m_SceneID;
 		entt::entity m_SceneEntity;
@@ -110,6 +144,24 @@ namespace Hazel {
 		uint32_t m_ViewportWidth = 0, m_ViewportHeight = 0;
 
 		EntityMap m_EntityIDMap;
+		std::unordered_multimap<uint64_t, entt::entity> m_TagIndex;
+
+		// Scratch storage for batching local transform composition, reused every frame
+		TransformPool m_TransformPool;
+		std::vector<entt::entity> m_TransformPoolEntities;
+		std::vector<glm::mat4> m_ComposedTransforms;
+
+		// Top-level raycast BVH, its primitives index m_RaycastEntities
+		struct RaycastEntity
+		{
+			entt::entity Entity;
+			Hazel::Mesh* Mesh;
+		};
+		BVH m_RaycastBVH;
+		std::vector<RaycastEntity> m_RaycastEntities;
+		bool m_RaycastBVHDirty = true;
+
+		SystemScheduler m_SystemScheduler;
 
 		Light m_Light;
 		float m_LightMultiplier = 0.3f;
@@ -135,6 +187,9 @@ namespace Hazel {
 
 		friend void OnScriptComponentConstruct(entt::registry& registry, entt::entity entity);
 		friend void OnScriptComponentDestroy(entt::registry& registry, entt::entity entity);
+		friend void OnTagComponentConstruct(entt::registry& registry, entt::entity entity);
+		friend void OnTagComponentDestroy(entt::registry& registry, entt::entity entity);
+		friend void OnTagComponentUpdate(entt::registry& registry, entt::entity entity);
 	};
 
 }
\ No newline at end of file
@@ -9,6 +9,8 @@
 #include "Hazel/Renderer/MeshFactory.h"
 
 #include "Hazel/Asset/AssetManager.h"
+#include "Hazel/Utilities/VirtualFileSystem.h"
+#include "Hazel/Core/Timer.h"
 
 #include "yaml-cpp/yaml.h"
 
@@ -152,6 +154,8 @@ namespace Hazel {
 		return out;
 	}
 
+	bool SceneSerializer::s_PreloadAssets = true;
+
 	SceneSerializer::SceneSerializer(const Ref<Scene>& scene)
 		: m_Scene(scene)
 	{
@@ -564,14 +568,53 @@ namespace Hazel {
 		HZ_CORE_ASSERT(false);
 	}
 
-	bool SceneSerializer::Deserialize(const std::string& filepath)
+	static AssetHandle GetAssetHandle(const YAML::Node& component, const char* pathKey, const char* handleKey)
+	{
+		if (component[pathKey])
+			return AssetManager::GetAssetHandleFromFilePath(component[pathKey].as<std::string>());
+
+		return component[handleKey] ? component[handleKey].as<uint64_t>() : 0;
+	}
+
+	// Every asset the entities reference, read with the same keys the components are deserialized from.
+	// Textures are loaded by the meshes that use them.
+	static std::vector<AssetHandle> CollectAssetDependencies(const YAML::Node& entities)
 	{
-		std::ifstream stream(filepath);
-		HZ_CORE_ASSERT(stream);
-		std::stringstream strStream;
-		strStream << stream.rdbuf();
+		std::vector<AssetHandle> dependencies;
+		for (auto entity : entities)
+		{
+			if (auto meshComponent = entity["MeshComponent"])
+				dependencies.push_back(GetAssetHandle(meshComponent, "AssetPath", "AssetID"));
 
-		YAML::Node data = YAML::Load(strStream.str());
+			if (auto skyLightComponent = entity["SkyLightComponent"])
+				dependencies.push_back(GetAssetHandle(skyLightComponent, "EnvironmentAssetPath", "EnvironmentMap"));
+
+			auto meshColliderComponent = entity["MeshColliderComponent"];
+			if (meshColliderComponent && meshColliderComponent["OverrideMesh"] && meshColliderComponent["OverrideMesh"].as<bool>())
+				dependencies.push_back(GetAssetHandle(meshColliderComponent, "AssetPath", "AssetID"));
+
+			for (const char* collider : { "BoxColliderComponent", "SphereColliderComponent", "CapsuleColliderComponent", "MeshColliderComponent" })
+			{
+				auto colliderComponent = entity[collider];
+				if (colliderComponent && colliderComponent["Material"])
+					dependencies.push_back(colliderComponent["Material"].as<uint64_t>());
+			}
+		}
+
+		// Handles that don't resolve are reported when the entity using them is deserialized
+		dependencies.erase(std::remove_if(dependencies.begin(), dependencies.end(), [](AssetHandle handle) { return !AssetManager::IsAssetHandleValid(handle); }), dependencies.end());
+		return dependencies;
+	}
+
+	bool SceneSerializer::Deserialize(const std::string& filepath, const PreloadProgressFn& progressCallback)
+	{
+		Timer timer;
+
+		FileView file;
+		bool found = VirtualFileSystem::ReadFile(filepath, file);
+		HZ_CORE_ASSERT(found);
+
+		YAML::Node data = YAML::Load(std::string(file.GetString()));
 		if (!data["Scene"])
 			return false;
 
@@ -579,6 +622,15 @@ namespace Hazel {
 		HZ_CORE_INFO("Deserializing scene '{0}'", sceneName);
 
 		auto entities = data["Entities"];
+		if (entities && s_PreloadAssets)
+		{
+			std::vector<AssetHandle> dependencies = CollectAssetDependencies(entities);
+			if (!AssetManager::PreloadAssets(dependencies, progressCallback))
+				HZ_CORE_WARN("Some of the assets scene '{0}' depends on failed to load", sceneName);
+
+			HZ_CORE_INFO("Preloaded {0} assets for scene '{1}' in {2}ms", dependencies.size(), sceneName, timer.ElapsedMillis());
+		}
+
 		if (entities)
 		{
 			for (auto entity : entities)
@@ -1019,6 +1071,7 @@ namespace Hazel {
 			}
 		}
 
+		HZ_CORE_INFO("Deserialized scene '{0}' in {1}ms", sceneName, timer.ElapsedMillis());
 		return true;
 	}
 
@@ -6,16 +6,26 @@ namespace Hazel {
 
 	class SceneSerializer
 	{
+	public:
+		using PreloadProgressFn = std::function<void(uint32_t loadedCount, uint32_t totalCount)>;
 	public:
 		SceneSerializer(const Ref<Scene>& scene);
 
 		void Serialize(const std::string& filepath);
 		void SerializeRuntime(const std::string& filepath);
 
-		bool Deserialize(const std::string& filepath);
+		// Progress of loading the scene's assets is reported through progressCallback while they are preloaded
+		bool Deserialize(const std::string& filepath, const PreloadProgressFn& progressCallback = nullptr);
 		bool DeserializeRuntime(const std::string& filepath);
+
+		// When enabled (the default), every asset a scene references is loaded concurrently before its
+		// entities are created, instead of one at a time as each entity is deserialized
+		static void SetPreloadAssets(bool enabled) { s_PreloadAssets = enabled; }
+		static bool IsPreloadingAssets() { return s_PreloadAssets; }
 	private:
 		Ref<Scene> m_Scene;
+
+		static bool s_PreloadAssets;
 	};
 
 
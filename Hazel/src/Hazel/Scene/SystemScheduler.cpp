@@ -0,0 +1,215 @@
+#include "hzpch.h"
+#include "SystemScheduler.h"
+
+#include "Hazel/Core/JobSystem.h"
+#include "Hazel/Core/Timer.h"
+
+#include <imgui/imgui.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace Hazel {
+
+	void SystemScheduler::AddSystem(const std::string& name, const SystemAccess& access, SystemFunc func, bool mainThreadOnly)
+	{
+		m_Systems.push_back({ name, access, func, mainThreadOnly });
+		m_GraphDirty = true;
+	}
+
+	static bool Intersects(const std::vector<entt::id_type>& a, const std::vector<entt::id_type>& b)
+	{
+		for (entt::id_type id : a)
+		{
+			if (std::find(b.begin(), b.end(), id) != b.end())
+				return true;
+		}
+		return false;
+	}
+
+	bool SystemScheduler::Conflicts(const SystemAccess& a, const SystemAccess& b)
+	{
+		if (a.Exclusive || b.Exclusive)
+			return true;
+
+		return Intersects(a.Writes, b.Writes) || Intersects(a.Writes, b.Reads) || Intersects(a.Reads, b.Writes);
+	}
+
+	void SystemScheduler::BuildGraph()
+	{
+		uint32_t count = (uint32_t)m_Systems.size();
+		m_Dependents.assign(count, {});
+		m_DependencyCounts.assign(count, 0);
+
+		// A system waits for every earlier system it conflicts with
+		for (uint32_t i = 0; i < count; i++)
+		{
+			for (uint32_t j = 0; j < i; j++)
+			{
+				if (Conflicts(m_Systems[j].Access, m_Systems[i].Access))
+				{
+					m_Dependents[j].push_back(i);
+					m_DependencyCounts[i]++;
+				}
+			}
+		}
+
+		m_GraphDirty = false;
+	}
+
+	void SystemScheduler::Run(Timestep ts)
+	{
+		if (m_GraphDirty)
+			BuildGraph();
+
+		uint32_t count = (uint32_t)m_Systems.size();
+		m_Timings.resize(count);
+
+		std::vector<std::atomic<uint32_t>> remainingDependencies(count);
+		for (uint32_t i = 0; i < count; i++)
+			remainingDependencies[i] = m_DependencyCounts[i];
+
+		std::mutex mutex;
+		std::condition_variable condition;
+		std::deque<uint32_t> mainThreadQueue;
+		uint32_t completedCount = 0;
+		JobCounter workerJobs;
+
+		Timer frameTimer;
+
+		std::function<void(uint32_t)> schedule;
+		auto execute = [&](uint32_t index)
+		{
+			SystemTiming& timing = m_Timings[index];
+			timing.Name = m_Systems[index].Name;
+			timing.WorkerIndex = JobSystem::GetCurrentWorkerIndex();
+			timing.StartMillis = frameTimer.ElapsedMillis();
+			m_Systems[index].Func(ts);
+			timing.DurationMillis = frameTimer.ElapsedMillis() - timing.StartMillis;
+
+			for (uint32_t dependent : m_Dependents[index])
+			{
+				if (--remainingDependencies[dependent] == 0)
+					schedule(dependent);
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				completedCount++;
+			}
+			condition.notify_one();
+		};
+
+		schedule = [&](uint32_t index)
+		{
+			if (m_Systems[index].MainThreadOnly)
+			{
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					mainThreadQueue.push_back(index);
+				}
+				condition.notify_one();
+			}
+			else
+			{
+				JobSystem::Submit([&execute, index]() { execute(index); }, &workerJobs);
+			}
+		};
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (m_DependencyCounts[i] == 0)
+				schedule(i);
+		}
+
+		// The calling (main) thread runs main thread systems as they become ready
+		while (true)
+		{
+			uint32_t index;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				condition.wait(lock, [&]() { return !mainThreadQueue.empty() || completedCount == count; });
+				if (mainThreadQueue.empty())
+					break;
+
+				index = mainThreadQueue.front();
+				mainThreadQueue.pop_front();
+			}
+			execute(index);
+		}
+
+		// Make sure no worker is still touching this stack frame
+		JobSystem::Wait(workerJobs);
+
+		m_FrameMillis = frameTimer.ElapsedMillis();
+
+		// Critical path: the chain of dependencies with the largest total duration.
+		// Dependencies always have a lower index, so one forward pass is enough.
+		std::vector<float> pathMillis(count, 0.0f);
+		std::vector<int32_t> pathPrevious(count, -1);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			pathMillis[i] += m_Timings[i].DurationMillis;
+			m_Timings[i].OnCriticalPath = false;
+			for (uint32_t dependent : m_Dependents[i])
+			{
+				if (pathMillis[i] > pathMillis[dependent])
+				{
+					pathMillis[dependent] = pathMillis[i];
+					pathPrevious[dependent] = (int32_t)i;
+				}
+			}
+		}
+
+		m_CriticalPathMillis = 0.0f;
+		int32_t last = -1;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (pathMillis[i] >= m_CriticalPathMillis)
+			{
+				m_CriticalPathMillis = pathMillis[i];
+				last = (int32_t)i;
+			}
+		}
+
+		for (int32_t i = last; i >= 0; i = pathPrevious[i])
+			m_Timings[i].OnCriticalPath = true;
+	}
+
+	void SystemScheduler::OnImGuiRender()
+	{
+		ImGui::Begin("Scene Systems");
+		ImGui::Text("Update: %.3fms (critical path %.3fms)", m_FrameMillis, m_CriticalPathMillis);
+		ImGui::Separator();
+
+		ImGui::Columns(4);
+		ImGui::Text("System"); ImGui::NextColumn();
+		ImGui::Text("Thread"); ImGui::NextColumn();
+		ImGui::Text("Start"); ImGui::NextColumn();
+		ImGui::Text("Duration"); ImGui::NextColumn();
+		ImGui::Separator();
+
+		for (const auto& timing : m_Timings)
+		{
+			if (timing.OnCriticalPath)
+				ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "%s", timing.Name.c_str());
+			else
+				ImGui::Text("%s", timing.Name.c_str());
+			ImGui::NextColumn();
+
+			if (timing.WorkerIndex < 0)
+				ImGui::Text("Main");
+			else
+				ImGui::Text("Worker %d", timing.WorkerIndex);
+			ImGui::NextColumn();
+
+			ImGui::Text("%.3fms", timing.StartMillis); ImGui::NextColumn();
+			ImGui::Text("%.3fms", timing.DurationMillis); ImGui::NextColumn();
+		}
+
+		ImGui::Columns(1);
+		ImGui::End();
+	}
+
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Hazel/Core/Timestep.h"
+
+#include "entt/entt.hpp"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Hazel {
+
+	// Components a system reads and writes. Two systems conflict if either one writes something
+	// the other reads or writes; conflicting systems run in the order they were added.
+	struct SystemAccess
+	{
+		std::vector<entt::id_type> Reads;
+		std::vector<entt::id_type> Writes;
+
+		// For systems that can touch anything, e.g. everything that calls into scripts
+		bool Exclusive = false;
+
+		template<typename... T>
+		SystemAccess& Read() { (Reads.push_back(entt::type_info<T>::id()), ...); return *this; }
+
+		template<typename... T>
+		SystemAccess& Write() { (Writes.push_back(entt::type_info<T>::id()), ...); return *this; }
+
+		static SystemAccess All() { SystemAccess access; access.Exclusive = true; return access; }
+	};
+
+	struct SystemTiming
+	{
+		std::string Name;
+		float StartMillis = 0.0f;
+		float DurationMillis = 0.0f;
+		int32_t WorkerIndex = -1; // -1 is the main thread
+		bool OnCriticalPath = false;
+	};
+
+	class SystemScheduler
+	{
+	public:
+		using SystemFunc = std::function<void(Timestep)>;
+
+		// Main thread systems are needed for anything that calls into Mono or non thread-safe libraries
+		void AddSystem(const std::string& name, const SystemAccess& access, SystemFunc func, bool mainThreadOnly = false);
+
+		// Runs every system once, in parallel where their component access allows it. Blocks until all are done.
+		void Run(Timestep ts);
+
+		const std::vector<SystemTiming>& GetTimings() const { return m_Timings; }
+		float GetCriticalPathMillis() const { return m_CriticalPathMillis; }
+		float GetFrameMillis() const { return m_FrameMillis; }
+
+		void OnImGuiRender();
+	private:
+		struct System
+		{
+			std::string Name;
+			SystemAccess Access;
+			SystemFunc Func;
+			bool MainThreadOnly = false;
+		};
+
+		static bool Conflicts(const SystemAccess& a, const SystemAccess& b);
+		void BuildGraph();
+	private:
+		std::vector<System> m_Systems;
+
+		// Indices of the systems that have to wait for each system, and how many each one waits for
+		std::vector<std::vector<uint32_t>> m_Dependents;
+		std::vector<uint32_t> m_DependencyCounts;
+		bool m_GraphDirty = true;
+
+		std::vector<SystemTiming> m_Timings;
+		float m_CriticalPathMillis = 0.0f;
+		float m_FrameMillis = 0.0f;
+	};
+
+}
@@ -61,6 +61,11 @@ namespace Hazel {
 		mono_add_internal_call("Hazel.Entity::CreateComponent_Native", Hazel::Script::Hazel_Entity_CreateComponent);
 		mono_add_internal_call("Hazel.Entity::HasComponent_Native", Hazel::Script::Hazel_Entity_HasComponent);
 		mono_add_internal_call("Hazel.Entity::FindEntityByTag_Native", Hazel::Script::Hazel_Entity_FindEntityByTag);
+		mono_add_internal_call("Hazel.Entity::GetTagHandle_Native", Hazel::Script::Hazel_Entity_GetTagHandle);
+		mono_add_internal_call("Hazel.Entity::FindEntityByTagHandle_Native", Hazel::Script::Hazel_Entity_FindEntityByTagHandle);
+
+		mono_add_internal_call("Hazel.TagComponent::GetTag_Native", Hazel::Script::Hazel_TagComponent_GetTag);
+		mono_add_internal_call("Hazel.TagComponent::SetTag_Native", Hazel::Script::Hazel_TagComponent_SetTag);
 
 		mono_add_internal_call("Hazel.TransformComponent::GetTransform_Native", Hazel::Script::Hazel_TransformComponent_GetTransform);
 		mono_add_internal_call("Hazel.TransformComponent::SetTransform_Native", Hazel::Script::Hazel_TransformComponent_SetTransform);
@@ -279,14 +279,60 @@ namespace Hazel { namespace Script {
 		Ref<Scene> scene = ScriptEngine::GetCurrentSceneContext();
 		HZ_CORE_ASSERT(scene, "No active scene!");
 
-		Entity entity = scene->FindEntityByTag(mono_string_to_utf8(tag));
+		char* tagString = mono_string_to_utf8(tag);
+		Entity entity = scene->FindEntityByTag(tagString);
+		mono_free(tagString);
 		if (entity)
 			return entity.GetComponent<IDComponent>().ID;
 		
 		return 0;
 	}
 
-	void Hazel_TransformComponent_GetTransform(uint64_t entityID, TransformComponent* outTransform)
+	uint64_t Hazel_Entity_GetTagHandle(MonoString* tag)
+	{
+		char* tagString = mono_string_to_utf8(tag);
+		uint64_t tagHandle = Scene::GetTagHash(tagString);
+		mono_free(tagString);
+		return tagHandle;
+	}
+
+	uint64_t Hazel_Entity_FindEntityByTagHandle(uint64_t tagHandle)
+	{
+		Ref<Scene> scene = ScriptEngine::GetCurrentSceneContext();
+		HZ_CORE_ASSERT(scene, "No active scene!");
+
+		Entity entity = scene->FindEntityByTagHash(tagHandle);
+		if (entity)
+			return entity.GetComponent<IDComponent>().ID;
+
+		return 0;
+	}
+
+	MonoString* Hazel_TagComponent_GetTag(uint64_t entityID)
+	{
+		Ref<Scene> scene = ScriptEngine::GetCurrentSceneContext();
+		HZ_CORE_ASSERT(scene, "No active scene!");
+		const auto& entityMap = scene->GetEntityMap();
+		HZ_CORE_ASSERT(entityMap.find(entityID) != entityMap.end(), "Invalid entity ID or entity doesn't exist in scene!");
+
+		Entity entity = entityMap.at(entityID);
+		return mono_string_new(mono_domain_get(), entity.GetComponent<TagComponent>().Tag.c_str());
+	}
+
+	void Hazel_TagComponent_SetTag(uint64_t entityID, MonoString* tag)
+	{
+		Ref<Scene> scene = ScriptEngine::GetCurrentSceneContext();
+		HZ_CORE_ASSERT(scene, "No active scene!");
+		const auto& entityMap = scene->GetEntityMap();
+		HZ_CORE_ASSERT(entityMap.find(entityID) != entityMap.end(), "Invalid entity ID or entity doesn't exist in scene!");
+
+		Entity entity = entityMap.at(entityID);
+		char* tagString = mono_string_to_utf8(tag);
+		scene->SetEntityTag(entity, tagString);
+		mono_free(tagString);
+	}
+
+	void Hazel_TransformComponent_GetTransform(uint64_t entityID, ScriptTransform* outTransform)
 	{
 		Ref<Scene> scene = ScriptEngine::GetCurrentSceneContext();
 		HZ_CORE_ASSERT(scene, "No active scene!");
@@ -294,10 +340,19 @@ namespace Hazel { namespace Script {
 		HZ_CORE_ASSERT(entityMap.find(entityID) != entityMap.end(), "Invalid entity ID or entity doesn't exist in scene!");
 
 		Entity entity = entityMap.at(entityID);
-		*outTransform = entity.GetComponent<TransformComponent>();
+		const auto& transform = entity.GetComponent<TransformComponent>();
+		outTransform->Translation = transform.Translation;
+		outTransform->Rotation = transform.Rotation;
+		outTransform->Scale = transform.Scale;
+
+		// Directions come from the cached world transform
+		const auto& worldTransform = entity.GetComponent<WorldTransformComponent>();
+		outTransform->Up = worldTransform.Up;
+		outTransform->Right = worldTransform.Right;
+		outTransform->Forward = worldTransform.Forward;
 	}
 
-	void Hazel_TransformComponent_SetTransform(uint64_t entityID, TransformComponent* inTransform)
+	void Hazel_TransformComponent_SetTransform(uint64_t entityID, ScriptTransform* inTransform)
 	{
 		Ref<Scene> scene = ScriptEngine::GetCurrentSceneContext();
 		HZ_CORE_ASSERT(scene, "No active scene!");
@@ -305,7 +360,10 @@ namespace Hazel { namespace Script {
 		HZ_CORE_ASSERT(entityMap.find(entityID) != entityMap.end(), "Invalid entity ID or entity doesn't exist in scene!");
 
 		Entity entity = entityMap.at(entityID);
-		entity.GetComponent<TransformComponent>() = *inTransform;
+		auto& transform = entity.GetComponent<TransformComponent>();
+		transform.Translation = inTransform->Translation;
+		transform.Rotation = inTransform->Rotation;
+		transform.Scale = inTransform->Scale;
 	}
 
 	void Hazel_TransformComponent_GetTranslation(uint64_t entityID, glm::vec3* outTranslation)
@@ -13,6 +13,18 @@ extern "C" {
 
 namespace Hazel { namespace Script {
 
+	// Matches the layout of Hazel.Transform in Hazel-ScriptCore
+	struct ScriptTransform
+	{
+		glm::vec3 Translation;
+		glm::vec3 Rotation;
+		glm::vec3 Scale;
+
+		glm::vec3 Up;
+		glm::vec3 Right;
+		glm::vec3 Forward;
+	};
+
 	// Math
 	float Hazel_Noise_PerlinNoise(float x, float y);
 
@@ -36,9 +48,14 @@ namespace Hazel { namespace Script {
 	void Hazel_Entity_CreateComponent(uint64_t entityID, void* type);
 	bool Hazel_Entity_HasComponent(uint64_t entityID, void* type);
 	uint64_t Hazel_Entity_FindEntityByTag(MonoString* tag);
+	uint64_t Hazel_Entity_GetTagHandle(MonoString* tag);
+	uint64_t Hazel_Entity_FindEntityByTagHandle(uint64_t tagHandle);
+
+	MonoString* Hazel_TagComponent_GetTag(uint64_t entityID);
+	void Hazel_TagComponent_SetTag(uint64_t entityID, MonoString* tag);
 
-	void Hazel_TransformComponent_GetTransform(uint64_t entityID, TransformComponent* outTransform);
-	void Hazel_TransformComponent_SetTransform(uint64_t entityID, TransformComponent* inTransform);
+	void Hazel_TransformComponent_GetTransform(uint64_t entityID, ScriptTransform* outTransform);
+	void Hazel_TransformComponent_SetTransform(uint64_t entityID, ScriptTransform* inTransform);
 	void Hazel_TransformComponent_GetTranslation(uint64_t entityID, glm::vec3* outTranslation);
 	void Hazel_TransformComponent_SetTranslation(uint64_t entityID, glm::vec3* inTranslation);
 	void Hazel_TransformComponent_GetRotation(uint64_t entityID, glm::vec3* outRotation);
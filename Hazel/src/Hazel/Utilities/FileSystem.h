@@ -18,6 +18,16 @@ namespace Hazel {
 		bool IsDirectory;
 	};
 
+	// Read-only view of a whole file, see FileSystem::MapFile
+	struct MappedFile
+	{
+		const uint8_t* Data = nullptr;
+		uint64_t Size = 0;
+
+		void* FileHandle = nullptr;
+		void* MappingHandle = nullptr;
+	};
+
 	class FileSystem
 	{
 	public:
@@ -27,6 +37,10 @@ namespace Hazel {
 		static bool DeleteFile(const std::string& filepath);
 		static bool MoveFile(const std::string& filepath, const std::string& dest);
 
+		// Maps the file into memory instead of reading it, returns false for missing or empty files
+		static bool MapFile(const std::string& filepath, MappedFile& outFile);
+		static void UnmapFile(MappedFile& file);
+
 	public:
 		using FileSystemChangedCallbackFn = std::function<void(FileSystemChangedEvent)>;
 
@@ -0,0 +1,447 @@
+#include "hzpch.h"
+#include "PakArchive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+namespace Hazel {
+
+	static constexpr char s_PakMagic[4] = { 'H', 'P', 'A', 'K' };
+	static constexpr uint32_t s_PakVersion = 1;
+
+	struct PakHeader
+	{
+		char Magic[4];
+		uint32_t Version;
+		uint32_t EntryCount;
+		uint32_t Reserved;
+		uint64_t TocOffset;
+		uint64_t TocSize; // Entries and path strings
+	};
+
+	static_assert(sizeof(PakHeader) == 32, "PakHeader layout is part of the file format");
+	static_assert(sizeof(PakEntry) == 32, "PakEntry layout is part of the file format");
+
+	//////////////////////////////////////////////////////////////////////////////////
+	// LZ4 block format
+	//////////////////////////////////////////////////////////////////////////////////
+
+	namespace LZ4 {
+
+		static constexpr size_t MinMatch = 4;
+		static constexpr size_t LastLiterals = 5; // The last bytes of a block are always literals
+		static constexpr size_t MatchFindLimit = 12; // No match can start this close to the end
+		static constexpr size_t MaxOffset = 65535;
+		static constexpr uint32_t HashBits = 16;
+
+		static size_t CompressBound(size_t size)
+		{
+			return size + size / 255 + 16;
+		}
+
+		static uint32_t Read32(const uint8_t* data)
+		{
+			uint32_t value;
+			memcpy(&value, data, sizeof(value));
+			return value;
+		}
+
+		static uint8_t* WriteLength(uint8_t* out, size_t length)
+		{
+			while (length >= 255)
+			{
+				*out++ = 255;
+				length -= 255;
+			}
+			*out++ = (uint8_t)length;
+			return out;
+		}
+
+		static uint8_t* WriteLiterals(uint8_t* out, uint8_t* token, const uint8_t* literals, size_t length)
+		{
+			if (length >= 15)
+			{
+				*token = 15 << 4;
+				out = WriteLength(out, length - 15);
+			}
+			else
+			{
+				*token = (uint8_t)(length << 4);
+			}
+
+			memcpy(out, literals, length);
+			return out + length;
+		}
+
+		// Greedy single probe compressor, output has to hold CompressBound(size) bytes
+		static size_t Compress(const uint8_t* source, size_t size, uint8_t* output)
+		{
+			std::vector<uint32_t> table((size_t)1 << HashBits, 0);
+
+			uint8_t* out = output;
+			size_t anchor = 0;
+
+			if (size > MatchFindLimit)
+			{
+				const size_t matchLimit = size - LastLiterals;
+				const size_t searchLimit = size - MatchFindLimit;
+
+				size_t position = 0;
+				while (position < searchLimit)
+				{
+					uint32_t sequence = Read32(source + position);
+					uint32_t hash = (sequence * 2654435761u) >> (32 - HashBits);
+					size_t candidate = table[hash];
+					table[hash] = (uint32_t)position;
+
+					if (candidate >= position || position - candidate > MaxOffset || Read32(source + candidate) != sequence)
+					{
+						position++;
+						continue;
+					}
+
+					size_t matchLength = MinMatch;
+					while (position + matchLength < matchLimit && source[candidate + matchLength] == source[position + matchLength])
+						matchLength++;
+
+					uint8_t* token = out++;
+					out = WriteLiterals(out, token, source + anchor, position - anchor);
+
+					uint16_t offset = (uint16_t)(position - candidate);
+					*out++ = (uint8_t)(offset & 0xff);
+					*out++ = (uint8_t)(offset >> 8);
+
+					size_t length = matchLength - MinMatch;
+					if (length >= 15)
+					{
+						*token |= 15;
+						out = WriteLength(out, length - 15);
+					}
+					else
+					{
+						*token |= (uint8_t)length;
+					}
+
+					position += matchLength;
+					anchor = position;
+				}
+			}
+
+			uint8_t* token = out++;
+			out = WriteLiterals(out, token, source + anchor, size - anchor);
+			return out - output;
+		}
+
+		static bool ReadLength(const uint8_t*& in, const uint8_t* inEnd, size_t& length)
+		{
+			uint8_t value;
+			do
+			{
+				if (in >= inEnd)
+					return false;
+				value = *in++;
+				length += value;
+			} while (value == 255);
+			return true;
+		}
+
+		// Validates every length and offset, a corrupt archive fails instead of reading or writing out of bounds
+		static bool Decompress(const uint8_t* source, size_t size, uint8_t* output, size_t outputSize)
+		{
+			const uint8_t* in = source;
+			const uint8_t* inEnd = source + size;
+			uint8_t* out = output;
+			uint8_t* outEnd = output + outputSize;
+
+			while (in < inEnd)
+			{
+				uint8_t token = *in++;
+
+				size_t literalLength = token >> 4;
+				if (literalLength == 15 && !ReadLength(in, inEnd, literalLength))
+					return false;
+
+				if (literalLength > (size_t)(inEnd - in) || literalLength > (size_t)(outEnd - out))
+					return false;
+
+				memcpy(out, in, literalLength);
+				in += literalLength;
+				out += literalLength;
+
+				// The last sequence has no match
+				if (in == inEnd)
+					break;
+
+				if (inEnd - in < 2)
+					return false;
+
+				size_t offset = (size_t)in[0] | ((size_t)in[1] << 8);
+				in += 2;
+				if (offset == 0 || offset > (size_t)(out - output))
+					return false;
+
+				size_t matchLength = token & 15;
+				if (matchLength == 15 && !ReadLength(in, inEnd, matchLength))
+					return false;
+				matchLength += MinMatch;
+
+				if (matchLength > (size_t)(outEnd - out))
+					return false;
+
+				// Matches may overlap the bytes they produce, e.g. runs
+				const uint8_t* match = out - offset;
+				if (offset >= matchLength)
+				{
+					memcpy(out, match, matchLength);
+				}
+				else
+				{
+					for (size_t i = 0; i < matchLength; i++)
+						out[i] = match[i];
+				}
+				out += matchLength;
+			}
+
+			return out == outEnd;
+		}
+
+	}
+
+	//////////////////////////////////////////////////////////////////////////////////
+	// PakArchive
+	//////////////////////////////////////////////////////////////////////////////////
+
+	std::string PakArchive::NormalizePath(const std::string& filepath)
+	{
+		// Paths built from a mesh's directory and a relative texture path often contain ".." segments
+		std::string result = filepath;
+		std::replace(result.begin(), result.end(), '\\', '/');
+		result = std::filesystem::path(result).lexically_normal().generic_string();
+		while (result.size() > 1 && result.back() == '/')
+			result.pop_back();
+		return result == "." ? std::string() : result;
+	}
+
+	Ref<PakArchive> PakArchive::Open(const std::string& filepath)
+	{
+		Ref<PakArchive> archive = Ref<PakArchive>::Create();
+		archive->m_FilePath = filepath;
+
+		MappedFile& file = archive->m_File;
+		if (!FileSystem::MapFile(filepath, file))
+			return nullptr;
+
+		PakHeader header;
+		if (file.Size < sizeof(header))
+		{
+			HZ_CORE_ERROR("Invalid pak archive: {0}", filepath);
+			return nullptr;
+		}
+
+		memcpy(&header, file.Data, sizeof(header));
+		if (memcmp(header.Magic, s_PakMagic, sizeof(s_PakMagic)) != 0 || header.Version != s_PakVersion)
+		{
+			HZ_CORE_ERROR("Invalid or outdated pak archive: {0}", filepath);
+			return nullptr;
+		}
+
+		uint64_t entriesSize = (uint64_t)header.EntryCount * sizeof(PakEntry);
+		if (header.TocOffset % alignof(PakEntry) != 0 || header.TocOffset > file.Size || header.TocSize > file.Size - header.TocOffset || entriesSize > header.TocSize)
+		{
+			HZ_CORE_ERROR("Pak archive has an invalid table of contents: {0}", filepath);
+			return nullptr;
+		}
+
+		archive->m_Entries = (const PakEntry*)(file.Data + header.TocOffset);
+		archive->m_EntryCount = header.EntryCount;
+		archive->m_PathStrings = (const char*)(file.Data + header.TocOffset + entriesSize);
+		archive->m_PathStringsSize = header.TocSize - entriesSize;
+
+		// Checked once here so reads don't have to
+		for (uint32_t i = 0; i < archive->m_EntryCount; i++)
+		{
+			const PakEntry& entry = archive->m_Entries[i];
+			bool valid = entry.Offset <= file.Size && entry.Size <= file.Size - entry.Offset
+				&& (uint64_t)entry.PathOffset + entry.PathLength <= archive->m_PathStringsSize
+				&& (entry.Compression == PakCompression::None ? entry.Size == entry.UncompressedSize : entry.Compression == PakCompression::LZ4);
+
+			if (!valid)
+			{
+				HZ_CORE_ERROR("Pak archive has an invalid entry: {0}", filepath);
+				return nullptr;
+			}
+		}
+
+		HZ_CORE_INFO("Opened pak archive {0} ({1} files)", filepath, archive->m_EntryCount);
+		return archive;
+	}
+
+	PakArchive::~PakArchive()
+	{
+		FileSystem::UnmapFile(m_File);
+	}
+
+	const PakEntry* PakArchive::FindEntry(std::string_view path) const
+	{
+		const PakEntry* end = m_Entries + m_EntryCount;
+		const PakEntry* it = std::lower_bound(m_Entries, end, path, [this](const PakEntry& entry, std::string_view value)
+		{
+			return GetEntryPath(entry) < value;
+		});
+
+		if (it == end || GetEntryPath(*it) != path)
+			return nullptr;
+
+		return it;
+	}
+
+	std::string_view PakArchive::GetEntryPath(const PakEntry& entry) const
+	{
+		return std::string_view(m_PathStrings + entry.PathOffset, entry.PathLength);
+	}
+
+	bool PakArchive::ReadEntry(const PakEntry& entry, const uint8_t*& outData, std::vector<uint8_t>& decompressedData) const
+	{
+		const uint8_t* data = m_File.Data + entry.Offset;
+		if (entry.Compression == PakCompression::None)
+		{
+			outData = data;
+			return true;
+		}
+
+		decompressedData.resize(entry.UncompressedSize);
+		if (!LZ4::Decompress(data, entry.Size, decompressedData.data(), decompressedData.size()))
+		{
+			HZ_CORE_ERROR("Failed to decompress {0} from {1}", GetEntryPath(entry), m_FilePath);
+			decompressedData.clear();
+			return false;
+		}
+
+		outData = decompressedData.data();
+		return true;
+	}
+
+	bool PakArchive::Write(const std::string& filepath, const std::vector<std::string>& files, const PakWriteOptions& options)
+	{
+		HZ_CORE_ASSERT(options.Alignment > 0 && (options.Alignment & (options.Alignment - 1)) == 0, "Pak alignment has to be a power of two!");
+
+		std::vector<std::string> paths;
+		paths.reserve(files.size());
+		for (const std::string& file : files)
+			paths.push_back(NormalizePath(file));
+		std::sort(paths.begin(), paths.end());
+		paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+
+		// Written next to the destination and renamed once complete, a failed build leaves the old archive intact
+		std::string tempPath = filepath + ".tmp";
+		std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+		if (!stream)
+		{
+			HZ_CORE_ERROR("Failed to create pak archive {0}", filepath);
+			return false;
+		}
+
+		PakHeader header = {};
+		stream.write((const char*)&header, sizeof(header));
+
+		std::vector<PakEntry> entries;
+		std::string pathStrings;
+		entries.reserve(paths.size());
+
+		std::vector<uint8_t> compressed;
+		uint64_t offset = sizeof(header);
+		uint64_t totalUncompressed = 0;
+		static const char padding[4096] = {};
+
+		for (const std::string& path : paths)
+		{
+			if (path.size() > std::numeric_limits<uint16_t>::max())
+			{
+				HZ_CORE_ERROR("Path too long for a pak archive: {0}", path);
+				continue;
+			}
+
+			MappedFile file;
+			bool mapped = FileSystem::MapFile(path, file);
+			if (!mapped && !FileSystem::Exists(path))
+			{
+				HZ_CORE_ERROR("Failed to read {0} while writing pak archive", path);
+				continue;
+			}
+
+			PakEntry entry = {};
+			entry.UncompressedSize = file.Size;
+			entry.PathOffset = (uint32_t)pathStrings.size();
+			entry.PathLength = (uint16_t)path.size();
+			entry.Compression = PakCompression::None;
+
+			const uint8_t* data = file.Data;
+			uint64_t size = file.Size;
+			if (options.Compress && size > 0 && size <= std::numeric_limits<uint32_t>::max())
+			{
+				compressed.resize(LZ4::CompressBound(size));
+				size_t compressedSize = LZ4::Compress(file.Data, size, compressed.data());
+				if ((float)compressedSize <= (float)size * (1.0f - options.MinCompressionSavings))
+				{
+					entry.Compression = PakCompression::LZ4;
+					data = compressed.data();
+					size = compressedSize;
+				}
+			}
+
+			uint64_t alignedOffset = (offset + options.Alignment - 1) & ~(uint64_t)(options.Alignment - 1);
+			for (uint64_t paddingSize = alignedOffset - offset; paddingSize > 0; )
+			{
+				uint64_t chunk = std::min<uint64_t>(paddingSize, sizeof(padding));
+				stream.write(padding, chunk);
+				paddingSize -= chunk;
+			}
+
+			entry.Offset = alignedOffset;
+			entry.Size = size;
+			if (size > 0)
+				stream.write((const char*)data, size);
+			offset = alignedOffset + size;
+			totalUncompressed += entry.UncompressedSize;
+
+			if (mapped)
+				FileSystem::UnmapFile(file);
+
+			entries.push_back(entry);
+			pathStrings += path;
+		}
+
+		uint64_t tocOffset = (offset + alignof(PakEntry) - 1) & ~(uint64_t)(alignof(PakEntry) - 1);
+		stream.write(padding, tocOffset - offset);
+		stream.write((const char*)entries.data(), entries.size() * sizeof(PakEntry));
+		stream.write(pathStrings.data(), pathStrings.size());
+
+		memcpy(header.Magic, s_PakMagic, sizeof(s_PakMagic));
+		header.Version = s_PakVersion;
+		header.EntryCount = (uint32_t)entries.size();
+		header.TocOffset = tocOffset;
+		header.TocSize = entries.size() * sizeof(PakEntry) + pathStrings.size();
+		stream.seekp(0);
+		stream.write((const char*)&header, sizeof(header));
+
+		bool success = (bool)stream;
+		stream.close();
+
+		std::error_code error;
+		if (success)
+			std::filesystem::rename(tempPath, filepath, error);
+
+		if (!success || error)
+		{
+			HZ_CORE_ERROR("Failed to write pak archive {0}", filepath);
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+
+		uint64_t totalSize = tocOffset + header.TocSize;
+		HZ_CORE_INFO("Wrote pak archive {0}: {1} files, {2:.2f} MB ({3:.2f} MB uncompressed)", filepath, entries.size(), totalSize / (1024.0 * 1024.0), totalUncompressed / (1024.0 * 1024.0));
+		return true;
+	}
+
+}
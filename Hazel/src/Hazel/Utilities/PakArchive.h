@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Hazel/Utilities/FileSystem.h"
+
+#include <string_view>
+
+namespace Hazel {
+
+	// Stored in the archive, values can't change
+	enum class PakCompression : uint8_t
+	{
+		None = 0,
+		LZ4 = 1 // LZ4 block format
+	};
+
+	// One file in the table of contents. Offsets are from the start of the archive.
+	struct PakEntry
+	{
+		uint64_t Offset;
+		uint64_t Size;             // Stored size
+		uint64_t UncompressedSize;
+		uint32_t PathOffset;       // Into the path strings following the table of contents
+		uint16_t PathLength;
+		PakCompression Compression;
+		uint8_t Reserved;
+	};
+
+	struct PakWriteOptions
+	{
+		uint32_t Alignment = 64; // Of every entry's data, a power of two
+		bool Compress = true;
+		// Entries are stored uncompressed unless compression saves at least this much, so they can be read in place
+		float MinCompressionSavings = 0.1f;
+	};
+
+	// Read-only archive of many files in one. The archive is memory mapped, uncompressed entries are read
+	// straight from the mapping. The table of contents is sorted by path so lookups are a binary search.
+	//
+	// Layout: header, entry data (each entry aligned), table of contents (PakEntry array), path strings
+	class PakArchive : public RefCounted
+	{
+	public:
+		// nullptr if the file is missing or isn't a valid archive
+		static Ref<PakArchive> Open(const std::string& filepath);
+
+		// Packs files (paths as the engine refers to them, e.g. "assets/meshes/Cube.fbx") into a new archive
+		static bool Write(const std::string& filepath, const std::vector<std::string>& files, const PakWriteOptions& options = PakWriteOptions());
+
+		// Lexically normal with forward slashes ("." and ".." resolved, no trailing slash); entries are stored and looked up by these paths
+		static std::string NormalizePath(const std::string& filepath);
+
+		PakArchive() = default;
+		~PakArchive();
+
+		const PakEntry* FindEntry(std::string_view path) const;
+		std::string_view GetEntryPath(const PakEntry& entry) const;
+
+		// Uncompressed entries point outData into the mapping, compressed ones are decoded into decompressedData
+		bool ReadEntry(const PakEntry& entry, const uint8_t*& outData, std::vector<uint8_t>& decompressedData) const;
+
+		// Sorted by path
+		const PakEntry* GetEntries() const { return m_Entries; }
+		uint32_t GetEntryCount() const { return m_EntryCount; }
+
+		const std::string& GetFilePath() const { return m_FilePath; }
+	private:
+		std::string m_FilePath;
+		MappedFile m_File;
+
+		const PakEntry* m_Entries = nullptr;
+		uint32_t m_EntryCount = 0;
+		const char* m_PathStrings = nullptr;
+		uint64_t m_PathStringsSize = 0;
+	};
+
+}
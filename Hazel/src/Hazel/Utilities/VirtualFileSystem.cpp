@@ -0,0 +1,172 @@
+#include "hzpch.h"
+#include "VirtualFileSystem.h"
+
+#include <mutex>
+#include <set>
+
+namespace Hazel {
+
+	//////////////////////////////////////////////////////////////////////////////////
+	// FileView
+	//////////////////////////////////////////////////////////////////////////////////
+
+	FileView::~FileView()
+	{
+		Release();
+	}
+
+	FileView::FileView(FileView&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	FileView& FileView::operator=(FileView&& other) noexcept
+	{
+		if (this == &other)
+			return *this;
+
+		Release();
+		m_Data = other.m_Data;
+		m_Size = other.m_Size;
+		m_MappedFile = other.m_MappedFile;
+		m_Archive = std::move(other.m_Archive);
+		m_Decompressed = std::move(other.m_Decompressed);
+
+		other.m_Data = nullptr;
+		other.m_Size = 0;
+		other.m_MappedFile = MappedFile();
+		return *this;
+	}
+
+	void FileView::Release()
+	{
+		if (m_MappedFile.Data)
+			FileSystem::UnmapFile(m_MappedFile);
+
+		m_Archive = nullptr;
+		m_Decompressed.clear();
+		m_Decompressed.shrink_to_fit();
+		m_Data = nullptr;
+		m_Size = 0;
+	}
+
+	//////////////////////////////////////////////////////////////////////////////////
+	// VirtualFileSystem
+	//////////////////////////////////////////////////////////////////////////////////
+
+	bool VirtualFileSystem::Mount(const std::string& pakPath)
+	{
+		Ref<PakArchive> archive = PakArchive::Open(pakPath);
+		if (!archive)
+			return false;
+
+		std::unique_lock<std::shared_mutex> lock(s_Mutex);
+		s_Archives.push_back(archive);
+		return true;
+	}
+
+	void VirtualFileSystem::UnmountAll()
+	{
+		std::unique_lock<std::shared_mutex> lock(s_Mutex);
+		s_Archives.clear();
+	}
+
+	bool VirtualFileSystem::HasMountedArchives()
+	{
+		std::shared_lock<std::shared_mutex> lock(s_Mutex);
+		return !s_Archives.empty();
+	}
+
+	bool VirtualFileSystem::Exists(const std::string& filepath)
+	{
+		return IsInArchive(filepath) || FileSystem::Exists(filepath);
+	}
+
+	bool VirtualFileSystem::IsInArchive(const std::string& filepath)
+	{
+		std::string path = PakArchive::NormalizePath(filepath);
+		std::shared_lock<std::shared_mutex> lock(s_Mutex);
+		for (auto& archive : s_Archives)
+		{
+			if (archive->FindEntry(path))
+				return true;
+		}
+		return false;
+	}
+
+	bool VirtualFileSystem::ReadFile(const std::string& filepath, FileView& outFile)
+	{
+		outFile.Release();
+
+		{
+			std::string path = PakArchive::NormalizePath(filepath);
+			std::shared_lock<std::shared_mutex> lock(s_Mutex);
+			for (auto it = s_Archives.rbegin(); it != s_Archives.rend(); it++)
+			{
+				const PakEntry* entry = (*it)->FindEntry(path);
+				if (!entry)
+					continue;
+
+				if (!(*it)->ReadEntry(*entry, outFile.m_Data, outFile.m_Decompressed))
+					return false;
+
+				outFile.m_Size = entry->UncompressedSize;
+				if (outFile.m_Decompressed.empty())
+					outFile.m_Archive = *it;
+				return true;
+			}
+		}
+
+		// Empty files can't be mapped, they are still valid (empty) files
+		if (FileSystem::MapFile(filepath, outFile.m_MappedFile))
+		{
+			outFile.m_Data = outFile.m_MappedFile.Data;
+			outFile.m_Size = outFile.m_MappedFile.Size;
+			return true;
+		}
+
+		return FileSystem::Exists(filepath);
+	}
+
+	bool VirtualFileSystem::GetDirectoryContents(const std::string& directory, std::vector<std::string>& outFiles, std::vector<std::string>& outDirectories)
+	{
+		std::string prefix = PakArchive::NormalizePath(directory) + "/";
+		std::set<std::string> files, directories;
+
+		std::shared_lock<std::shared_mutex> lock(s_Mutex);
+		for (auto& archive : s_Archives)
+		{
+			// Sorted by path, so everything inside the directory is one contiguous range
+			const PakEntry* begin = archive->GetEntries();
+			const PakEntry* end = begin + archive->GetEntryCount();
+			const PakEntry* it = std::lower_bound(begin, end, std::string_view(prefix), [&archive](const PakEntry& entry, std::string_view value)
+			{
+				return archive->GetEntryPath(entry) < value;
+			});
+
+			for (; it != end; it++)
+			{
+				std::string_view path = archive->GetEntryPath(*it);
+				if (path.compare(0, prefix.size(), prefix) != 0)
+					break;
+
+				size_t slash = path.find('/', prefix.size());
+				if (slash == std::string_view::npos)
+					files.emplace(path);
+				else
+					directories.emplace(path.substr(0, slash));
+			}
+		}
+
+		if (files.empty() && directories.empty())
+			return false;
+
+		outFiles.insert(outFiles.end(), files.begin(), files.end());
+		outDirectories.insert(outDirectories.end(), directories.begin(), directories.end());
+		return true;
+	}
+
+	std::vector<Ref<PakArchive>> VirtualFileSystem::s_Archives;
+	std::shared_mutex VirtualFileSystem::s_Mutex;
+
+}
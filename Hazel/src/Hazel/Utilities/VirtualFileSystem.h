@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Hazel/Utilities/PakArchive.h"
+
+#include <shared_mutex>
+#include <string_view>
+
+namespace Hazel {
+
+	// Contents of a file read through the VirtualFileSystem. Points straight into the mapped pak archive or
+	// loose file, only compressed pak entries are decoded into memory owned by the view. Move only.
+	class FileView
+	{
+	public:
+		FileView() = default;
+		~FileView();
+
+		FileView(FileView&& other) noexcept;
+		FileView& operator=(FileView&& other) noexcept;
+		FileView(const FileView&) = delete;
+		FileView& operator=(const FileView&) = delete;
+
+		const uint8_t* GetData() const { return m_Data; }
+		uint64_t GetSize() const { return m_Size; }
+		std::string_view GetString() const { return std::string_view((const char*)m_Data, (size_t)m_Size); }
+
+		void Release();
+	private:
+		const uint8_t* m_Data = nullptr;
+		uint64_t m_Size = 0;
+
+		MappedFile m_MappedFile;             // Loose files
+		Ref<PakArchive> m_Archive;           // Keeps the archive mapped while the view is alive
+		std::vector<uint8_t> m_Decompressed; // Compressed pak entries
+
+		friend class VirtualFileSystem;
+	};
+
+	// Read-only file access across the mounted pak archives and the loose files on disk. Archives mounted
+	// later take precedence, loose files are the fallback. Paths are the ones the engine uses
+	// everywhere else (e.g. "assets/textures/Checkerboard.tga").
+	// Reading is thread safe; mount archives before anything starts loading from them.
+	class VirtualFileSystem
+	{
+	public:
+		static bool Mount(const std::string& pakPath);
+		static void UnmountAll();
+		static bool HasMountedArchives();
+
+		static bool Exists(const std::string& filepath);
+		// True if a mounted archive contains the file, ReadFile then returns the archive's copy
+		static bool IsInArchive(const std::string& filepath);
+		static bool ReadFile(const std::string& filepath, FileView& outFile);
+
+		// Immediate children of a directory across the mounted archives, false if no archive contains it
+		static bool GetDirectoryContents(const std::string& directory, std::vector<std::string>& outFiles, std::vector<std::string>& outDirectories);
+	private:
+		static std::vector<Ref<PakArchive>> s_Archives;
+		static std::shared_mutex s_Mutex;
+	};
+
+}
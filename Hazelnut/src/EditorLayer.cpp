@@ -4,6 +4,7 @@
 #include "Hazel/Renderer/Renderer2D.h"
 #include "Hazel/Script/ScriptEngine.h"
 #include "Hazel/Editor/PhysicsSettingsWindow.h"
+#include "Hazel/Editor/AssetMemoryWindow.h"
 #include "Hazel/Editor/AssetEditorPanel.h"
 
 #include <filesystem>
@@ -280,7 +281,10 @@ namespace Hazel {
 	{
 		Ref<Scene> newScene = Ref<Scene>::Create("New Scene", true);
 		SceneSerializer serializer(newScene);
-		serializer.Deserialize(filepath);
+		serializer.Deserialize(filepath, [](uint32_t loadedCount, uint32_t totalCount)
+		{
+			HZ_TRACE("Loading scene assets: {0}/{1}", loadedCount, totalCount);
+		});
 		m_EditorScene = newScene;
 		m_SceneFilePath = filepath;
 
@@ -293,6 +297,14 @@ namespace Hazel {
 		m_SelectionContext.clear();
 
 		m_CurrentScene = m_EditorScene;
+
+		// Picking BVHs are built in the background, so the first click doesn't have to wait for them
+		for (auto e : m_EditorScene->GetAllEntitiesWith<MeshComponent>())
+		{
+			Entity entity = { e, m_EditorScene.Raw() };
+			if (auto& mesh = entity.GetComponent<MeshComponent>().Mesh)
+				mesh->BuildBVHsAsync();
+		}
 	}
 
 	void EditorLayer::SaveScene()
@@ -406,6 +418,7 @@ namespace Hazel {
 				ShowBoundingBoxes(m_UIShowBoundingBoxes, m_UIShowBoundingBoxesOnTop);
 			if (m_UIShowBoundingBoxes && UI::Property("On Top", m_UIShowBoundingBoxesOnTop))
 				ShowBoundingBoxes(m_UIShowBoundingBoxes, m_UIShowBoundingBoxesOnTop);
+			UI::Property("Benchmark Picking", m_BenchmarkPicking);
 
 			char* label = m_SelectionMode == SelectionMode::Entity ? "Entity" : "Mesh";
 			if (ImGui::Button(label))
@@ -447,6 +460,9 @@ namespace Hazel {
 		m_ObjectsPanel->OnImGuiRender();
 		AssetEditorPanel::OnImGuiRender();
 
+		if (m_SceneState == SceneState::Play)
+			m_RuntimeScene->GetSystemScheduler().OnImGuiRender();
+
 		// ImGui::ShowDemoWindow();
 
 		ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0, 2));
@@ -631,6 +647,18 @@ namespace Hazel {
 				if (ImGui::MenuItem("Save Scene As...", "Ctrl+Shift+S"))
 					SaveSceneAs();
 
+				ImGui::Separator();
+				if (ImGui::MenuItem("Build Asset Pak..."))
+				{
+					std::string filepath = Application::Get().SaveFile("Hazel Pak (*.hpak)\0*.hpak\0");
+					if (!filepath.empty())
+						AssetManager::BuildAssetPak(filepath);
+				}
+
+				bool preloadAssets = SceneSerializer::IsPreloadingAssets();
+				if (ImGui::MenuItem("Preload Scene Assets", nullptr, &preloadAssets))
+					SceneSerializer::SetPreloadAssets(preloadAssets);
+
 				ImGui::Separator();
 				std::string otherRenderer = RendererAPI::Current() == RendererAPIType::Vulkan ? "OpenGL" : "Vulkan";
 				std::string label = std::string("Restart with ") + otherRenderer;
@@ -657,6 +685,7 @@ namespace Hazel {
 			if (ImGui::BeginMenu("Edit"))
 			{
 				ImGui::MenuItem("Physics Settings", nullptr, &m_ShowPhysicsSettings);
+				ImGui::MenuItem("Asset Memory", nullptr, &m_ShowAssetMemory);
 
 				ImGui::EndMenu();
 			}
@@ -985,6 +1014,7 @@ namespace Hazel {
 		ScriptEngine::OnImGuiRender();
 		SceneRenderer::OnImGuiRender();
 		PhysicsSettingsWindow::OnImGuiRender(m_ShowPhysicsSettings);
+		AssetMemoryWindow::OnImGuiRender(m_ShowAssetMemory);
 
 		ImGui::End();
 
@@ -1174,48 +1204,35 @@ namespace Hazel {
 			if (mouseX > -1.0f && mouseX < 1.0f && mouseY > -1.0f && mouseY < 1.0f)
 			{
 				auto [origin, direction] = CastRay(mouseX, mouseY);
+				Ray ray = { origin, direction };
 
 				m_SelectionContext.clear();
 				m_EditorScene->SetSelectedEntity({});
-				auto meshEntities = m_EditorScene->GetAllEntitiesWith<MeshComponent>();
-				for (auto e : meshEntities)
+
+				Timer timer;
+				MeshRaycastHit hit;
+				bool picked = m_EditorScene->Raycast(ray, hit);
+				float pickTime = timer.ElapsedMillis();
+
+				if (m_BenchmarkPicking)
 				{
-					Entity entity = { e, m_EditorScene.Raw() };
-					auto mesh = entity.GetComponent<MeshComponent>().Mesh;
-					if (!mesh)
-						continue;
-
-					auto& submeshes = mesh->GetSubmeshes();
-					float lastT = std::numeric_limits<float>::max();
-					for (uint32_t i = 0; i < submeshes.size(); i++)
-					{
-						auto& submesh = submeshes[i];
-						glm::mat4 transform = m_CurrentScene->GetTransformRelativeToParent(entity);
-						Ray ray = {
-							glm::inverse(transform * submesh.Transform) * glm::vec4(origin, 1.0f),
-							glm::inverse(glm::mat3(transform) * glm::mat3(submesh.Transform)) * direction
-						};
-
-						float t;
-						bool intersects = ray.IntersectsAABB(submesh.BoundingBox, t);
-						if (intersects)
-						{
-							const auto& triangleCache = mesh->GetTriangleCache(i);
-							for (const auto& triangle : triangleCache)
-							{
-								if (ray.IntersectsTriangle(triangle.V0.Position, triangle.V1.Position, triangle.V2.Position, t))
-								{
-									HZ_WARN("INTERSECTION: {0}, t={1}", submesh.NodeName, t);
-									m_SelectionContext.push_back({ entity, &submesh, t });
-									break;
-								}
-							}
-						}
-					}
+					timer.Reset();
+					MeshRaycastHit bruteForceHit;
+					bool bruteForcePicked = m_EditorScene->RaycastBruteForce(ray, bruteForceHit);
+					float bruteForceTime = timer.ElapsedMillis();
+
+					HZ_INFO("Picking took {0}ms, {1}ms brute force ({2}x)", pickTime, bruteForceTime, bruteForceTime / glm::max(pickTime, 0.001f));
+					if (picked != bruteForcePicked || (picked && (hit.Entity != bruteForceHit.Entity || hit.SubmeshIndex != bruteForceHit.SubmeshIndex)))
+						HZ_WARN("Picking and brute force picking hit different submeshes");
 				}
-				std::sort(m_SelectionContext.begin(), m_SelectionContext.end(), [](auto& a, auto& b) { return a.Distance < b.Distance; });
-				if (m_SelectionContext.size())
+
+				if (picked)
+				{
+					Entity entity = { hit.Entity, m_EditorScene.Raw() };
+					auto& submesh = entity.GetComponent<MeshComponent>().Mesh->GetSubmeshes()[hit.SubmeshIndex];
+					m_SelectionContext.push_back({ entity, &submesh, hit.Distance });
 					OnSelected(m_SelectionContext[0]);
+				}
 
 			}
 		}
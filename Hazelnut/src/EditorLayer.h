@@ -136,11 +136,13 @@ namespace Hazel {
 
 		bool m_UIShowBoundingBoxes = false;
 		bool m_UIShowBoundingBoxesOnTop = false;
+		bool m_BenchmarkPicking = false; // Also picks by brute force and logs both timings
 
 		bool m_ViewportPanelMouseOver = false;
 		bool m_ViewportPanelFocused = false;
 
 		bool m_ShowPhysicsSettings = false;
+		bool m_ShowAssetMemory = false;
 
 		bool m_ShowWelcomePopup = true;
 		bool m_ShowAboutPopup = false;